@@ -0,0 +1,101 @@
+#include "BetweennessCentrality.h"
+#include "Trace.h"
+#include "Xoshiro256.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+BetweennessCentrality::BetweennessCentrality(const CsrGraph & g, BetweennessOptions options) {
+  TRACE_SPAN("BetweennessCentrality", "traverse");
+  const uint32_t UNVISITED = std::numeric_limits<uint32_t>::max();
+  uint32_t n = g.numVertices();
+  centrality_.assign(n, 0);
+
+  // Every vertex, or a random sample of them (a partial Fisher-Yates shuffle):
+  std::vector<uint32_t> sources(n);
+  std::iota(sources.begin(), sources.end(), 0);
+  if (options.samples > 0 && options.samples < n) {
+    Xoshiro256 rng(options.seed);
+    for (uint32_t i = 0; i < options.samples; i++) { std::swap(sources[i], sources[i + rng.below(n - i)]); }
+    sources.resize(options.samples);
+  }
+  sources_ = sources.size();
+
+  unsigned int threads = options.threads;
+  if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+  threads = std::max(1u, std::min<unsigned int>(threads, sources_));
+  std::vector<std::vector<double>> partial(threads);
+
+  auto search = [&](unsigned int t) {
+    std::vector<double> total(n, 0);
+    std::vector<uint32_t> distance(n, UNVISITED);
+    std::vector<double> routes(n, 0);      /*< Shortest routes from the source */
+    std::vector<double> dependency(n, 0);  /*< Share of the routes from the source through each vertex */
+    std::vector<uint32_t> order;           /*< Vertices in the order they are found */
+    order.reserve(n);
+
+    for (size_t i = t; i < sources.size(); i += threads) {
+      uint32_t s = sources[i];
+      distance[s] = 0;
+      routes[s] = 1;
+      order.push_back(s);
+      for (size_t head = 0; head < order.size(); head++) {
+        uint32_t v = order[head];
+        for (uint32_t w : g.neighbors(v)) {
+          if (distance[w] == UNVISITED) {
+            distance[w] = distance[v] + 1;
+            order.push_back(w);
+          }
+          if (distance[w] == distance[v] + 1) { routes[w] += routes[v]; }
+        }
+      }
+
+      // Back up the search, so each vertex comes after everything it leads to;
+      // the next vertices on its shortest routes are the neighbors one step further:
+      for (size_t j = order.size(); j-- > 0; ) {
+        uint32_t v = order[j];
+        double sum = 0;
+        for (uint32_t w : g.neighbors(v)) {
+          if (distance[w] == distance[v] + 1) { sum += (1 + dependency[w]) / routes[w]; }
+        }
+        dependency[v] = routes[v] * sum;
+        if (v != s) { total[v] += dependency[v]; }
+      }
+
+      // Only what this search reached needs to be reset:
+      for (uint32_t v : order) {
+        distance[v] = UNVISITED;
+        routes[v] = dependency[v] = 0;
+      }
+      order.clear();
+    }
+    partial[t] = std::move(total);
+  };
+
+  if (threads == 1) {
+    search(0);
+  } else {
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) { workers.push_back(std::thread(search, t)); }
+    for (std::thread & worker : workers) { worker.join(); }
+  }
+
+  double scale = (sources_ > 0) ? double(n) / sources_ : 0;
+  for (const std::vector<double> & total : partial) {
+    for (uint32_t v = 0; v < n; v++) { centrality_[v] += total[v]; }
+  }
+  for (double & c : centrality_) { c *= scale; }
+}
+
+std::vector<uint32_t> BetweennessCentrality::top(size_t count) const {
+  std::vector<uint32_t> vertices(centrality_.size());
+  std::iota(vertices.begin(), vertices.end(), 0);
+  count = std::min(count, vertices.size());
+  std::partial_sort(vertices.begin(), vertices.begin() + count, vertices.end(), [&](uint32_t a, uint32_t b) {
+    return centrality_[a] > centrality_[b] || (centrality_[a] == centrality_[b] && a < b);
+  });
+  vertices.resize(count);
+  return vertices;
+}
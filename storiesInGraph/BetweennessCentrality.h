@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CsrGraph.h"
+
+class BetweennessOptions {
+  public:
+    unsigned int threads = 0;   /*< 0: one per hardware thread */
+    uint32_t samples = 0;       /*< Sources to sample; 0 (or at least every vertex): every source, exactly */
+    uint64_t seed = 1;
+};
+
+/**
+ * The betweenness centrality of every vertex: summed over every pair of
+ * other vertices (s, t), the share of the shortest routes from s to t that
+ * pass through it.  Bottleneck passages, which many routes through a story
+ * cannot avoid, score highest.  Routes are counted by number of edges, and
+ * a graph built from undirected Edges counts each pair both ways.
+ *
+ * Brandes' algorithm: a breadth-first search from each source counts the
+ * shortest routes to every vertex, and a pass back up the search adds up
+ * how much each vertex contributes to the routes below it, for O(|V||E|) in
+ * all.  Sources are dealt out to the threads in turn, and each thread has
+ * its own search arrays and totals, which are summed in thread order at
+ * the end; a result is reproducible for a given seed and thread count.
+ *
+ * With `samples`, only that many sources (chosen at random, without
+ * repeats) are searched, and the totals are scaled up to estimate the
+ * exact centrality in a fraction of the time.
+ */
+class BetweennessCentrality {
+  public:
+    explicit BetweennessCentrality(const CsrGraph & g, BetweennessOptions options = BetweennessOptions());
+
+    double centrality(uint32_t v) const { return centrality_.at(v); }
+    const std::vector<double> & centralities() const { return centrality_; }
+
+    /**
+     * @return The number of sources searched (every vertex, if exact).
+     */
+    uint32_t sources() const { return sources_; }
+    bool exact() const { return sources_ == centrality_.size(); }
+
+    /**
+     * @return The (up to) `count` most central vertices, most central first.
+     */
+    std::vector<uint32_t> top(size_t count) const;
+
+  private:
+    std::vector<double> centrality_;
+    uint32_t sources_;
+};
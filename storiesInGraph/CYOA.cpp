@@ -1,103 +1,295 @@
 #include "CYOA.h"
 #include "Graph.h"
 #include "DirectedEdge.h"
+#include "MappedFile.h"
+#include "TextArena.h"
+#include "StoryValidation.h"
+#include "LazyContentStore.h"
+#include "CompressedContentStore.h"
+#include "Trace.h"
 #include "dirent.h"
 
 #include <iostream>
 using std::cout;
 using std::endl;
-#include <fstream>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include <algorithm>
+#include <thread>
+#include <chrono>
 
-CYOA::GraphFile CYOA::_processFile(std::string file, std::string key) {
+CYOA::GraphFile CYOA::_processFile(const std::string & file, const std::string & key, uint32_t fileIndex, ParseContext & ctx) {
+  TRACE_SPAN("CYOA::_processFile", "parse");
   CYOA::GraphFile gf;
   gf.key = key;
+  gf.ref = TextRef{ fileIndex, 0, 0 };
 
-  std::string edgeName = "";
-  std::string content = "";
+  // Map the whole file and walk it as `string_view` slices; text is only
+  // copied once, into the arena, when a passage or choice is complete.
+  MappedFile input;
+  if (!input.open(file)) {
+    ctx.validation.add(StoryValidation::ERR, StoryValidation::UNREADABLE_FILE, key, 0, "Unable to open file.");
+    return gf;
+  }
+
+  const std::string_view data = input.data();
+  std::string_view edgeName;
+  size_t textStart = 0;
+  ctx.lines.clear();
+
+  // Stores the lines collected so far (ending at byte `textEnd` of the
+  // file) as the passage or the current edge:
+  auto flush = [&](size_t textEnd) {
+    TextRef ref{ fileIndex, (uint32_t) textStart, (uint32_t) (textEnd - textStart) };
+    std::string_view content;
+    if (mode_ != LAZY) { content = ctx.arena.join(ctx.lines, ' '); }
+
+    if (edgeName.empty()) {
+      gf.content = content;
+      gf.ref = ref;
+    } else {
+      // A repeated choice replaces the earlier one:
+      bool found = false;
+      for (auto & edge : gf.edges) {
+        if (edge.key == edgeName) { edge.content = content; edge.ref = ref; found = true; }
+      }
+      if (!found) { gf.edges.push_back({ ctx.arena.append(edgeName), content, ref }); }
+    }
+    ctx.lines.clear();
+  };
+
+  std::string_view rest = data;
+  unsigned int lineNumber = 0;
+  while (!rest.empty()) {
+    size_t lineStart = rest.data() - data.data();
+    size_t eol = rest.find('\n');
+    std::string_view raw = rest.substr(0, eol);
+    std::string_view line = trim(raw);
+    rest = (eol == std::string_view::npos) ? std::string_view() : rest.substr(eol + 1);
+    lineNumber++;
+
+    // story_validator.py only accepts "# " at the start of a line as a choice:
+    if (raw.substr(0, 2) == "# ") {
+      gf.choices.push_back(ctx.arena.append(rtrim(raw.substr(2))));
+    } else if (raw.size() > 0 && raw[0] == '#') {
+      ctx.validation.add(StoryValidation::WARN, StoryValidation::MALFORMED_CHOICE, key, lineNumber,
+        "A line begins with a # that is not followed by a space. This is probably an error.");
+    }
 
-  // Read the file contents:
-  // @see https://stackoverflow.com/questions/7868936/read-file-line-by-line-using-ifstream-in-c
-  std::ifstream input(file);
-  for (std::string line; getline( input, line ); ) {
     // Skip empty lines:
-    trim(line);
     if (line.length() == 0) { continue; }
 
     // Found an edge marker:
     if (line.at(0) == '#') {
-      // New edge found:
-      if (edgeName == "") { gf.content = string(content); }
-      else                { gf.edges[edgeName] = string(content); }
-
-      // Update data:
-      edgeName = line.substr(1);
-      trim(edgeName);
-      content = "";
+      flush(lineStart);
+      edgeName = trim(line.substr(1));
+      textStart = data.size() - rest.size();
     } else {
       // Otherwise, add to content:
-      content += " " + line;
+      ctx.lines.push_back(line);
     }
   }
 
   // Last edge:
-  if (edgeName == "") { gf.content = string(content); }
-  else                { gf.edges[edgeName] = string(content); }
+  flush(data.size());
+
+  // Like story_validator.py, only a file with no lines or whose first line
+  // is a choice is empty (a blank first line counts as a narrative):
+  if (data.empty() || data.substr(0, 2) == "# ") {
+    ctx.validation.add(StoryValidation::ERR, StoryValidation::EMPTY_FILE, key, 0, "Empty file: no narrative before the first choice.");
+  }
 
   return gf;
 }
 
 
+void CYOA::_validate(const std::vector<GraphFile> & gfs, const std::unordered_set<std::string_view> & keys) {
+  std::unordered_set<std::string_view> hasIncoming;
+  hasIncoming.reserve(gfs.size());
+
+  bool hasEnding = false;
+  bool hasThreeChoices = false;
+  size_t numEdges = 0;
+
+  for (const GraphFile & gf : gfs) {
+    if (gf.key.compare(0, 4, "waf-") == 0) {
+      validation_.add(StoryValidation::ERR, StoryValidation::TEMPLATE_FILE, gf.key, 0,
+        "You must delete waf-*.md files - write your own story! :)");
+    }
+
+    for (std::string_view choice : gf.choices) {
+      if (keys.find(choice) == keys.end()) {
+        validation_.add(StoryValidation::ERR, StoryValidation::DANGLING_CHOICE, gf.key, 0,
+          "Choice refers to non-existent file " + std::string(choice) + ".md");
+      } else {
+        hasIncoming.insert(choice);
+      }
+    }
+
+    if (gf.choices.size() == 0) { hasEnding = true; }
+    else if (gf.choices.size() >= 3) { hasThreeChoices = true; }
+
+    if (gf.choices.size() > 10) {
+      validation_.add(StoryValidation::ERR, StoryValidation::TOO_MANY_CHOICES, gf.key, 0,
+        "More than 10 choices (outgoing edges)! Has: " + std::to_string(gf.choices.size()) + " choices");
+    }
+    numEdges += gf.choices.size();
+  }
+
+  if (!hasEnding) {
+    validation_.add(StoryValidation::ERR, StoryValidation::NO_ENDING, "", 0,
+      "At least one narrative must be the ending of the story (an ending vertex will have no outbound edges).");
+  }
+
+  if (!hasThreeChoices) {
+    validation_.add(StoryValidation::ERR, StoryValidation::NO_THREE_CHOICES, "", 0,
+      "At least one narrative must have at least 3 choices.");
+  }
+
+  size_t numStartNodes = gfs.size() - hasIncoming.size();
+  if (numStartNodes != 1) {
+    validation_.add(StoryValidation::ERR, StoryValidation::START_COUNT, "", 0,
+      "Exactly one narrative must be the beginning of the story (one vertex must have no incoming edges). " +
+      std::to_string(numStartNodes) + " beginning nodes found.");
+  }
+
+  if (gfs.size() < 8) {
+    validation_.add(StoryValidation::ERR, StoryValidation::TOO_FEW_NARRATIVES, "", 0,
+      "Your interactive story must have at least 8 narratives. Actual number of narratives: " + std::to_string(gfs.size()));
+  }
+
+  if (numEdges < 13) {
+    validation_.add(StoryValidation::ERR, StoryValidation::TOO_FEW_CHOICES, "", 0,
+      "Your interactive story must have at least 13 choices. Actual number of choices: " + std::to_string(numEdges));
+  }
+}
+
+
 Graph<Vertex, DirectedEdge> CYOA::load(std::string path) {
+  TRACE_SPAN("CYOA::load", "parse");
   //
   // Part 1: Read the graph files
   //
-  std::vector<GraphFile> gfs;
+  std::vector<std::string> fileNames;
+  validation_.clear();
+  auto phaseStart = std::chrono::steady_clock::now();
+  auto endPhase = [&phaseStart](double & ms) {
+    auto now = std::chrono::steady_clock::now();
+    ms = std::chrono::duration<double, std::milli>(now - phaseStart).count();
+    phaseStart = now;
+  };
 
   // Grab every file in the `path`:
   // @see https://stackoverflow.com/questions/612097/how-can-i-get-the-list-of-files-in-a-directory-using-c-or-c
-  DIR *dir;
-  struct dirent *ent;
-  if ((dir = opendir(path.c_str())) != NULL) {
-    /* print all the files and directories within directory */
-    while ((ent = readdir(dir)) != NULL) {
-      std::string fileName(ent->d_name);
-      if (fileName.length() > 3 && fileName.substr(fileName.length() - 3, 3) == ".md")
-      {
-          std::string fullPath = path + fileName;
-          GraphFile gf = _processFile(fullPath, fileName.substr(0, fileName.length() - 3));
-          gfs.push_back(gf);
+  {
+    TRACE_SPAN("CYOA::load scan", "io");
+    DIR *dir;
+    struct dirent *ent;
+    if ((dir = opendir(path.c_str())) != NULL) {
+      /* print all the files and directories within directory */
+      while ((ent = readdir(dir)) != NULL) {
+        std::string fileName(ent->d_name);
+        if (fileName.length() > 3 && fileName.substr(fileName.length() - 3, 3) == ".md")
+        {
+            fileNames.push_back(fileName);
+        }
       }
+      closedir(dir);
+    } else {
+      /* could not open directory */
+      std::cerr << "Unable to open " << path << std::endl;
+    }
+  }
+  endPhase(timings_.scan);
+
+  // Parse the files, splitting them into one contiguous range per thread:
+  std::vector<GraphFile> gfs(fileNames.size());
+  unsigned int numThreads = std::min<size_t>(threads_, std::max<size_t>(fileNames.size(), 1));
+  std::vector<ParseContext> contexts(numThreads);
+
+  auto parseRange = [&](unsigned int t) {
+    size_t begin = fileNames.size() * t / numThreads;
+    size_t end = fileNames.size() * (t + 1) / numThreads;
+    for (size_t i = begin; i < end; i++) {
+      const std::string & fileName = fileNames[i];
+      gfs[i] = _processFile(path + fileName, fileName.substr(0, fileName.length() - 3), i, contexts[t]);
     }
-    closedir(dir);
-  } else {
-    /* could not open directory */
-    std::cerr << "Unable to open " << path << std::endl;
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 1; t < numThreads; t++) { workers.push_back(std::thread(parseRange, t)); }
+  parseRange(0);
+  for (std::thread & worker : workers) { worker.join(); }
+  endPhase(timings_.parse);
+
+  // Per-file diagnostics, in file order, followed by whole-story checks:
+  std::unordered_set<std::string_view> keys;
+  keys.reserve(gfs.size());
+  for (const GraphFile & gf : gfs) { keys.insert(gf.key); }
+  {
+    TRACE_SPAN("CYOA::load validate", "parse");
+    for (const ParseContext & ctx : contexts) { validation_.merge(ctx.validation); }
+    _validate(gfs, keys);
   }
+  endPhase(timings_.validate);
 
 
   //
   // Part 2: Construct the graph
   //
   Graph<Vertex, DirectedEdge> g;
+  content_.reset();
+  if (mode_ == LAZY) { content_.reset(new LazyContentStore(path)); }
+  if (mode_ == COMPRESSED) {
+    TRACE_SPAN("CYOA::load compress", "graph");
+    // Append each passage next to its choices so that reading a page
+    // usually inflates a single block:
+    std::unique_ptr<CompressedContentStore> store(new CompressedContentStore());
+    for (GraphFile & gf : gfs) {
+      gf.ref = store->append(gf.content);
+      for (auto & it : gf.edges) { it.ref = store->append(it.content); }
+    }
+    store->seal();
+    content_.reset(store.release());
+  }
+  endPhase(timings_.compress);
 
   // Add every vertex:
-  for (const GraphFile & gf : gfs) {
-    Vertex & v = g.insertVertex(gf.key);
-    v["content"] = gf.content;
+  {
+    TRACE_SPAN("CYOA::load insertVertex", "graph");
+    for (const GraphFile & gf : gfs) {
+      Vertex & v = g.insertVertex(gf.key);
+      if (content_) { content_->addPassage(gf.key, gf.ref); }
+      else          { v["content"] = std::string(gf.content); }
+    }
   }
 
-  // Add edges:
-  for (const GraphFile & gf : gfs) {
+  // Add edges (choices to missing files were reported by _validate):
+  TRACE_SPAN("CYOA::load insertEdge", "graph");
+  for (size_t i = 0; i < gfs.size(); i++) {
+    const GraphFile & gf = gfs[i];
     for (auto & it : gf.edges) {
-      std::string edgeKey = it.first;
-      std::string edgeContent = it.second;
+      if (keys.find(it.key) == keys.end()) { continue; }
 
+      std::string edgeKey(it.key);
       Edge & e = g.insertEdge( gf.key, edgeKey );
-      e["content"] = edgeContent;
+      if (content_) { content_->addChoice(i, edgeKey, it.ref); }
+      else          { e["content"] = std::string(it.content); }
     }
   }
 
+  endPhase(timings_.build);
   return g;
 };
+
+
+std::string CYOA::content(const Vertex & v) const {
+  if (content_) { return content_->vertexContent(v.key()); }
+  return v.property("content");
+}
+
+std::string CYOA::content(const Edge & e) const {
+  if (content_) { return content_->edgeContent(e.source().key(), e.dest().key()); }
+  return e.property("content");
+}
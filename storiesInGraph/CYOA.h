@@ -2,45 +2,131 @@
 
 #include "Graph.h"
 #include "DirectedEdge.h"
+#include "TextArena.h"
+#include "StoryValidation.h"
+#include "ContentStore.h"
 #include "dirent.h"
 
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+#include <utility>
+#include <memory>
+
 class CYOA {
 public:
+  /**
+   * Where `load` keeps passage and choice text.
+   */
+  enum ContentMode {
+    EAGER,  /*< In the `content` property of every Vertex and Edge */
+    LAZY,       /*< Left in the story files; read through `content()` on first use */
+    COMPRESSED  /*< In deflate-compressed blocks in memory; read through `content()` */
+  };
+
+  /**
+   * @param threads Number of threads used to parse and validate story files.
+   */
+  CYOA(unsigned int threads = 1) : threads_(threads > 0 ? threads : 1), mode_(EAGER) { }
+
   Graph<Vertex, DirectedEdge> load(std::string path);
 
+  /**
+   * Sets how the next `load` stores text.
+   */
+  void setContentMode(ContentMode mode) { mode_ = mode; }
+
+  /**
+   * Returns the passage text of `v` (or the choice text of `e`) from the
+   * most recent `load`, whichever ContentMode was used.  Outside of EAGER
+   * mode this CYOA must outlive the request, and in LAZY mode the story
+   * files must still exist unchanged (a text that can no longer be read
+   * throws std::runtime_error).  Content may be read from several threads
+   * at once.
+   */
+  std::string content(const Vertex & v) const;
+  std::string content(const Edge & e) const;
+
+  /**
+   * Diagnostics from the most recent `load`.  Choices that refer to a
+   * missing file are reported here and left out of the loaded graph.
+   */
+  const StoryValidation & validation() const { return validation_; }
+
+  /**
+   * Wall-clock time spent in each phase of the most recent `load`, in milliseconds.
+   */
+  class LoadTimings {
+    public:
+      double scan = 0;      /*< Listing the story directory */
+      double parse = 0;     /*< Reading and parsing every file */
+      double validate = 0;  /*< Whole-story checks */
+      double compress = 0;  /*< Compressing text into blocks (COMPRESSED mode only) */
+      double build = 0;     /*< Inserting vertices and edges (and filling the ContentStore) */
+  };
+  const LoadTimings & timings() const { return timings_; }
+
 private:
   class GraphFile {
     public:
+      class Choice {
+        public:
+          std::string_view key;
+          std::string_view content;
+          TextRef ref;
+      };
+
       std::string key;
-      std::string content;
-      std::unordered_map<std::string, std::string> edges;
+      // Views into the TextArena of the ParseContext that read the file
+      // (`content` is not filled in LAZY mode):
+      std::string_view content;
+      TextRef ref;
+      std::vector<Choice> edges;
+      // Choice targets as story_validator.py reads them, one per "# " line
+      // (repeats included), for the validation rules:
+      std::vector<std::string_view> choices;
   };
 
-  GraphFile _processFile(std::string file, std::string key);
+  // State owned by one parsing thread:
+  class ParseContext {
+    public:
+      TextArena arena;
+      // Lines of the passage currently being parsed, reused across files:
+      std::vector<std::string_view> lines;
+      StoryValidation validation;
+  };
+
+  GraphFile _processFile(const std::string & file, const std::string & key, uint32_t fileIndex, ParseContext & ctx);
+  void _validate(const std::vector<GraphFile> & gfs, const std::unordered_set<std::string_view> & keys);
+
+  unsigned int threads_;
+  ContentMode mode_;
+  StoryValidation validation_;
+  LoadTimings timings_;
+  std::unique_ptr<ContentStore> content_;
 
 
   // String ops:
   // @see https://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring
-  // trim from start (in place)
-  static inline void ltrim(std::string &s) {
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](int ch) {
-      return !std::isspace(ch);
-    }));
+  // trim from start
+  static inline std::string_view ltrim(std::string_view s) {
+    size_t i = 0;
+    while (i < s.size() && std::isspace(static_cast<unsigned char>(s[i]))) { i++; }
+    return s.substr(i);
   }
 
-  // trim from end (in place)
-  static inline void rtrim(std::string &s) {
-    s.erase(std::find_if(s.rbegin(), s.rend(), [](int ch) {
-      return !std::isspace(ch);
-    }).base(), s.end());
+  // trim from end
+  static inline std::string_view rtrim(std::string_view s) {
+    size_t n = s.size();
+    while (n > 0 && std::isspace(static_cast<unsigned char>(s[n - 1]))) { n--; }
+    return s.substr(0, n);
   }
 
-  // trim from both ends (in place)
-  static inline void trim(std::string &s) {
-    ltrim(s);
-    rtrim(s);
+  // trim from both ends
+  static inline std::string_view trim(std::string_view s) {
+    return rtrim(ltrim(s));
   }
 
 
 
-};
\ No newline at end of file
+};
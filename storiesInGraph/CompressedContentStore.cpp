@@ -0,0 +1,67 @@
+#include "CompressedContentStore.h"
+#include "Trace.h"
+#include "cs225/lodepng/lodepng.h"
+
+#include <stdexcept>
+#include <string>
+
+TextRef CompressedContentStore::append(std::string_view text) {
+  if (!open_.empty() && open_.size() + text.size() > blockSize_) { seal(); }
+
+  TextRef ref{ (uint32_t) blocks_.size(), (uint32_t) open_.size(), (uint32_t) text.size() };
+  open_.append(text.data(), text.size());
+  rawBytes_ += text.size();
+  return ref;
+}
+
+void CompressedContentStore::seal() {
+  if (open_.empty()) { return; }
+
+  // lodepng's LZ77 search is slow with a large window or lazy matching:
+  // with a 32 KB window a 10k-passage story took 1.2 s to compress, against
+  // 0.27 s with these settings, for a ratio of 0.31 instead of 0.28.
+  LodePNGCompressSettings settings;
+  lodepng_compress_settings_init(&settings);
+  settings.windowsize = 2048;
+  settings.nicematch = 32;
+  settings.lazymatching = 0;
+
+  std::vector<unsigned char> compressed;
+  unsigned error = lodepng::compress(compressed, reinterpret_cast<const unsigned char *>(open_.data()), open_.size(), settings);
+  if (error) {
+    throw std::runtime_error("CompressedContentStore: compression error " + std::to_string(error) + ": " + lodepng_error_text(error));
+  }
+
+  compressed.shrink_to_fit();
+  compressedBytes_ += compressed.size();
+  blocks_.push_back(std::move(compressed));
+  open_.clear();
+}
+
+const std::string & CompressedContentStore::_block(uint32_t block) {
+  if (block == blocks_.size()) { return open_; }
+
+  std::string * cached = cache_.get(block);
+  if (cached != nullptr) { return *cached; }
+
+  TRACE_SPAN("CompressedContentStore::_block", "io");
+  std::vector<unsigned char> inflated;
+  unsigned error = lodepng::decompress(inflated, blocks_[block].data(), blocks_[block].size());
+  if (error) {
+    throw std::runtime_error("CompressedContentStore: block " + std::to_string(block) + " is corrupt: " + lodepng_error_text(error));
+  }
+  return cache_.put(block, std::string(inflated.begin(), inflated.end()));
+}
+
+std::string CompressedContentStore::_read(uint32_t textId, const TextRef & ref) {
+  if (ref.file > blocks_.size()) { return ""; }
+
+  // The block stays in the cache while the lock is held:
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::string & block = _block(ref.file);
+  if (ref.offset + ref.length > block.size()) {
+    throw std::runtime_error("CompressedContentStore: block " + std::to_string(ref.file) + " inflated to " +
+                             std::to_string(block.size()) + " bytes, too short for its texts");
+  }
+  return block.substr(ref.offset, ref.length);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ContentStore.h"
+#include "LRUCache.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+
+/**
+ * A ContentStore that keeps story text in memory, deflate-compressed.
+ *
+ * Texts are appended into blocks of about `blockSize` bytes; a full block
+ * is compressed with lodepng's zlib implementation.  Each TextRef is a
+ * (block, offset, length) triple into the uncompressed block, and reading
+ * a text inflates its whole block into a small LRU cache of blocks, so
+ * neighbouring passages (a passage and its choices are appended together)
+ * usually cost a single inflate.  Reading is thread-safe (inflating one
+ * block at a time); compression errors and blocks that fail to inflate
+ * throw std::runtime_error.
+ */
+class CompressedContentStore : public ContentStore {
+  public:
+    /**
+     * @param blockSize Uncompressed size at which a block is sealed.
+     * @param cacheBlocks The number of inflated blocks kept in memory.
+     */
+    CompressedContentStore(size_t blockSize = 64 * 1024, size_t cacheBlocks = 4) :
+      blockSize_(blockSize), rawBytes_(0), compressedBytes_(0), cache_(cacheBlocks) { }
+
+    /**
+     * Appends `text` to the open block, sealing it first if `text` would
+     * not fit.
+     * @return The location of `text`, for `addPassage` or `addChoice`.
+     */
+    TextRef append(std::string_view text);
+
+    /**
+     * Compresses the open block.  Call once every text has been appended.
+     */
+    void seal();
+
+    /**
+     * @return The total size of all appended text.
+     */
+    size_t rawBytes() const { return rawBytes_; }
+
+    /**
+     * @return The total size of all compressed blocks.
+     */
+    size_t compressedBytes() const { return compressedBytes_; }
+
+  protected:
+    std::string _read(uint32_t textId, const TextRef & ref);
+
+  private:
+    size_t blockSize_;
+    size_t rawBytes_;
+    size_t compressedBytes_;
+    std::vector<std::vector<unsigned char>> blocks_;
+    std::string open_;
+    std::mutex mutex_;   /*< Guards `cache_` */
+    LRUCache<uint32_t, std::string> cache_;
+
+    // Called with `mutex_` held:
+    const std::string & _block(uint32_t block);
+};
@@ -0,0 +1,68 @@
+#include "ContentStore.h"
+
+#include <cctype>
+
+uint32_t ContentStore::addPassage(const std::string & key, TextRef ref) {
+  auto result = ids_.insert({ key, (uint32_t) passages_.size() });
+  uint32_t id = result.first->second;
+  if (!result.second) {
+    texts_[passages_[id].text] = ref;
+    return id;
+  }
+
+  passages_.push_back(Passage{ &result.first->first, (uint32_t) texts_.size(), (uint32_t) choices_.size(), 0 });
+  texts_.push_back(ref);
+  return id;
+}
+
+void ContentStore::addChoice(uint32_t source, const std::string & dest, TextRef ref) {
+  auto it = ids_.find(dest);
+  if (it == ids_.end() || source >= passages_.size()) { return; }
+
+  Passage & p = passages_[source];
+  if (p.numChoices == 0) { p.firstChoice = choices_.size(); }
+  choices_.push_back(Choice{ it->second, (uint32_t) texts_.size() });
+  texts_.push_back(ref);
+  p.numChoices++;
+}
+
+std::string ContentStore::vertexContent(const std::string & key) {
+  auto it = ids_.find(key);
+  if (it == ids_.end()) { return ""; }
+
+  uint32_t text = passages_[it->second].text;
+  return _read(text, texts_[text]);
+}
+
+std::string ContentStore::edgeContent(const std::string & source, const std::string & dest) {
+  auto src = ids_.find(source);
+  auto dst = ids_.find(dest);
+  if (src == ids_.end() || dst == ids_.end()) { return ""; }
+
+  const Passage & p = passages_[src->second];
+  for (uint32_t i = p.firstChoice; i < p.firstChoice + p.numChoices; i++) {
+    if (choices_[i].dest == dst->second) {
+      uint32_t text = choices_[i].text;
+      return _read(text, texts_[text]);
+    }
+  }
+  return "";
+}
+
+std::string ContentStore::normalize(std::string_view raw) {
+  std::string out;
+  while (!raw.empty()) {
+    size_t eol = raw.find('\n');
+    std::string_view line = raw.substr(0, eol);
+    raw = (eol == std::string_view::npos) ? std::string_view() : raw.substr(eol + 1);
+
+    size_t begin = 0, end = line.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(line[begin]))) { begin++; }
+    while (end > begin && std::isspace(static_cast<unsigned char>(line[end - 1]))) { end--; }
+    if (begin == end) { continue; }
+
+    out += ' ';
+    out.append(line.data() + begin, end - begin);
+  }
+  return out;
+}
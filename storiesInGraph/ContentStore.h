@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+/**
+ * The location of a piece of story text inside some backing storage
+ * (a story file, a compressed block, ...).
+ */
+class TextRef {
+  public:
+    uint32_t file;     /*< Which file or block holds the text */
+    uint32_t offset;   /*< Byte offset of the text */
+    uint32_t length;   /*< Length of the text in bytes */
+};
+
+/**
+ * Passage and choice text kept outside of the Graph.
+ *
+ * The store indexes every passage (by vertex key) and every choice (by
+ * source and destination key) to a TextRef; subclasses decide where the
+ * referenced bytes live and how they are cached.
+ */
+class ContentStore {
+  public:
+    virtual ~ContentStore() { }
+
+    /**
+     * Adds the passage of vertex `key`.  All passages must be added before
+     * any choice.
+     * @return The id of the passage, used to add its choices.
+     */
+    uint32_t addPassage(const std::string & key, TextRef ref);
+
+    /**
+     * Adds the choice `source -> dest`.  Choices must be added grouped by
+     * `source`, and `dest` must already have a passage.
+     */
+    void addChoice(uint32_t source, const std::string & dest, TextRef ref);
+
+    /**
+     * @return The passage text of vertex `key`, or an empty string if unknown.
+     */
+    std::string vertexContent(const std::string & key);
+
+    /**
+     * @return The text of the choice `source -> dest`, or an empty string if unknown.
+     */
+    std::string edgeContent(const std::string & source, const std::string & dest);
+
+    /**
+     * Joins the non-empty, trimmed lines of `raw`, each preceded by a space,
+     * which is how CYOA stores passage and choice text.
+     */
+    static std::string normalize(std::string_view raw);
+
+  protected:
+    /**
+     * @return The text stored at `ref`; `textId` uniquely identifies it for caching.
+     */
+    virtual std::string _read(uint32_t textId, const TextRef & ref) = 0;
+
+    /**
+     * @return The key of the passage with id `id`.
+     */
+    const std::string & _key(uint32_t id) const { return *passages_[id].key; }
+
+  private:
+    class Passage {
+      public:
+        const std::string * key;   /*< Points at the key in `ids_` */
+        uint32_t text;
+        uint32_t firstChoice;
+        uint32_t numChoices;
+    };
+
+    class Choice {
+      public:
+        uint32_t dest;
+        uint32_t text;
+    };
+
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<Passage> passages_;
+    std::vector<Choice> choices_;
+    std::vector<TextRef> texts_;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "Graph.h"
+#include "Edge.h"
+#include "Vertex.h"
+#include "PersistentHashMap.h"
+
+/**
+ * A copy-on-write graph for "what if" edits: copies share all of their
+ * vertices, edges and adjacency lists, and an edit copies only what it
+ * touches.
+ *
+ * Vertices are kept in a PersistentHashMap of immutable vertex records.
+ * A record holds its Vertex and its adjacency list, split into chunks of
+ * up to CHUNK_SIZE shared edges.  Copying a CowGraph (or calling clone())
+ * is O(1).  Inserting or removing an edge copies the O(log |V|) map nodes
+ * above its endpoints, their records, and the one chunk that changed, so
+ * memory grows with the size of the edits rather than the size of the
+ * graph.
+ *
+ * Edges are stored the way Graph stores them: an undirected edge is in the
+ * adjacency list of both endpoints, and a directed edge is in its source's
+ * list and its destination's incoming list.  `source()` and `dest()` of an
+ * Edge are the vertices as they were when the edge was inserted.
+ *
+ * References returned by a CowGraph are valid until that CowGraph changes.
+ */
+template <class V = Vertex, class E = Edge>
+class CowGraph {
+  public:
+    static constexpr size_t CHUNK_SIZE = 32;
+
+    CowGraph() : numEdges_(0) { }
+
+    /**
+     * Copies every vertex and edge of `g`, in O(|V| log |V| + |E|).
+     */
+    explicit CowGraph(const Graph<V,E> & g);
+
+    /**
+     * @return A copy that shares everything with this graph, in O(1).
+     */
+    CowGraph clone() const { return *this; }
+
+    // Graph properties:
+    unsigned int numVertices() const { return vertices_.size(); }
+    unsigned int numEdges() const { return numEdges_; }
+    unsigned int degree(const std::string & key) const;
+
+    // Vertices (`vertex` throws std::out_of_range for a missing key, like Graph):
+    bool hasVertex(const std::string & key) const { return vertices_.find(key) != nullptr; }
+    const V & vertex(const std::string & key) const;
+    const V & insertVertex(const std::string & key);
+    void removeVertex(const std::string & key);
+    void setVertexProperty(const std::string & key, const std::string & name, const std::string & value);
+
+    // Edges:
+    const E & insertEdge(const std::string & key1, const std::string & key2);
+    void removeEdge(const std::string & key1, const std::string & key2);
+    void setEdgeProperty(const std::string & key1, const std::string & key2, const std::string & name, const std::string & value);
+
+    // Graph structure:
+    const std::list<std::reference_wrapper<const E>> incidentEdges(const std::string & key) const;
+    bool isAdjacent(const std::string & key1, const std::string & key2) const;
+
+    // Graph algorithm (the same paths as Graph::shortestPath):
+    std::list<std::string> shortestPath(const std::string & start, const std::string & end) const;
+
+  private:
+    typedef typename GraphKeyHash<V>::type KeyHash;
+
+    class EdgeRecord {
+      public:
+        EdgeRecord(std::shared_ptr<const V> s, std::shared_ptr<const V> d) :
+          source(s), dest(d), edge(*source, *dest) { }
+        EdgeRecord(const E & other, std::shared_ptr<const V> s, std::shared_ptr<const V> d) :
+          source(s), dest(d), edge(other, *source, *dest) { }
+
+        // Keep the vertices `edge` refers to alive:
+        std::shared_ptr<const V> source;
+        std::shared_ptr<const V> dest;
+        E edge;
+    };
+    typedef std::shared_ptr<const EdgeRecord> EdgePtr;
+    typedef std::vector<EdgePtr> Chunk;
+    typedef std::vector<std::shared_ptr<const Chunk>> ChunkList;
+
+    class VertexRecord {
+      public:
+        std::shared_ptr<const V> vertex;
+        ChunkList edges;     /*< Like Graph::adjList */
+        ChunkList incoming;  /*< Like Graph::incomingList */
+        unsigned int numEdges = 0;
+        unsigned int numIncoming = 0;
+    };
+    typedef std::shared_ptr<const VertexRecord> RecordPtr;
+
+    PersistentHashMap<std::string, RecordPtr, KeyHash> vertices_;
+    unsigned int numEdges_;
+
+    const VertexRecord & _record(const std::string & key) const;
+    template <class F> void _update(const std::string & key, F change);
+    void _insertEdge(const EdgePtr & e);
+    const EdgePtr * _findEdge(const std::string & key1, const std::string & key2) const;
+
+    static void _append(ChunkList & list, const EdgePtr & e);
+    static bool _replace(ChunkList & list, const EdgeRecord * old, const EdgePtr & updated);
+};
+
+#include "CowGraph.hpp"
@@ -0,0 +1,282 @@
+#include "CowGraph.h"
+
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+
+template <class V, class E>
+CowGraph<V,E>::CowGraph(const Graph<V,E> & g) : numEdges_(0)
+{
+  for (const auto & pair : g.vertexMap) {
+    std::shared_ptr<VertexRecord> record = std::make_shared<VertexRecord>();
+    record->vertex = std::make_shared<const V>(pair.second.get());
+    vertices_.set(pair.first, record);
+  }
+
+  // Oldest edges first, so each adjacency list keeps the order of `g`
+  // (reversed: CowGraph appends where Graph prepends):
+  for (auto it = g.edgeList.rbegin(); it != g.edgeList.rend(); ++it) {
+    const E & e = *it;
+    _insertEdge(std::make_shared<EdgeRecord>(e, _record(e.source().key()).vertex, _record(e.dest().key()).vertex));
+  }
+}
+
+template <class V, class E>
+unsigned int CowGraph<V,E>::degree(const std::string & key) const
+{
+  const VertexRecord & record = _record(key);
+  return record.numEdges + record.numIncoming;
+}
+
+template <class V, class E>
+const V & CowGraph<V,E>::vertex(const std::string & key) const
+{
+  return *_record(key).vertex;
+}
+
+/**
+* Inserts a Vertex, or returns the existing Vertex with the same key
+*/
+template <class V, class E>
+const V & CowGraph<V,E>::insertVertex(const std::string & key)
+{
+  const RecordPtr * existing = vertices_.find(key);
+  if (existing != nullptr) { return *(*existing)->vertex; }
+
+  std::shared_ptr<VertexRecord> record = std::make_shared<VertexRecord>();
+  record->vertex = std::make_shared<const V>(key);
+  vertices_.set(key, record);
+  return *record->vertex;
+}
+
+template <class V, class E>
+void CowGraph<V,E>::removeVertex(const std::string & key)
+{
+  // removeEdge replaces the record, so look it up again after every edge:
+  while (_record(key).numEdges > 0) {
+    for (const std::shared_ptr<const Chunk> & chunk : _record(key).edges) {
+      if (chunk->empty()) { continue; }
+      const E & e = chunk->front()->edge;
+      removeEdge(e.source().key(), e.dest().key());
+      break;
+    }
+  }
+  while (_record(key).numIncoming > 0) {
+    for (const std::shared_ptr<const Chunk> & chunk : _record(key).incoming) {
+      if (chunk->empty()) { continue; }
+      const E & e = chunk->front()->edge;
+      removeEdge(e.source().key(), e.dest().key());
+      break;
+    }
+  }
+  vertices_.erase(key);
+}
+
+/**
+* Sets a property of a Vertex.  Edges inserted earlier keep referring to
+* the Vertex as it was.
+*/
+template <class V, class E>
+void CowGraph<V,E>::setVertexProperty(const std::string & key, const std::string & name, const std::string & value)
+{
+  _update(key, [&](VertexRecord & record) {
+    std::shared_ptr<V> v = std::make_shared<V>(*record.vertex);
+    (*v)[name] = value;
+    record.vertex = v;
+  });
+}
+
+template <class V, class E>
+const E & CowGraph<V,E>::insertEdge(const std::string & key1, const std::string & key2)
+{
+  EdgePtr e = std::make_shared<EdgeRecord>(_record(key1).vertex, _record(key2).vertex);
+  _insertEdge(e);
+  return e->edge;
+}
+
+template <class V, class E>
+void CowGraph<V,E>::removeEdge(const std::string & key1, const std::string & key2)
+{
+  const EdgePtr * found = _findEdge(key1, key2);
+  if (found == nullptr) { return; }
+
+  // Hold on to the edge while both records let go of it:
+  EdgePtr e = *found;
+  _update(key1, [&](VertexRecord & record) {
+    if (_replace(record.edges, e.get(), EdgePtr())) { record.numEdges--; }
+  });
+  _update(key2, [&](VertexRecord & record) {
+    if (!e->edge.directed()) {
+      if (_replace(record.edges, e.get(), EdgePtr())) { record.numEdges--; }
+    } else {
+      if (_replace(record.incoming, e.get(), EdgePtr())) { record.numIncoming--; }
+    }
+  });
+  numEdges_--;
+}
+
+/**
+* Sets a property of the Edge from `key1` to `key2`
+* @throws std::out_of_range if there is no such Edge
+*/
+template <class V, class E>
+void CowGraph<V,E>::setEdgeProperty(const std::string & key1, const std::string & key2, const std::string & name, const std::string & value)
+{
+  const EdgePtr * found = _findEdge(key1, key2);
+  if (found == nullptr) { throw std::out_of_range("No edge from " + key1 + " to " + key2); }
+
+  EdgePtr old = *found;
+  std::shared_ptr<EdgeRecord> updated = std::make_shared<EdgeRecord>(old->edge, old->source, old->dest);
+  updated->edge[name] = value;
+
+  _update(key1, [&](VertexRecord & record) { _replace(record.edges, old.get(), updated); });
+  _update(key2, [&](VertexRecord & record) {
+    _replace(old->edge.directed() ? record.incoming : record.edges, old.get(), updated);
+  });
+}
+
+template <class V, class E>
+const std::list<std::reference_wrapper<const E>> CowGraph<V,E>::incidentEdges(const std::string & key) const
+{
+  const VertexRecord & record = _record(key);
+  std::list<std::reference_wrapper<const E>> edges;
+  for (const ChunkList * list : { &record.edges, &record.incoming }) {
+    for (const std::shared_ptr<const Chunk> & chunk : *list) {
+      for (const EdgePtr & e : *chunk) { edges.push_back(e->edge); }
+    }
+  }
+  return edges;
+}
+
+template <class V, class E>
+bool CowGraph<V,E>::isAdjacent(const std::string & key1, const std::string & key2) const
+{
+  for (const std::shared_ptr<const Chunk> & chunk : _record(key1).edges) {
+    for (const EdgePtr & e : *chunk) {
+      if (e->edge.dest().key() == key2 || e->edge.source().key() == key2) { return true; }
+    }
+  }
+  return false;
+}
+
+/**
+* Returns the keys of a shortest path from `start` to `end`, following
+* edges in either direction (see Graph::shortestPath).
+*/
+template <class V, class E>
+std::list<std::string> CowGraph<V,E>::shortestPath(const std::string & start, const std::string & end) const
+{
+  std::unordered_map<std::string, std::string, KeyHash> predecessor;
+  std::queue<std::string> q;
+  predecessor[start] = "";
+  q.push(start);
+
+  while (!q.empty()) {
+    std::string cur = q.front();
+    q.pop();
+    for (const E & e : incidentEdges(cur)) {
+      std::string next = (e.dest().key() == cur) ? e.source().key() : e.dest().key();
+      if (predecessor.find(next) == predecessor.end()) {
+        predecessor[next] = cur;
+        q.push(next);
+      }
+    }
+  }
+
+  std::list<std::string> path;
+  for (std::string cur = end; cur != ""; cur = predecessor[cur]) { path.push_front(cur); }
+  return path;
+}
+
+/**
+* @throws std::out_of_range if there is no Vertex with the key
+*/
+template <class V, class E>
+const typename CowGraph<V,E>::VertexRecord & CowGraph<V,E>::_record(const std::string & key) const
+{
+  const RecordPtr * record = vertices_.find(key);
+  if (record == nullptr) { throw std::out_of_range("No vertex " + key); }
+  return **record;
+}
+
+/**
+* Replaces the record of `key` with a copy changed by `change(copy)`
+*/
+template <class V, class E>
+template <class F>
+void CowGraph<V,E>::_update(const std::string & key, F change)
+{
+  std::shared_ptr<VertexRecord> copy = std::make_shared<VertexRecord>(_record(key));
+  change(*copy);
+  vertices_.set(key, copy);
+}
+
+template <class V, class E>
+void CowGraph<V,E>::_insertEdge(const EdgePtr & e)
+{
+  _update(e->edge.source().key(), [&](VertexRecord & record) {
+    _append(record.edges, e);
+    record.numEdges++;
+  });
+  _update(e->edge.dest().key(), [&](VertexRecord & record) {
+    if (!e->edge.directed()) { _append(record.edges, e); record.numEdges++; }
+    else                     { _append(record.incoming, e); record.numIncoming++; }
+  });
+  numEdges_++;
+}
+
+/**
+* @return The first edge from `key1` to `key2` in the adjacency list of
+* `key1`, or nullptr
+*/
+template <class V, class E>
+const typename CowGraph<V,E>::EdgePtr * CowGraph<V,E>::_findEdge(const std::string & key1, const std::string & key2) const
+{
+  for (const std::shared_ptr<const Chunk> & chunk : _record(key1).edges) {
+    for (const EdgePtr & e : *chunk) {
+      if (e->edge.source().key() == key1 && e->edge.dest().key() == key2) { return &e; }
+    }
+  }
+  return nullptr;
+}
+
+/**
+* Appends `e` to the last chunk of `list` (copying that chunk), or to a new
+* chunk if it is full
+*/
+template <class V, class E>
+void CowGraph<V,E>::_append(ChunkList & list, const EdgePtr & e)
+{
+  if (list.empty() || list.back()->size() >= CHUNK_SIZE) {
+    list.push_back(std::make_shared<const Chunk>(1, e));
+    return;
+  }
+  std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(*list.back());
+  chunk->push_back(e);
+  list.back() = chunk;
+}
+
+/**
+* Replaces the first occurrence of `old` in `list` by `updated` (or removes
+* it, if `updated` is null), copying only the chunk that holds it
+* @return true, if `old` was found
+*/
+template <class V, class E>
+bool CowGraph<V,E>::_replace(ChunkList & list, const EdgeRecord * old, const EdgePtr & updated)
+{
+  for (size_t c = 0; c < list.size(); c++) {
+    const Chunk & chunk = *list[c];
+    for (size_t i = 0; i < chunk.size(); i++) {
+      if (chunk[i].get() != old) { continue; }
+
+      std::shared_ptr<Chunk> copy = std::make_shared<Chunk>(chunk);
+      if (updated) { (*copy)[i] = updated; }
+      else         { copy->erase(copy->begin() + i); }
+
+      if (copy->empty()) { list.erase(list.begin() + c); }
+      else               { list[c] = copy; }
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,31 @@
+#include "CsrGraph.h"
+
+CsrGraph CsrGraph::fromEdges(uint32_t numVertices, const std::vector<std::pair<uint32_t, uint32_t>> & edges) {
+  // A counting sort by source, which keeps each source's edges in order:
+  std::vector<size_t> offsets(numVertices + 1, 0);
+  for (const auto & edge : edges) { offsets[edge.first + 1]++; }
+  for (uint32_t v = 0; v < numVertices; v++) { offsets[v + 1] += offsets[v]; }
+
+  std::vector<uint32_t> targets(edges.size());
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  for (const auto & edge : edges) { targets[next[edge.first]++] = edge.second; }
+  return CsrGraph(std::move(offsets), std::move(targets));
+}
+
+CsrGraph CsrGraph::transpose() const {
+  uint32_t n = numVertices();
+  std::vector<size_t> offsets(n + 1, 0);
+  for (uint32_t w : targets_) { offsets[w + 1]++; }
+  for (uint32_t v = 0; v < n; v++) { offsets[v + 1] += offsets[v]; }
+
+  std::vector<uint32_t> targets(targets_.size());
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  for (uint32_t v = 0; v < n; v++) {
+    for (uint32_t w : neighbors(v)) { targets[next[w]++] = v; }
+  }
+
+  CsrGraph reversed(std::move(offsets), std::move(targets));
+  reversed.keys_ = keys_;
+  reversed.ids_ = ids_;
+  return reversed;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Vertex.h"
+
+// Graph.h includes the algorithms that run over a CsrGraph (see GraphOrder.h),
+// so CsrGraph is defined before it is included:
+template <class V, class E> class Graph;
+
+/**
+ * A read-only, compressed sparse row (CSR) copy of a graph's structure, for
+ * whole-graph algorithms.
+ *
+ * Vertices are the ids 0 .. numVertices()-1, and the out-neighbors of `v`
+ * are one contiguous slice of a single array, so a traversal touches no
+ * strings, hash tables or list nodes.  Built from a Graph, the neighbors of
+ * a vertex are the ones a traversal of the Graph walks to (both ends of an
+ * Edge, the dest of a DirectedEdge), in adjacency-list order, and `key` and
+ * `id` translate between ids and vertex keys.
+ */
+class CsrGraph {
+  public:
+    /**
+     * A slice of vertex ids (the out-neighbors of one vertex, say).
+     */
+    class Range {
+      public:
+        const uint32_t * begin() const { return first; }
+        const uint32_t * end() const { return last; }
+        size_t size() const { return last - first; }
+
+        const uint32_t * first;
+        const uint32_t * last;
+    };
+
+    CsrGraph() : offsets_(1, 0) { }
+
+    /**
+     * @param offsets numVertices + 1 offsets into `targets`, starting at 0.
+     * @param targets The out-neighbors of every vertex, in order.
+     */
+    CsrGraph(std::vector<size_t> offsets, std::vector<uint32_t> targets) :
+      offsets_(std::move(offsets)), targets_(std::move(targets)) { }
+
+    /**
+     * Builds a graph from directed `edges` between ids below `numVertices`,
+     * keeping the order of each vertex's edges.
+     */
+    static CsrGraph fromEdges(uint32_t numVertices, const std::vector<std::pair<uint32_t, uint32_t>> & edges);
+
+    /**
+     * Copies the structure of `g`, in O(|V| + |E|).
+     */
+    template <class V, class E>
+    static CsrGraph fromGraph(const Graph<V,E> & g);
+
+    uint32_t numVertices() const { return offsets_.size() - 1; }
+    size_t numEdges() const { return targets_.size(); }
+
+    Range neighbors(uint32_t v) const {
+      return Range{ targets_.data() + offsets_[v], targets_.data() + offsets_[v + 1] };
+    }
+    uint32_t degree(uint32_t v) const { return offsets_[v + 1] - offsets_[v]; }
+
+    /**
+     * @return The position of `v`'s first out-edge among all the edges, in
+     * `neighbors` order, for arrays that hold a value per edge.
+     */
+    size_t firstEdge(uint32_t v) const { return offsets_[v]; }
+
+    /**
+     * @return The graph with every edge reversed.
+     */
+    CsrGraph transpose() const;
+
+    /**
+     * @return The key of vertex `v` (for graphs built with `fromGraph`).
+     */
+    const std::string & key(uint32_t v) const { return keys_.at(v); }
+
+    /**
+     * @return The id of the vertex with `key`.
+     * @throws std::out_of_range if there is no such vertex.
+     */
+    uint32_t id(const std::string & key) const { return ids_.at(key); }
+
+  private:
+    std::vector<size_t> offsets_;
+    std::vector<uint32_t> targets_;
+    std::vector<std::string> keys_;
+    std::unordered_map<std::string, uint32_t> ids_;
+};
+
+#include "Graph.h"
+
+template <class V, class E>
+CsrGraph CsrGraph::fromGraph(const Graph<V,E> & g)
+{
+  CsrGraph csr;
+  std::vector<const V *> vertices;
+  std::unordered_map<const Vertex *, uint32_t> idOf;
+  vertices.reserve(g.vertexMap.size());
+  idOf.reserve(g.vertexMap.size());
+  csr.keys_.reserve(g.vertexMap.size());
+  csr.ids_.reserve(g.vertexMap.size());
+  for (const auto & pair : g.vertexMap) {
+    const V & v = pair.second;
+    idOf[&v] = vertices.size();
+    csr.ids_[pair.first] = vertices.size();
+    csr.keys_.push_back(pair.first);
+    vertices.push_back(&v);
+  }
+
+  // Edges refer to the Graph's own vertices, so they are matched by address:
+  csr.offsets_.reserve(vertices.size() + 1);
+  for (const V * v : vertices) {
+    for (const auto & it : g.adjList.at(csr.keys_[csr.offsets_.size() - 1])) {
+      const E & e = *it;
+      const Vertex & neighbor = (&e.dest() == v) ? e.source() : e.dest();
+      csr.targets_.push_back(idOf.at(&neighbor));
+    }
+    csr.offsets_.push_back(csr.targets_.size());
+  }
+  return csr;
+}
@@ -8,5 +8,8 @@ class DirectedEdge : public Edge {
     DirectedEdge(const Vertex & source, const Vertex & dest, double weight = 1) :
       Edge(source, dest, weight) { };
 
+    DirectedEdge(const DirectedEdge & other, const Vertex & source, const Vertex & dest) :
+      Edge(other, source, dest) { };
+
     bool directed() const { return true; }
 };
\ No newline at end of file
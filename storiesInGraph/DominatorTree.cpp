@@ -0,0 +1,105 @@
+#include "DominatorTree.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+DominatorTree::DominatorTree(const CsrGraph & g, uint32_t start) : start_(start) {
+  TRACE_SPAN("DominatorTree", "traverse");
+  uint32_t n = g.numVertices();
+
+  // Number the reachable vertices in postorder, with an iterative DFS:
+  class Call {
+    public:
+      uint32_t v;
+      const uint32_t * next;
+  };
+  std::vector<uint32_t> post(n, NONE);
+  std::vector<uint32_t> order;
+  std::vector<bool> visited(n, false);
+  std::vector<Call> calls{ Call{ start, g.neighbors(start).begin() } };
+  visited[start] = true;
+  while (!calls.empty()) {
+    Call & call = calls.back();
+    if (call.next != g.neighbors(call.v).end()) {
+      uint32_t w = *call.next++;
+      if (!visited[w]) {
+        visited[w] = true;
+        calls.push_back(Call{ w, g.neighbors(w).begin() });
+      }
+      continue;
+    }
+    post[call.v] = order.size();
+    order.push_back(call.v);
+    calls.pop_back();
+  }
+
+  // Cooper-Harvey-Kennedy, on postorder numbers (the start is the highest):
+  uint32_t count = order.size();
+  CsrGraph predecessors = g.transpose();
+  std::vector<uint32_t> doms(count, NONE);
+  doms[count - 1] = count - 1;
+  auto intersect = [&](uint32_t a, uint32_t b) {
+    while (a != b) {
+      while (a < b) { a = doms[a]; }
+      while (b < a) { b = doms[b]; }
+    }
+    return a;
+  };
+  for (bool changed = true; changed; ) {
+    changed = false;
+    for (uint32_t b = count - 1; b-- > 0; ) {
+      uint32_t idom = NONE;
+      for (uint32_t p : predecessors.neighbors(order[b])) {
+        uint32_t q = post[p];
+        if (q == NONE || doms[q] == NONE) { continue; }
+        idom = (idom == NONE) ? q : intersect(q, idom);
+      }
+      if (doms[b] != idom) {
+        doms[b] = idom;
+        changed = true;
+      }
+    }
+  }
+
+  idom_.assign(n, NONE);
+  for (uint32_t b = 0; b + 1 < count; b++) { idom_[order[b]] = order[doms[b]]; }
+
+  // The children of each vertex in the tree, by a counting sort on parent:
+  std::vector<uint32_t> offsets(n + 1, 0);
+  for (uint32_t v = 0; v < n; v++) {
+    if (idom_[v] != NONE) { offsets[idom_[v] + 1]++; }
+  }
+  for (uint32_t v = 0; v < n; v++) { offsets[v + 1] += offsets[v]; }
+  std::vector<uint32_t> children(offsets[n]);
+  std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+  for (uint32_t v = 0; v < n; v++) {
+    if (idom_[v] != NONE) { children[next[idom_[v]]++] = v; }
+  }
+
+  // Number the tree depth first; `next` is now each vertex's next child:
+  enter_.assign(n, NONE);
+  exit_.assign(n, NONE);
+  std::copy(offsets.begin(), offsets.end() - 1, next.begin());
+  std::vector<uint32_t> stack{ start };
+  uint32_t clock = 0;
+  enter_[start] = clock++;
+  while (!stack.empty()) {
+    uint32_t v = stack.back();
+    if (next[v] != offsets[v + 1]) {
+      uint32_t child = children[next[v]++];
+      enter_[child] = clock++;
+      stack.push_back(child);
+    } else {
+      exit_[v] = clock++;
+      stack.pop_back();
+    }
+  }
+}
+
+std::vector<uint32_t> DominatorTree::dominators(uint32_t v) const {
+  std::vector<uint32_t> chain;
+  if (!reachable(v)) { return chain; }
+  for (; v != NONE; v = idom_[v]) { chain.push_back(v); }
+  std::reverse(chain.begin(), chain.end());
+  return chain;
+}
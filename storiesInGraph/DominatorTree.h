@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "CsrGraph.h"
+
+/**
+ * The dominator tree of a directed graph from a start vertex.
+ *
+ * A vertex `a` dominates `b` if every path from the start to `b` passes
+ * through `a`; in a story, the dominators of an ending are the passages
+ * every reader who reaches it has read.  The nearest dominator of each
+ * vertex other than the start is its immediate dominator, its parent in
+ * the tree.
+ *
+ * The tree is found with the iterative algorithm of Cooper, Harvey and
+ * Kennedy ("A Simple, Fast Dominance Algorithm"), which walks the vertices
+ * in reverse postorder until no parent changes (twice, for most graphs).
+ * It is then numbered depth first, so `dominates` compares two intervals.
+ */
+class DominatorTree {
+  public:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    DominatorTree(const CsrGraph & g, uint32_t start);
+
+    uint32_t start() const { return start_; }
+
+    /**
+     * @return true, if `v` can be reached from the start.
+     */
+    bool reachable(uint32_t v) const { return enter_[v] != NONE; }
+
+    /**
+     * @return The immediate dominator of `v`, or NONE for the start and for
+     * vertices that cannot be reached.
+     */
+    uint32_t idom(uint32_t v) const { return idom_[v]; }
+
+    /**
+     * @return true, if every path from the start to `b` passes through `a`
+     * (so every vertex dominates itself).  False if either cannot be
+     * reached.
+     */
+    bool dominates(uint32_t a, uint32_t b) const {
+      return reachable(a) && reachable(b) && enter_[a] <= enter_[b] && exit_[b] <= exit_[a];
+    }
+
+    /**
+     * @return The vertices every path from the start to `v` passes through,
+     * from the start to `v` (both included), or nothing if `v` cannot be
+     * reached.
+     */
+    std::vector<uint32_t> dominators(uint32_t v) const;
+
+  private:
+    uint32_t start_;
+    std::vector<uint32_t> idom_;
+    std::vector<uint32_t> enter_;  /*< Depth-first numbering of the tree, NONE if unreachable */
+    std::vector<uint32_t> exit_;
+};
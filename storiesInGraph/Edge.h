@@ -7,6 +7,13 @@ class Edge {
   public:
     Edge(const Vertex & source, const Vertex & dest, double weight = 1) :
       source_(source), dest_(dest), weight_(weight) { }
+
+    /**
+     * Copies the weight and properties of `other` onto new endpoints
+     * (used by Graph::clone).
+     */
+    Edge(const Edge & other, const Vertex & source, const Vertex & dest) :
+      source_(source), dest_(dest), weight_(other.weight_), properties_(other.properties_) { }
     virtual ~Edge() { }
 
     /**
@@ -52,6 +59,22 @@ class Edge {
       return properties_[value];
     }
 
+    /**
+     * Returns the value of a key/value property of the Edge, or an empty
+     * string if the property is not set.
+     */
+    string property(const string & name) const {
+      auto it = properties_.find(name);
+      return (it != properties_.end()) ? it->second : "";
+    }
+
+    /**
+     * Returns every key/value property of the Edge.
+     */
+    const std::unordered_map<string, string> & properties() const {
+      return properties_;
+    }
+
     /**
      * Prints out the Edge in a human-readable format to `out`
      */
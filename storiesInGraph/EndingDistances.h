@@ -0,0 +1,88 @@
+#pragma once
+
+#include <climits>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Graph.h"
+#include "Edge.h"
+#include "Vertex.h"
+
+/**
+ * The number of choices from every vertex to its nearest ending (a vertex
+ * with no outgoing edges, as story_validator.py defines them), and the
+ * choice to make to get there.
+ *
+ * The table is built by one breadth-first search backwards from all the
+ * endings at once, in O(|V| + |E|), after which `distance` and `nextHop`
+ * are a hash lookup each.  Edits made through it are applied to the Graph
+ * and repair only the entries they change: an edit that shortens paths
+ * spreads the new distances backwards from where it was made, and one
+ * that breaks the next hop of some vertices re-derives just the vertices
+ * whose route to an ending went through it.
+ *
+ * Edges are walked the way they point (both ways for an Edge), like
+ * CsrGraph.  Edits made to the Graph directly leave the table stale until
+ * `rebuild()`.
+ */
+template <class V = Vertex, class E = Edge>
+class EndingDistances {
+  public:
+    static constexpr unsigned int UNREACHABLE = UINT_MAX;
+
+    explicit EndingDistances(Graph<V,E> & g);
+
+    const Graph<V,E> & graph() const { return g_; }
+
+    /**
+     * @return The number of edges from `key` to its nearest ending (0 at an
+     * ending), or UNREACHABLE if no ending can be reached.
+     * @throws std::out_of_range if there is no Vertex `key`.
+     */
+    unsigned int distance(const std::string & key) const { return _entry(key).distance; }
+
+    /**
+     * @return The neighbor of `key` on a shortest path to an ending, or
+     * nullptr at an ending or if no ending can be reached.
+     * @throws std::out_of_range if there is no Vertex `key`.
+     */
+    const V * nextHop(const std::string & key) const { return static_cast<const V *>(_entry(key).next); }
+
+    /**
+     * @return The keys on a shortest path from `key` to an ending (both
+     * included), or an empty list if no ending can be reached.
+     * @throws std::out_of_range if there is no Vertex `key`.
+     */
+    std::list<std::string> pathToEnding(const std::string & key) const;
+
+    // Mutations, applied to the Graph and the table (std::out_of_range for
+    // a missing vertex, like the Graph's):
+    const V & insertVertex(const std::string & key);
+    void removeVertex(const std::string & key);
+    const E & insertEdge(const std::string & key1, const std::string & key2);
+    void removeEdge(const std::string & key1, const std::string & key2);
+
+    /**
+     * Recomputes the whole table from the Graph.
+     */
+    void rebuild();
+
+  private:
+    class Entry {
+      public:
+        unsigned int distance;
+        const Vertex * next;
+    };
+
+    Graph<V,E> & g_;
+    std::unordered_map<const Vertex *, Entry> entries_;
+
+    const Entry & _entry(const std::string & key) const { return entries_.at(&g_.vertexMap.at(key).get()); }
+    std::vector<const Vertex *> _outNeighbors(const Vertex & v) const;
+    std::vector<const Vertex *> _inNeighbors(const Vertex & v) const;
+    void _repair(const std::vector<const Vertex *> & raised, const std::vector<const Vertex *> & lowered);
+};
+
+#include "EndingDistances.hpp"
@@ -0,0 +1,239 @@
+#include "EndingDistances.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_set>
+#include <utility>
+
+template <class V, class E>
+EndingDistances<V,E>::EndingDistances(Graph<V,E> & g) : g_(g)
+{
+  rebuild();
+}
+
+template <class V, class E>
+void EndingDistances<V,E>::rebuild()
+{
+  TRACE_SPAN("EndingDistances::rebuild", "traverse");
+  entries_.clear();
+  entries_.reserve(g_.vertexMap.size());
+
+  // Every ending is a source of the search, at distance 0:
+  std::vector<const Vertex *> queue;
+  for (const auto & pair : g_.vertexMap) {
+    const Vertex * v = &pair.second.get();
+    bool ending = g_.adjList.at(pair.first).empty();
+    entries_[v] = Entry{ ending ? 0 : UNREACHABLE, nullptr };
+    if (ending) { queue.push_back(v); }
+  }
+
+  for (size_t head = 0; head < queue.size(); head++) {
+    const Vertex * v = queue[head];
+    unsigned int distance = entries_.at(v).distance;
+    for (const Vertex * w : _inNeighbors(*v)) {
+      Entry & entry = entries_.at(w);
+      if (entry.distance == UNREACHABLE) {
+        entry = Entry{ distance + 1, v };
+        queue.push_back(w);
+      }
+    }
+  }
+}
+
+template <class V, class E>
+std::list<std::string> EndingDistances<V,E>::pathToEnding(const std::string & key) const
+{
+  std::list<std::string> path;
+  const Vertex * v = &g_.vertexMap.at(key).get();
+  if (entries_.at(v).distance == UNREACHABLE) { return path; }
+  for (; v != nullptr; v = entries_.at(v).next) { path.push_back(v->key()); }
+  return path;
+}
+
+/**
+* Inserts a Vertex, or returns the existing Vertex with the same key
+*/
+template <class V, class E>
+const V & EndingDistances<V,E>::insertVertex(const std::string & key)
+{
+  bool inserted = (g_.vertexMap.find(key) == g_.vertexMap.end());
+  if (inserted) { g_.insertVertex(key); }
+  const V & v = g_.vertexMap.at(key);
+  // A new vertex has no edges, so it is an ending:
+  if (inserted) { entries_[&v] = Entry{ 0, nullptr }; }
+  return v;
+}
+
+template <class V, class E>
+void EndingDistances<V,E>::removeVertex(const std::string & key)
+{
+  const Vertex * removed = &g_.vertexMap.at(key).get();
+  std::vector<const Vertex *> neighbors = _inNeighbors(*removed);
+  g_.removeVertex(key);
+  entries_.erase(removed);
+
+  // Only the vertices with an edge to the removed one can lose their route:
+  std::vector<const Vertex *> raised, lowered;
+  for (const Vertex * w : neighbors) {
+    if (w == removed) { continue; }
+    Entry & entry = entries_.at(w);
+    if (g_.adjList.at(w->key()).empty()) {
+      entry = Entry{ 0, nullptr };
+      lowered.push_back(w);
+    } else if (entry.next == removed) {
+      raised.push_back(w);
+    }
+  }
+  _repair(raised, lowered);
+}
+
+template <class V, class E>
+const E & EndingDistances<V,E>::insertEdge(const std::string & key1, const std::string & key2)
+{
+  const E & e = g_.insertEdge(key1, key2);
+  std::vector<std::pair<const Vertex *, const Vertex *>> arcs{ { &e.source(), &e.dest() } };
+  if (!e.directed()) { arcs.push_back({ &e.dest(), &e.source() }); }
+
+  // An ending with its first edge is not an ending anymore, so everything
+  // routed to it has to be re-derived:
+  std::vector<const Vertex *> raised, lowered;
+  for (const auto & arc : arcs) {
+    if (entries_.at(arc.first).distance == 0 && std::find(raised.begin(), raised.end(), arc.first) == raised.end()) {
+      raised.push_back(arc.first);
+    }
+  }
+  // Otherwise, the edge can only shorten the source's route:
+  for (const auto & arc : arcs) {
+    if (std::find(raised.begin(), raised.end(), arc.first) != raised.end() ||
+        std::find(raised.begin(), raised.end(), arc.second) != raised.end()) { continue; }
+    Entry & entry = entries_.at(arc.first);
+    unsigned int distance = entries_.at(arc.second).distance;
+    if (distance != UNREACHABLE && distance + 1 < entry.distance) {
+      entry = Entry{ distance + 1, arc.second };
+      lowered.push_back(arc.first);
+    }
+  }
+  _repair(raised, lowered);
+  return e;
+}
+
+/**
+* Removes the Edge from `key1` to `key2`, if there is one (like Graph::removeEdge)
+*/
+template <class V, class E>
+void EndingDistances<V,E>::removeEdge(const std::string & key1, const std::string & key2)
+{
+  const Vertex * source = &g_.vertexMap.at(key1).get();
+  const Vertex * dest = &g_.vertexMap.at(key2).get();
+  const E * found = nullptr;
+  for (const auto & it : g_.adjList.at(key1)) {
+    const E & e = *it;
+    if (&e.source() == source && &e.dest() == dest) { found = &e; break; }
+  }
+  if (found == nullptr) { return; }
+
+  std::vector<std::pair<const Vertex *, const Vertex *>> arcs{ { source, dest } };
+  if (!found->directed()) { arcs.push_back({ dest, source }); }
+  g_.removeEdge(key1, key2);
+
+  std::vector<const Vertex *> raised, lowered;
+  for (const auto & arc : arcs) {
+    Entry & entry = entries_.at(arc.first);
+    if (g_.adjList.at(arc.first->key()).empty()) {
+      entry = Entry{ 0, nullptr };
+      lowered.push_back(arc.first);
+    } else if (entry.next == arc.second) {
+      raised.push_back(arc.first);
+    }
+  }
+  _repair(raised, lowered);
+}
+
+/**
+* @return The vertices `v` has an edge to
+*/
+template <class V, class E>
+std::vector<const Vertex *> EndingDistances<V,E>::_outNeighbors(const Vertex & v) const
+{
+  std::vector<const Vertex *> neighbors;
+  for (const auto & it : g_.adjList.at(v.key())) {
+    const E & e = *it;
+    neighbors.push_back(&e.dest() == &v ? &e.source() : &e.dest());
+  }
+  return neighbors;
+}
+
+/**
+* @return The vertices with an edge to `v`
+*/
+template <class V, class E>
+std::vector<const Vertex *> EndingDistances<V,E>::_inNeighbors(const Vertex & v) const
+{
+  std::vector<const Vertex *> neighbors;
+  for (const auto & it : g_.adjList.at(v.key())) {
+    const E & e = *it;
+    if (!e.directed()) { neighbors.push_back(&e.dest() == &v ? &e.source() : &e.dest()); }
+  }
+  auto incoming = g_.incomingList.find(v.key());
+  if (incoming != g_.incomingList.end()) {
+    for (const auto & it : incoming->second) {
+      const E & e = *it;
+      neighbors.push_back(&e.source());
+    }
+  }
+  return neighbors;
+}
+
+/**
+* Repairs the table after an edit, given the vertices whose next hop is no
+* longer valid (`raised`), and the vertices whose distance the edit lowered
+* and that were already updated (`lowered`).
+*
+* The vertices routed through a raised vertex are reset, and take the best
+* route through a neighbor that was not; then the distances settle like
+* Dijkstra's algorithm, outward from the reset and lowered vertices.  Only
+* the vertices whose entries change (and their neighbors) are visited.
+*/
+template <class V, class E>
+void EndingDistances<V,E>::_repair(const std::vector<const Vertex *> & raised, const std::vector<const Vertex *> & lowered)
+{
+  std::unordered_set<const Vertex *> affected(raised.begin(), raised.end());
+  std::vector<const Vertex *> stack(affected.begin(), affected.end());
+  while (!stack.empty()) {
+    const Vertex * v = stack.back();
+    stack.pop_back();
+    for (const Vertex * w : _inNeighbors(*v)) {
+      if (entries_.at(w).next == v && affected.insert(w).second) { stack.push_back(w); }
+    }
+  }
+  for (const Vertex * v : affected) { entries_.at(v) = Entry{ UNREACHABLE, nullptr }; }
+
+  typedef std::pair<unsigned int, const Vertex *> Item;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  for (const Vertex * v : affected) {
+    Entry & entry = entries_.at(v);
+    std::vector<const Vertex *> neighbors = _outNeighbors(*v);
+    if (neighbors.empty()) { entry.distance = 0; }
+    for (const Vertex * w : neighbors) {
+      if (affected.count(w) != 0) { continue; }
+      unsigned int distance = entries_.at(w).distance;
+      if (distance != UNREACHABLE && distance + 1 < entry.distance) { entry = Entry{ distance + 1, w }; }
+    }
+    if (entry.distance != UNREACHABLE) { queue.push({ entry.distance, v }); }
+  }
+  for (const Vertex * v : lowered) { queue.push({ entries_.at(v).distance, v }); }
+
+  while (!queue.empty()) {
+    Item item = queue.top();
+    queue.pop();
+    if (item.first > entries_.at(item.second).distance) { continue; }
+    for (const Vertex * w : _inNeighbors(*item.second)) {
+      Entry & entry = entries_.at(w);
+      if (item.first + 1 < entry.distance) {
+        entry = Entry{ item.first + 1, item.second };
+        queue.push({ entry.distance, w });
+      }
+    }
+  }
+}
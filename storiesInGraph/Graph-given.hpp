@@ -19,6 +19,8 @@ unsigned int Graph<V,E>::numEdges() const {
 */
 template <class V, class E>
 unsigned int Graph<V,E>::degree(const std::string key) const {
+  GRAPH_STATS_OP(DEGREE);
+  GRAPH_COUNT(HASH_LOOKUPS, 1);
   return degree( vertexMap.at(key) );
 }
 
@@ -29,6 +31,8 @@ unsigned int Graph<V,E>::degree(const std::string key) const {
 */
 template <class V, class E>
 void Graph<V,E>::removeVertex(const V & v) {
+  GRAPH_STATS_OP(REMOVE_VERTEX);
+  GRAPH_COUNT(STRING_COPIES, 1);
   return removeVertex(v.key());
 }
 
@@ -41,7 +45,9 @@ void Graph<V,E>::removeVertex(const V & v) {
 */
 template <class V, class E>
 E & Graph<V,E>::insertEdge(const std::string key1, const std::string key2) {
-  return insertEdge( vertexMap.at(key1), vertexMap.at(key2) );
+  GRAPH_STATS_OP(INSERT_EDGE);
+  GRAPH_COUNT(HASH_LOOKUPS, 2);
+  return _insertEdge( vertexMap.at(key1), vertexMap.at(key2) );
 }
 
 
@@ -53,19 +59,30 @@ E & Graph<V,E>::insertEdge(const std::string key1, const std::string key2) {
 */
 template <class V, class E>
 void Graph<V,E>::removeEdge(const V & v1, const V & v2) {
+  GRAPH_STATS_OP(REMOVE_EDGE);
+  GRAPH_COUNT(STRING_COPIES, 2);
   removeEdge( v1.key(), v2.key() );
 }
 
 
 /**
-* Removes the given Edge from the Graph.
-* Hint: Use std::find
+* Removes the given Edge from the Graph: the first Edge of e's source
+* that is equal to `e` (so an undirected Edge matches either direction).
 * @param e The Edge you want to remove
 */
 template <class V, class E>
 void Graph<V,E>::removeEdge(const Edge & e) {
-  edgeListIter it = std::find(edgeList.begin(), edgeList.end(), e);
-  removeEdge(it);
+  GRAPH_STATS_OP(REMOVE_EDGE);
+  GRAPH_COUNT(HASH_LOOKUPS, 1);
+  GRAPH_COUNT(STRING_COPIES, 1);
+  for (edgeListIter it : adjList.at(e.source().key())) {
+    GRAPH_COUNT(LIST_TRAVERSALS, 1);
+    GRAPH_COUNT(EDGES_SCANNED, 1);
+    if (it->get() == e) {
+      removeEdge(it);
+      return;
+    }
+  }
 }
 
 
@@ -75,6 +92,8 @@ void Graph<V,E>::removeEdge(const Edge & e) {
 */
 template <class V, class E>
 const std::list<std::reference_wrapper<E>> Graph<V,E>::incidentEdges(const V & v) const {
+  GRAPH_STATS_OP(INCIDENT_EDGES);
+  GRAPH_COUNT(STRING_COPIES, 1);
   return incidentEdges( v.key() );
 }
 
@@ -87,5 +106,7 @@ const std::list<std::reference_wrapper<E>> Graph<V,E>::incidentEdges(const V & v
 */
 template <class V, class E>
 bool Graph<V,E>::isAdjacent(const V & v1, const V & v2) const {
+  GRAPH_STATS_OP(IS_ADJACENT);
+  GRAPH_COUNT(STRING_COPIES, 2);
   return isAdjacent( v1.key(), v2.key() );
 }
@@ -5,26 +5,55 @@
 #include <string>
 #include <algorithm>
 #include <functional>
+#include <vector>
 
 #include "Edge.h"
 #include "Vertex.h"
+#include "GraphStats.h"
+#include "Trace.h"
 
 #include <iostream>
 
+/**
+ * The hash function a Graph uses for the keys of vertices of type `V`.
+ * Specialize it to change how keys are hashed for one vertex type (the
+ * complexity tests use this to count hash calls).
+ */
+template <class V>
+struct GraphKeyHash {
+  typedef std::hash<std::string> type;
+};
+
+// Lazy traversals, see GraphTraversals.h:
+template <class V, class E> class BfsOrder;
+template <class V, class E> class DfsOrder;
+template <class V, class E> class PathsBetween;
+
 template <class V = Vertex, class E = Edge>
 class Graph {
   typedef std::reference_wrapper<E> E_byRef;
   typedef std::reference_wrapper<V> V_byRef;
   typedef typename std::list<E_byRef>::iterator edgeListIter;
+  typedef typename GraphKeyHash<V>::type KeyHash;
 
   public:
+    // Ownership: a Graph owns (and deletes) its vertices and edges.  Graphs
+    // are moved, never copied implicitly; use clone() for a deep copy.
+    Graph() { }
+    ~Graph();
+    Graph(const Graph & other) = delete;
+    Graph & operator=(const Graph & other) = delete;
+    Graph(Graph && other) noexcept;
+    Graph & operator=(Graph && other) noexcept;
+    Graph clone() const;
+
     // Graph properties:
     unsigned int numVertices() const;
     unsigned int numEdges() const;
     unsigned int degree(const std::string key) const;
     unsigned int degree(const V & v) const;
 
-    // Vertex modification:
+    // Vertex modification (inserting an existing key returns its Vertex):
     V & insertVertex(std::string key);
 
     void removeVertex(const std::string & key);
@@ -49,11 +78,27 @@ class Graph {
     // Graph algorithm:
     std::list<std::string> shortestPath(const std::string start, const std::string end);
 
+    // Lazy traversals, computed one result at a time (see GraphTraversals.h):
+    BfsOrder<V,E> bfsOrder(const std::string & start) const;
+    DfsOrder<V,E> dfsOrder(const std::string & start) const;
+    PathsBetween<V,E> pathsBetween(const std::string & start, const std::string & end, unsigned int maxLength) const;
+
+    // Ordering (see GraphOrder.h):
+    std::list<std::string> topologicalOrder() const;
+    std::list<std::string> findCycle() const;
+
+    // Alternate routes (see GraphPaths.h):
+    std::vector<std::list<std::string>> kShortestPaths(const std::string & start, const std::string & end, unsigned int k) const;
+
+    // Instrumentation (counts only when compiled with GRAPH_STATS):
+    GraphStats stats() const;
+    void resetStats();
+
     // stream<< printer
     friend std::ostream & operator<<(std::ostream & out, const Graph<V,E> & g) {
       out << "Graph(|V|=" << g.numVertices() << ", |E|=" << g.numEdges() << "):" << std::endl;
 
-      for (const std::pair<std::string, std::list<edgeListIter>> & pair : g.adjList) {
+      for (const auto & pair : g.adjList) {
         const std::string & key = pair.first;
         const std::list<edgeListIter> & edges = pair.second;
         const V & v = g.vertexMap.at(key).get();
@@ -69,11 +114,33 @@ class Graph {
     }
 
   private:
+    template <class, class> friend class CowGraph;
+    template <class, class> friend class PersistentGraph;
+    template <class, class> friend class BfsOrder;
+    template <class, class> friend class DfsOrder;
+    template <class, class> friend class PathsBetween;
+    template <class, class> friend class EndingDistances;
+    friend class CsrGraph;
+
     std::list<E_byRef> edgeList;
-    std::unordered_map<std::string, V_byRef> vertexMap;
-    std::unordered_map<std::string, std::list<edgeListIter>> adjList;
+    std::unordered_map<std::string, V_byRef, KeyHash> vertexMap;
+    std::unordered_map<std::string, std::list<edgeListIter>, KeyHash> adjList;
+    // Directed edges ending at each vertex, so incidentEdges and degree do
+    // not scan edgeList (only vertices with incoming edges have an entry):
+    std::unordered_map<std::string, std::list<edgeListIter>, KeyHash> incomingList;
+
+#ifdef GRAPH_STATS
+    mutable GraphStats stats_;
+#endif
+
+    E & _insertEdge(const V & v1, const V & v2);
+    void _swap(Graph & other) noexcept;
+    void _clear();
 };
 
 #include "Graph-given.hpp"
 #include "Graph.hpp"
 #include "Graph2.hpp"
+#include "GraphTraversals.h"
+#include "GraphOrder.h"
+#include "GraphPaths.h"
@@ -7,6 +7,90 @@
 #include <iostream>
 #include <list>
 
+template <class V, class E>
+Graph<V,E>::~Graph()
+{
+  _clear();
+}
+
+/**
+* Takes over the vertices and edges of `other` in O(1), leaving it empty.
+* Iterators into `other`'s lists stay valid and now belong to this Graph.
+*/
+template <class V, class E>
+Graph<V,E>::Graph(Graph && other) noexcept
+{
+  _swap(other);
+}
+
+template <class V, class E>
+Graph<V,E> & Graph<V,E>::operator=(Graph && other) noexcept
+{
+  if (this != &other) {
+    _clear();
+    _swap(other);
+  }
+  return *this;
+}
+
+/**
+* @return A deep copy of the Graph, with copies of every vertex and edge
+* (including their properties), in O(|V| + |E|).
+*/
+template <class V, class E>
+Graph<V,E> Graph<V,E>::clone() const
+{
+  Graph<V,E> copy;
+  copy.vertexMap.reserve(vertexMap.size());
+  copy.adjList.reserve(adjList.size());
+  for (const auto & pair : vertexMap) {
+    V & v = *(new V(pair.second.get()));
+    copy.vertexMap.insert({pair.first, v});
+    copy.adjList.insert({pair.first, std::list<edgeListIter>()});
+  }
+
+  // Every adjacency list is in edgeList order (insertEdge adds to the front
+  // of both), so inserting the edges oldest first reproduces all of them:
+  for (auto it = edgeList.rbegin(); it != edgeList.rend(); ++it) {
+    const E & e = *it;
+    const std::string sourceKey = e.source().key();
+    const std::string destKey = e.dest().key();
+
+    E & eCopy = *(new E(e, copy.vertexMap.at(sourceKey).get(), copy.vertexMap.at(destKey).get()));
+    copy.edgeList.push_front(eCopy);
+    copy.adjList.at(sourceKey).push_front(copy.edgeList.begin());
+    if (!eCopy.directed()) { copy.adjList.at(destKey).push_front(copy.edgeList.begin()); }
+    else                   { copy.incomingList[destKey].push_front(copy.edgeList.begin()); }
+  }
+  return copy;
+}
+
+template <class V, class E>
+void Graph<V,E>::_swap(Graph & other) noexcept
+{
+  edgeList.swap(other.edgeList);
+  vertexMap.swap(other.vertexMap);
+  adjList.swap(other.adjList);
+  incomingList.swap(other.incomingList);
+#ifdef GRAPH_STATS
+  std::swap(stats_, other.stats_);
+#endif
+}
+
+/**
+* Deletes every vertex and edge
+*/
+template <class V, class E>
+void Graph<V,E>::_clear()
+{
+  for (E_byRef e : edgeList) { delete &e.get(); }
+  for (auto & pair : vertexMap) { delete &pair.second.get(); }
+  edgeList.clear();
+  vertexMap.clear();
+  adjList.clear();
+  incomingList.clear();
+}
+
 /**
 * @return The number of vertices in the Graph
 */
@@ -17,34 +101,76 @@ unsigned int Graph<V,E>::numVertices() const
   return result;
 }
 
+/**
+* Inserts a Vertex, or returns the existing Vertex with the same key
+* @param key The key of the Vertex
+*/
 template <class V, class E>
 V & Graph<V,E>::insertVertex(std::string key) {
+  GRAPH_STATS_OP(INSERT_VERTEX);
+  GRAPH_COUNT(HASH_LOOKUPS, 1);
+  auto existing = vertexMap.find(key);
+  if (existing != vertexMap.end()) { return existing->second.get(); }
+
+  GRAPH_COUNT(ALLOCATIONS, 1);
+  GRAPH_COUNT(STRING_COPIES, 1);
   V & v = *(new V(key));
-  std::pair<string,V&> temp{key,v};
-  vertexMap.insert({key, v});
-  std::list<edgeListIter> newEdgeList;
-  adjList.insert({key, newEdgeList});
+  // Each new map node holds a copy of the key:
+  GRAPH_COUNT(HASH_LOOKUPS, 2);
+  GRAPH_COUNT(ALLOCATIONS, 2);
+  GRAPH_COUNT(STRING_COPIES, 2);
+  vertexMap.emplace(key, v);
+  adjList.emplace(key, std::list<edgeListIter>());
   return v;
 }
 
+/**
+* @return A snapshot of the operation counters (all zero unless compiled with GRAPH_STATS)
+*/
+template <class V, class E>
+GraphStats Graph<V,E>::stats() const
+{
+#ifdef GRAPH_STATS
+  return stats_;
+#else
+  return GraphStats();
+#endif
+}
+
+/**
+* Sets every operation counter back to zero
+*/
+template <class V, class E>
+void Graph<V,E>::resetStats()
+{
+#ifdef GRAPH_STATS
+  stats_.reset();
+#endif
+}
+
 template <class V, class E>
 const std::list<std::reference_wrapper<E>> Graph<V,E>::incidentEdges(const std::string key) const
 {
+GRAPH_STATS_OP(INCIDENT_EDGES);
+GRAPH_COUNT(HASH_LOOKUPS, 1);
 std::list<std::reference_wrapper<E>> edges;
 for (edgeListIter ite: adjList.at(key))
 {
+  GRAPH_COUNT(LIST_TRAVERSALS, 1);
+  GRAPH_COUNT(EDGES_SCANNED, 1);
+  GRAPH_COUNT(ALLOCATIONS, 1);
   edges.push_back(*ite);
 }
-typedef typename std::list<E_byRef>::const_iterator iterator;
-for(iterator it=edgeList.begin(); it != edgeList.end(); ++it)
+GRAPH_COUNT(HASH_LOOKUPS, 1);
+auto incoming = incomingList.find(key);
+if (incoming != incomingList.end())
 {
-  if (!((*it).get().directed()))
-  {
-    return edges;
-  }
-  else if((*it).get().dest().key()==key)
+  for (edgeListIter ite: incoming->second)
   {
-    edges.push_back((*it));
+    GRAPH_COUNT(LIST_TRAVERSALS, 1);
+    GRAPH_COUNT(EDGES_SCANNED, 1);
+    GRAPH_COUNT(ALLOCATIONS, 1);
+    edges.push_back(*ite);
   }
 }
 return edges;
@@ -53,18 +179,16 @@ return edges;
 template <class V, class E>
 unsigned int Graph<V,E>::degree(const V & v) const
 {
-  int count = adjList.at(v.key()).size();
-  typedef typename std::list<E_byRef>::const_iterator iterator;
-  for(iterator it=edgeList.begin(); it != edgeList.end(); ++it)
+  GRAPH_STATS_OP(DEGREE);
+  GRAPH_COUNT(STRING_COPIES, 1);
+  const std::string key = v.key();
+  GRAPH_COUNT(HASH_LOOKUPS, 1);
+  int count = adjList.at(key).size();
+  GRAPH_COUNT(HASH_LOOKUPS, 1);
+  auto incoming = incomingList.find(key);
+  if (incoming != incomingList.end())
   {
-    if (!((*it).get().directed()))
-    {
-      return count;
-    }
-    else if((*it).get().dest().key()==v.key())
-    {
-      count ++;
-    }
+    count += incoming->second.size();
   }
   return count;
 }
@@ -76,10 +200,29 @@ unsigned int Graph<V,E>::degree(const V & v) const
 template <class V, class E>
 void Graph<V,E>::removeVertex(const std::string & key)
 {
-std::list<E_byRef> incidentEdgeList = incidentEdges(key);
-for (E_byRef e: incidentEdgeList) removeEdge(e.get().source(), e.get().dest());
+GRAPH_STATS_OP(REMOVE_VERTEX);
+GRAPH_COUNT(HASH_LOOKUPS, 2);
+V & v = vertexMap.at(key);
+// removeEdge deletes each edge, so take the next one from the front of the
+// lists each time instead of iterating over them:
+std::list<edgeListIter> & edges = adjList.at(key);
+while (!edges.empty()) {
+  const E & e = *edges.front();
+  GRAPH_COUNT(STRING_COPIES, 2);
+  removeEdge(e.source().key(), e.dest().key());
+}
+GRAPH_COUNT(HASH_LOOKUPS, 1);
+auto incoming = incomingList.find(key);
+while (incoming != incomingList.end() && !incoming->second.empty()) {
+  const E & e = *incoming->second.front();
+  GRAPH_COUNT(STRING_COPIES, 2);
+  removeEdge(e.source().key(), e.dest().key());
+}
+GRAPH_COUNT(HASH_LOOKUPS, 3);
 vertexMap.erase(key);
 adjList.erase(key);
+incomingList.erase(key);
+delete &v;
 }
 
 /**
@@ -90,36 +233,41 @@ adjList.erase(key);
 template <class V, class E>
 void Graph<V,E>::removeEdge(const string key1, const string key2)
 {
+	GRAPH_STATS_OP(REMOVE_EDGE);
 	edgeListIter lola = edgeList.end();
-	bool dFlag = false;
-	typename std::list<edgeListIter>::iterator it = adjList.at(key1).begin();
-  while(it != adjList.at(key1).end()) {
-		E cur = (*(*it)).get();
+	GRAPH_COUNT(HASH_LOOKUPS, 1);
+	std::list<edgeListIter> & edges = adjList.at(key1);
+	typename std::list<edgeListIter>::iterator it = edges.begin();
+  while(it != edges.end()) {
+		GRAPH_COUNT(LIST_TRAVERSALS, 1);
+		GRAPH_COUNT(EDGES_SCANNED, 1);
+		const E & cur = (*it)->get();
+		GRAPH_COUNT(STRING_COPIES, 2);
     string sour =  cur.source().key();
     string des = cur.dest().key();
 		if (sour == key1 && des== key2 ) {
-			adjList.at(key1).erase(it);
 			lola = *it;
+			edges.erase(it);
 			break;
 		}
-		if (!dFlag && cur.directed()) dFlag = true;
     it++;
 	}
-	if (!dFlag) {
-	typename std::list<edgeListIter>::iterator it = adjList.at(key2).begin();
-  while( it != adjList.at(key2).end()) {
-			E cuur = (*(*it)).get();
-      string sour =  cuur.source().key();
-      string des = cuur .dest().key();
-			if ( sour == key1 &&  des == key2 ) {
-				adjList.at(key2).erase(it);
-				lola = *it;
-				break;
-			}
-      it++;
-    }
+	if (lola == edgeList.end()) return;
+
+	// The other copy of the edge: in key2's incoming edges if it is directed,
+	// or in key2's adjacency list if it is not.
+	GRAPH_COUNT(HASH_LOOKUPS, 1);
+	std::list<edgeListIter> & other = (*lola).get().directed() ? incomingList.at(key2) : adjList.at(key2);
+	typename std::list<edgeListIter>::iterator otherIt = other.begin();
+	while (otherIt != other.end() && *otherIt != lola) {
+		GRAPH_COUNT(LIST_TRAVERSALS, 1);
+		GRAPH_COUNT(EDGES_SCANNED, 1);
+		otherIt++;
 	}
-	if (lola != edgeList.end()) edgeList.erase(lola);
+	if (otherIt != other.end()) other.erase(otherIt);
+	E * removed = &(*lola).get();
+	edgeList.erase(lola);
+	delete removed;
 }
 
 /**
@@ -131,8 +279,13 @@ void Graph<V,E>::removeEdge(const string key1, const string key2)
 template <class V, class E>
 bool Graph<V,E>::isAdjacent(const string key1, const string key2) const
 {
+	GRAPH_STATS_OP(IS_ADJACENT);
+	GRAPH_COUNT(HASH_LOOKUPS, 1);
 	for (edgeListIter lola: adjList.at(key1)) {
-		E cur = (*lola).get();
+		GRAPH_COUNT(LIST_TRAVERSALS, 1);
+		GRAPH_COUNT(EDGES_SCANNED, 1);
+		const E & cur = lola->get();
+		GRAPH_COUNT(STRING_COPIES, 2);
     string des = cur.dest().key();
     string sour = cur.source().key();
 		if (des == key2 || sour == key2) return true;
@@ -149,42 +302,68 @@ bool Graph<V,E>::isAdjacent(const string key1, const string key2) const
 template <class V, class E>
 E & Graph<V,E>::insertEdge(const V & v1, const V & v2)
 {
+  	GRAPH_STATS_OP(INSERT_EDGE);
+  	GRAPH_COUNT(HASH_LOOKUPS, 2);
+  	GRAPH_COUNT(STRING_COPIES, 2);
+  	// The Edge refers to the Graph's own vertices, not to `v1` and `v2`
+  	// (which may be copies):
+  	return _insertEdge( vertexMap.at(v1.key()), vertexMap.at(v2.key()) );
+}
+
+template <class V, class E>
+E & Graph<V,E>::_insertEdge(const V & v1, const V & v2)
+{
+  	GRAPH_COUNT(ALLOCATIONS, 2);
   	E & e = *(new E(v1, v2));
   	edgeList.push_front(e);
+  	GRAPH_COUNT(HASH_LOOKUPS, 1);
+  	GRAPH_COUNT(ALLOCATIONS, 1);
+  	GRAPH_COUNT(STRING_COPIES, 1);
   	adjList.at(v1.key()).push_front(edgeList.begin());
-  	if (!e.directed()) adjList.at(v2.key()).push_front(edgeList.begin());
+  	GRAPH_COUNT(HASH_LOOKUPS, 1);
+  	GRAPH_COUNT(ALLOCATIONS, 1);
+  	GRAPH_COUNT(STRING_COPIES, 1);
+  	if (!e.directed()) {
+  		adjList.at(v2.key()).push_front(edgeList.begin());
+  	} else {
+  		auto incoming = incomingList.try_emplace(v2.key());
+  		if (incoming.second) { GRAPH_COUNT(ALLOCATIONS, 1); }
+  		incoming.first->second.push_front(edgeList.begin());
+  	}
   	return e;
 }
 
 /**
-* Removes an Edge from the adjacency list at the location of the given iterator
+* Removes an Edge from the Graph, given its position in the edge list
 * @param it An iterator at the location of the Edge that
 * you would like to remove
 */
 template <class V, class E>
 void Graph<V,E>::removeEdge(const edgeListIter & it)
 {
-	V vertex1 = (*it).get().source();
-	V vertex2 = (*it).get().dest();
-	bool directedFlag = false;
-	typename std::list<edgeListIter>::iterator iot = adjList.at(vertex1.key()).begin();
-  while(it != adjList.at(vertex1.key()).end()) {
-		if ( (*iot) == iot) {
-			adjList.at(vertex1.key()).erase(iot);
-			break;
-		}
-		if (!directedFlag && (*iot).get().directed()) directedFlag = true;
-    iot++;
-	}
-	if (!directedFlag) {
-	typename std::list<edgeListIter>::iterator iot = adjList.at(vertex2.key()).begin();
-  while(iot != adjList.at(vertex2.key()).end()) {
-			if ( (*iot) == iot) {
-				adjList.at(vertex2.key()).erase(iot);
-				break;
-			}
-      iot++;
+	GRAPH_STATS_OP(REMOVE_EDGE);
+	// `it` may be an element of one of the lists it is unlinked from:
+	edgeListIter edge = it;
+	const E & e = edge->get();
+
+	// The Edge is in its source's adjacency list, and in its destination's
+	// incoming edges if it is directed, or adjacency list if it is not (a
+	// loop is in the same list twice):
+	GRAPH_COUNT(HASH_LOOKUPS, 2);
+	GRAPH_COUNT(STRING_COPIES, 2);
+	std::list<edgeListIter> & out = adjList.at(e.source().key());
+	std::list<edgeListIter> & in = e.directed() ? incomingList.at(e.dest().key()) : adjList.at(e.dest().key());
+	for (std::list<edgeListIter> * edges : { &out, &in }) {
+		typename std::list<edgeListIter>::iterator pos = edges->begin();
+		while (pos != edges->end() && *pos != edge) {
+			GRAPH_COUNT(LIST_TRAVERSALS, 1);
+			GRAPH_COUNT(EDGES_SCANNED, 1);
+			pos++;
 		}
+		if (pos != edges->end()) { edges->erase(pos); }
 	}
-	edgeList.erase(iot);
+
+	E * removed = &edge->get();
+	edgeList.erase(edge);
+	delete removed;
 }
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <string>
 #include <list>
+#include <climits>
 
 using namespace std;
 /**
@@ -71,24 +72,37 @@ template <class V, class E>
 
 std::list<std::string> Graph<V,E>::shortestPath(const std::string start, const std::string end)
 {
-unordered_map<string, string> predecessor;
-unordered_map<string, int> distances;
-for (pair<string, V &> elem: vertexMap)
+GRAPH_STATS_OP(SHORTEST_PATH);
+TRACE_SPAN("Graph::shortestPath", "traverse");
+unordered_map<string, string, KeyHash> predecessor;
+unordered_map<string, int, KeyHash> distances;
+for (const auto & elem: vertexMap)
 {
-	predecessor.insert(pair<string, string>(elem.first, ""));
-	distances.insert(pair<string, int>(elem.first, INT_MAX));
+	GRAPH_COUNT(HASH_LOOKUPS, 2);
+	GRAPH_COUNT(ALLOCATIONS, 2);
+	GRAPH_COUNT(STRING_COPIES, 2);
+	predecessor.emplace(elem.first, "");
+	distances.emplace(elem.first, INT_MAX);
 }
 queue<string> q;
+GRAPH_COUNT(STRING_COPIES, 1);
 q.push(start);
+GRAPH_COUNT(HASH_LOOKUPS, 1);
 distances[start] = 0;
 while (!q.empty()) {
-string cur = q.front();
+string cur = std::move(q.front());
 q.pop();
 for (E_byRef ebr: incidentEdges(cur))
 {
+	GRAPH_COUNT(LIST_TRAVERSALS, 1);
+	GRAPH_COUNT(EDGES_SCANNED, 1);
+	GRAPH_COUNT(HASH_LOOKUPS, 2);
+	GRAPH_COUNT(STRING_COPIES, 2);
 	string cur_next = ebr.get().dest().key() == cur ? ebr.get().source().key() : ebr.get().dest().key();
 	if (distances[cur_next] > (distances[cur] + 1))
   {
+		GRAPH_COUNT(HASH_LOOKUPS, 3);
+		GRAPH_COUNT(STRING_COPIES, 2);
 		q.push(cur_next);
 		predecessor[cur_next] = cur;
 		distances[cur_next] = distances[cur] + 1;
@@ -99,6 +113,9 @@ list<string> path;
 string cur = end;
 while (cur != "")
 {
+	GRAPH_COUNT(HASH_LOOKUPS, 1);
+	GRAPH_COUNT(ALLOCATIONS, 1);
+	GRAPH_COUNT(STRING_COPIES, 2);
 	path.push_front(cur);
 	cur = predecessor[cur];
 }
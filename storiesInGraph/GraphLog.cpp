@@ -0,0 +1,205 @@
+#include "GraphLog.h"
+#include "Trace.h"
+#include "cs225/lodepng/lodepng.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+
+static void putU32(std::string & out, uint32_t value) {
+  for (int i = 0; i < 4; i++) { out.push_back((char) ((value >> (8 * i)) & 0xff)); }
+}
+
+static bool getU32(std::string_view data, size_t & pos, uint32_t & value) {
+  if (data.size() - pos < 4) { return false; }
+  value = 0;
+  for (int i = 0; i < 4; i++) { value |= (uint32_t) (unsigned char) data[pos + i] << (8 * i); }
+  pos += 4;
+  return true;
+}
+
+static void putString(std::string & out, const std::string & s) {
+  putU32(out, s.size());
+  out.append(s);
+}
+
+static bool getString(std::string_view data, size_t & pos, std::string & s) {
+  uint32_t length;
+  if (!getU32(data, pos, length) || data.size() - pos < length) { return false; }
+  s.assign(data.data() + pos, length);
+  pos += length;
+  return true;
+}
+
+static uint32_t crc32(std::string_view data) {
+  return lodepng_crc32(reinterpret_cast<const unsigned char *>(data.data()), data.size());
+}
+
+static bool writeAll(int fd, std::string_view data) {
+  while (!data.empty()) {
+    ssize_t n = ::write(fd, data.data(), data.size());
+    if (n < 0) { return false; }
+    data.remove_prefix(n);
+  }
+  return true;
+}
+
+bool GraphLog::open(const std::string & path, bool durable) {
+  close();
+  std::lock_guard<std::mutex> lock(mutex_);
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd_ < 0) { return false; }
+  durable_ = durable;
+  failed_ = false;
+  bytes_ = lseek(fd_, 0, SEEK_END);
+  return true;
+}
+
+void GraphLog::close() {
+  uint64_t last;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last = appended_;
+  }
+  flush(last);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ >= 0) { ::close(fd_); }
+  fd_ = -1;
+  bytes_ = 0;
+}
+
+uint64_t GraphLog::append(const Record & record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  encode(record, pending_);
+  return ++appended_;
+}
+
+bool GraphLog::flush(uint64_t seq) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (seq > appended_) { seq = appended_; }
+  while (written_ < seq && !failed_) {
+    if (writing_) { batchDone_.wait(lock); }
+    else          { _writeBatch(lock, durable_); }
+  }
+  return !failed_;
+}
+
+bool GraphLog::rotate(const std::string & path) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Write out everything, and sync even a non-durable log: a snapshot will
+  // replace it.
+  do {
+    if (writing_) { batchDone_.wait(lock); }
+    else          { _writeBatch(lock, true); }
+  } while (writing_ || written_ < appended_);
+  if (failed_) { return false; }
+
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) { return false; }
+  if (fd_ >= 0) { ::close(fd_); }
+  fd_ = fd;
+  bytes_ = lseek(fd_, 0, SEEK_END);
+  return true;
+}
+
+bool GraphLog::failed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return failed_;
+}
+
+uint64_t GraphLog::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_ + pending_.size();
+}
+
+uint64_t GraphLog::pendingBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+/**
+* Writes (and optionally syncs) every pending record, releasing `lock`
+* while doing so.  Must be called with `lock` held and no batch being written.
+*/
+bool GraphLog::_writeBatch(std::unique_lock<std::mutex> & lock, bool sync) {
+  std::string batch;
+  batch.swap(pending_);
+  uint64_t last = appended_;
+  int fd = fd_;
+  writing_ = true;
+  lock.unlock();
+
+  bool ok = (fd >= 0);
+  {
+    TRACE_SPAN("GraphLog::_writeBatch", "io");
+    ok = ok && writeAll(fd, batch);
+    ok = ok && (!sync || fdatasync(fd) == 0);
+  }
+
+  lock.lock();
+  writing_ = false;
+  written_ = last;
+  bytes_ += batch.size();
+  if (!ok) { failed_ = true; }
+  batchDone_.notify_all();
+  return ok;
+}
+
+void GraphLog::encode(const Record & record, std::string & out) {
+  std::string payload;
+  payload.push_back((char) record.op);
+  putString(payload, record.key1);
+  putString(payload, record.key2);
+  putString(payload, record.name);
+  putString(payload, record.value);
+
+  putU32(out, payload.size());
+  putU32(out, crc32(payload));
+  out.append(payload);
+}
+
+size_t GraphLog::decode(std::string_view data, const std::function<void(const Record &)> & visit) {
+  Record record;
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t cur = pos;
+    uint32_t length, crc;
+    if (!getU32(data, cur, length) || !getU32(data, cur, crc) || data.size() - cur < length) { break; }
+
+    std::string_view payload = data.substr(cur, length);
+    if (crc32(payload) != crc || payload.empty()) { break; }
+    if (payload[0] < INSERT_VERTEX || payload[0] > SET_EDGE_PROPERTY) { break; }
+
+    size_t field = 1;
+    record.op = (Op) payload[0];
+    if (!getString(payload, field, record.key1) || !getString(payload, field, record.key2) ||
+        !getString(payload, field, record.name) || !getString(payload, field, record.value)) { break; }
+
+    visit(record);
+    pos = cur + length;
+  }
+  return pos;
+}
+
+bool GraphLog::replaceFile(const std::string & path, std::string_view data) {
+  std::string tmp = path + ".tmp";
+  int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) { return false; }
+  bool ok = writeAll(fd, data) && fsync(fd) == 0;
+  ::close(fd);
+  if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+
+  // Make the rename itself durable:
+  size_t slash = path.rfind('/');
+  std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+  int dirFd = ::open(dir.c_str(), O_RDONLY);
+  if (dirFd >= 0) {
+    fsync(dirFd);
+    ::close(dirFd);
+  }
+  return true;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * An append-only file of graph mutations, used by PersistentGraph for both
+ * its mutation log and its snapshot.
+ *
+ * Each record is framed as `[payload length][CRC-32 of payload][payload]`
+ * (little-endian 32-bit integers), so a record torn by a crash is detected
+ * and everything from it onwards is ignored.
+ *
+ * Appending only buffers a record.  `flush` writes the buffer, and with
+ * `durable` logs also fdatasync(2)s it, as a group commit: one thread
+ * writes every record appended so far while the others wait for it, so
+ * concurrent writers share one write and one sync.
+ */
+class GraphLog {
+  public:
+    enum Op : uint8_t {
+      INSERT_VERTEX = 1,     /*< key1 */
+      REMOVE_VERTEX,         /*< key1 */
+      INSERT_EDGE,           /*< key1 -> key2 */
+      REMOVE_EDGE,           /*< key1 -> key2 */
+      SET_VERTEX_PROPERTY,   /*< key1, name = value */
+      SET_EDGE_PROPERTY      /*< key1 -> key2, name = value */
+    };
+
+    class Record {
+      public:
+        Op op;
+        std::string key1;
+        std::string key2;
+        std::string name;
+        std::string value;
+    };
+
+    GraphLog() : fd_(-1), durable_(true), writing_(false), failed_(false), appended_(0), written_(0), bytes_(0) { }
+    ~GraphLog() { close(); }
+
+    GraphLog(const GraphLog & other) = delete;
+    GraphLog & operator=(const GraphLog & other) = delete;
+
+    /**
+     * Opens (or creates) the log at `path` for appending.
+     * @param durable Whether `flush` also syncs the file to disk.
+     * @return true, if the file was opened.
+     */
+    bool open(const std::string & path, bool durable);
+
+    /**
+     * Writes and syncs anything still buffered, then closes the file.
+     */
+    void close();
+
+    /**
+     * Buffers `record`.
+     * @return Its sequence number, to `flush` up to.
+     */
+    uint64_t append(const Record & record);
+
+    /**
+     * Returns once every record up to sequence number `seq` (or every
+     * record, for UINT64_MAX) is written and, for durable logs, synced.
+     * @return false, if a write or sync of this log has ever failed.
+     */
+    bool flush(uint64_t seq);
+
+    /**
+     * Flushes and syncs this log, then continues in a new file at `path`.
+     * @return false, if the old log could not be written or the new one opened.
+     */
+    bool rotate(const std::string & path);
+
+    /**
+     * @return true, if a write or sync of this log has ever failed.
+     */
+    bool failed() const;
+
+    /**
+     * @return The size of the current file, including buffered records.
+     */
+    uint64_t bytes() const;
+
+    /**
+     * @return The size of the records that are buffered but not yet written.
+     */
+    uint64_t pendingBytes() const;
+
+    /**
+     * Appends the framed encoding of `record` to `out`.
+     */
+    static void encode(const Record & record, std::string & out);
+
+    /**
+     * Calls `visit` for every intact record of `data`, in order, stopping at
+     * the first torn or corrupt one.
+     * @return The length of the intact prefix of `data`.
+     */
+    static size_t decode(std::string_view data, const std::function<void(const Record &)> & visit);
+
+    /**
+     * Replaces the file at `path` with `data` atomically: the data is
+     * written and synced to `<path>.tmp`, which is then renamed over `path`.
+     * @return true, if the file was replaced.
+     */
+    static bool replaceFile(const std::string & path, std::string_view data);
+
+  private:
+    int fd_;
+    bool durable_;
+    std::string pending_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable batchDone_;
+    bool writing_;        /*< A thread is writing a batch, without holding `mutex_` */
+    bool failed_;
+    uint64_t appended_;   /*< Sequence number of the last appended record */
+    uint64_t written_;    /*< Sequence number of the last written record */
+    uint64_t bytes_;      /*< Size of the file, excluding `pending_` */
+
+    bool _writeBatch(std::unique_lock<std::mutex> & lock, bool sync);
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Graph.h"
+#include "CsrGraph.h"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+/**
+ * Orders the vertices of a Graph with Kahn's algorithm, for
+ * Graph::topologicalOrder and Graph::findCycle.
+ *
+ * The sort runs over a CsrGraph, so it touches no strings or hash tables
+ * and takes O(|V| + |E|).  Any Edge closes a cycle, since it can be walked
+ * both ways.
+ */
+template <class V, class E>
+class TopologicalSort {
+  public:
+    explicit TopologicalSort(const Graph<V,E> & g);
+
+    bool acyclic() const { return order_.size() == csr_.numVertices(); }
+
+    /**
+     * @return The keys of every vertex, each before the vertices it has an
+     * edge to, or nothing if there is a cycle.
+     */
+    std::list<std::string> order() const;
+
+    /**
+     * @return The keys around one cycle, or nothing if there is none.
+     */
+    std::list<std::string> cycle() const;
+
+  private:
+    CsrGraph csr_;
+    std::vector<uint32_t> indegree_;  /*< After the sort, from the vertices left unsorted */
+    std::vector<uint32_t> order_;
+};
+
+template <class V, class E>
+TopologicalSort<V,E>::TopologicalSort(const Graph<V,E> & g) : csr_(CsrGraph::fromGraph(g))
+{
+  TRACE_SPAN("TopologicalSort", "traverse");
+  uint32_t n = csr_.numVertices();
+  indegree_.assign(n, 0);
+  for (uint32_t v = 0; v < n; v++) {
+    for (uint32_t w : csr_.neighbors(v)) { indegree_[w]++; }
+  }
+
+  // `order_` doubles as the queue of vertices with no unsorted in-neighbors:
+  order_.reserve(n);
+  for (uint32_t v = 0; v < n; v++) {
+    if (indegree_[v] == 0) { order_.push_back(v); }
+  }
+  for (size_t head = 0; head < order_.size(); head++) {
+    uint32_t v = order_[head];
+    for (uint32_t w : csr_.neighbors(v)) {
+      if (--indegree_[w] == 0) { order_.push_back(w); }
+    }
+  }
+}
+
+template <class V, class E>
+std::list<std::string> TopologicalSort<V,E>::order() const
+{
+  std::list<std::string> keys;
+  if (!acyclic()) { return keys; }
+  for (uint32_t v : order_) { keys.push_back(csr_.key(v)); }
+  return keys;
+}
+
+template <class V, class E>
+std::list<std::string> TopologicalSort<V,E>::cycle() const
+{
+  std::list<std::string> keys;
+  if (acyclic()) { return keys; }
+
+  // Every vertex left unsorted has an unsorted in-neighbor, so walking
+  // back through them must come round to a vertex seen before:
+  const uint32_t NONE = UINT32_MAX;
+  uint32_t n = csr_.numVertices();
+  std::vector<uint32_t> predecessor(n, NONE);
+  uint32_t start = NONE;
+  for (uint32_t v = 0; v < n; v++) {
+    if (indegree_[v] == 0) { continue; }
+    start = v;
+    for (uint32_t w : csr_.neighbors(v)) {
+      if (indegree_[w] != 0) { predecessor[w] = v; }
+    }
+  }
+
+  std::vector<bool> seen(n, false);
+  uint32_t v = start;
+  while (!seen[v]) {
+    seen[v] = true;
+    v = predecessor[v];
+  }
+  // `v` is on the cycle; walking back from it lists the cycle in reverse:
+  uint32_t u = v;
+  do {
+    keys.push_front(csr_.key(u));
+    u = predecessor[u];
+  } while (u != v);
+  return keys;
+}
+
+/**
+* @return The keys of every vertex, each before the vertices it has an edge
+* to, or an empty list if the graph has a cycle (see findCycle)
+*/
+template <class V, class E>
+std::list<std::string> Graph<V,E>::topologicalOrder() const
+{
+  return TopologicalSort<V,E>(*this).order();
+}
+
+/**
+* @return The keys of the vertices around one cycle, in the order of its
+* edges (the last has an edge back to the first), or an empty list if the
+* graph has no cycle
+*/
+template <class V, class E>
+std::list<std::string> Graph<V,E>::findCycle() const
+{
+  return TopologicalSort<V,E>(*this).cycle();
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Graph.h"
+#include "CsrGraph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Yen's algorithm for the k shortest loopless paths between two vertices,
+ * for Graph::kShortestPaths.
+ *
+ * Each path after the first is found by taking a prefix (the root) of the
+ * last path found, banning the root's vertices and the next edge of every
+ * path found with the same root, and searching from the root's last
+ * vertex (the spur) to the end.  The graph is never copied or changed:
+ * the searches run over a CsrGraph, and share one set of search arrays
+ * in which every search stamps the vertices it visits, so starting a
+ * search costs nothing, and the banned vertices are simply stamped as
+ * visited first.
+ *
+ * Paths are sequences of vertices, counted in edges; parallel edges do not
+ * make different paths.
+ */
+template <class V, class E>
+class KShortestPaths {
+  public:
+    KShortestPaths(const Graph<V,E> & g, const std::string & start, const std::string & end);
+
+    /**
+     * @return The (at most) `k` shortest paths, shortest first.
+     */
+    std::vector<std::list<std::string>> first(unsigned int k);
+
+  private:
+    typedef std::vector<uint32_t> Path;
+
+    CsrGraph csr_;
+    uint32_t start_;
+    uint32_t end_;
+    std::vector<uint32_t> visited_;  /*< The stamp of the last search to visit each vertex */
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> queue_;
+    uint32_t stamp_;
+
+    uint32_t _nextStamp();
+    bool _search(uint32_t spur, const std::vector<uint32_t> & blocked, uint32_t stamp, Path & path);
+};
+
+template <class V, class E>
+KShortestPaths<V,E>::KShortestPaths(const Graph<V,E> & g, const std::string & start, const std::string & end) :
+  csr_(CsrGraph::fromGraph(g)), start_(csr_.id(start)), end_(csr_.id(end)),
+  visited_(csr_.numVertices(), 0), parent_(csr_.numVertices()), stamp_(0) { }
+
+template <class V, class E>
+std::vector<std::list<std::string>> KShortestPaths<V,E>::first(unsigned int k)
+{
+  TRACE_SPAN("KShortestPaths", "traverse");
+  std::vector<Path> found;
+  std::set<std::pair<size_t, Path>> candidates;  /*< Shortest first, without duplicates */
+
+  Path path;
+  if (k > 0 && _search(start_, {}, _nextStamp(), path)) { found.push_back(path); }
+
+  while (!found.empty() && found.size() < k) {
+    const Path & last = found.back();
+    for (size_t i = 0; i + 1 < last.size(); i++) {
+      uint32_t spur = last[i];
+
+      // Paths already found with this root must leave it another way:
+      std::vector<uint32_t> blocked;
+      for (const Path & other : found) {
+        if (other.size() > i + 1 && std::equal(last.begin(), last.begin() + i + 1, other.begin())) {
+          blocked.push_back(other[i + 1]);
+        }
+      }
+
+      // ...and without going back through it:
+      uint32_t stamp = _nextStamp();
+      for (size_t j = 0; j < i; j++) { visited_[last[j]] = stamp; }
+      if (!_search(spur, blocked, stamp, path)) { continue; }
+
+      Path candidate(last.begin(), last.begin() + i);
+      candidate.insert(candidate.end(), path.begin(), path.end());
+      candidates.insert({ candidate.size(), std::move(candidate) });
+    }
+
+    if (candidates.empty()) { break; }
+    found.push_back(candidates.begin()->second);
+    candidates.erase(candidates.begin());
+  }
+
+  std::vector<std::list<std::string>> result;
+  for (const Path & p : found) {
+    std::list<std::string> keys;
+    for (uint32_t v : p) { keys.push_back(csr_.key(v)); }
+    result.push_back(keys);
+  }
+  return result;
+}
+
+/**
+* @return A stamp no vertex has been visited with yet
+*/
+template <class V, class E>
+uint32_t KShortestPaths<V,E>::_nextStamp()
+{
+  if (++stamp_ == 0) {
+    std::fill(visited_.begin(), visited_.end(), 0);
+    stamp_ = 1;
+  }
+  return stamp_;
+}
+
+/**
+* Breadth-first search for a shortest path from `spur` to the end, through
+* vertices not yet stamped with `stamp`, and not along an edge from `spur`
+* to a vertex in `blocked`
+* @return true (with the path in `path`), if there is one
+*/
+template <class V, class E>
+bool KShortestPaths<V,E>::_search(uint32_t spur, const std::vector<uint32_t> & blocked, uint32_t stamp, Path & path)
+{
+  const uint32_t NONE = UINT32_MAX;
+  queue_.clear();
+  queue_.push_back(spur);
+  visited_[spur] = stamp;
+  parent_[spur] = NONE;
+
+  bool reached = (spur == end_);
+  for (size_t head = 0; head < queue_.size() && !reached; head++) {
+    uint32_t v = queue_[head];
+    for (uint32_t w : csr_.neighbors(v)) {
+      if (visited_[w] == stamp) { continue; }
+      if (v == spur && std::find(blocked.begin(), blocked.end(), w) != blocked.end()) { continue; }
+      visited_[w] = stamp;
+      parent_[w] = v;
+      if (w == end_) { reached = true; break; }
+      queue_.push_back(w);
+    }
+  }
+  if (!reached) { return false; }
+
+  path.clear();
+  for (uint32_t v = end_; v != NONE; v = parent_[v]) { path.push_back(v); }
+  std::reverse(path.begin(), path.end());
+  return true;
+}
+
+/**
+* @return The `k` shortest loopless paths from `start` to `end` (fewer if
+* there are not that many), shortest first, each a list of keys like
+* shortestPath's.  Edges are walked the way they point.
+* @throws std::out_of_range if there is no Vertex `start` or `end`
+*/
+template <class V, class E>
+std::vector<std::list<std::string>> Graph<V,E>::kShortestPaths(const std::string & start, const std::string & end, unsigned int k) const
+{
+  return KShortestPaths<V,E>(*this, start, end).first(k);
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+
+/**
+ * Operation counters for Graph.
+ *
+ * Counting is compiled in only when `GRAPH_STATS` is defined, which must be
+ * done for the whole build since it changes the layout of Graph: `make
+ * test-stats` builds the test suite with it, and `make GRAPH_STATS=1`
+ * builds everything with it (`make clean` before toggling).  Otherwise the
+ * GRAPH_STATS_OP / GRAPH_COUNT macros expand to nothing and
+ * `Graph::stats()` returns all zeros.
+ *
+ * Only the outermost operation that is running on a Graph is counted, and
+ * all of its work is charged to it: the incidentEdges and removeEdge calls
+ * made by removeVertex show up as the cost of removeVertex.  Each count is
+ * made next to the statement that does the work, so the numbers are what
+ * the code does for that call, not estimates.  Counters are relaxed
+ * atomics and the running operation is tracked per thread, so const
+ * queries may be counted from several threads at once.
+ */
+class GraphStats {
+  public:
+    enum Operation {
+      INSERT_VERTEX, REMOVE_VERTEX, INSERT_EDGE, REMOVE_EDGE,
+      INCIDENT_EDGES, DEGREE, IS_ADJACENT, SHORTEST_PATH,
+      NUM_OPERATIONS
+    };
+
+    enum Counter {
+      CALLS,            /*< Times the operation was called (not from another operation) */
+      HASH_LOOKUPS,     /*< unordered_map finds, inserts and erases (not rehashes) */
+      LIST_TRAVERSALS,  /*< std::list nodes stepped over */
+      ALLOCATIONS,      /*< Heap allocations of vertices, edges, and list and map nodes */
+      STRING_COPIES,    /*< std::string copies made by Graph, including each Vertex::key() (it returns by value) */
+      EDGES_SCANNED,    /*< Edges examined */
+      NUM_COUNTERS
+    };
+
+    GraphStats() { reset(); }
+    GraphStats(const GraphStats & other) { *this = other; }
+    GraphStats & operator=(const GraphStats & other) {
+      for (int op = 0; op < NUM_OPERATIONS; op++) {
+        for (int c = 0; c < NUM_COUNTERS; c++) {
+          counts_[op][c].store(other.counts_[op][c].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+      }
+      return *this;
+    }
+
+    /**
+     * @return The value of `counter` for `op`.
+     */
+    unsigned long long get(Operation op, Counter counter) const { return counts_[op][counter].load(std::memory_order_relaxed); }
+
+    /**
+     * @return The value of `counter` summed over every operation.
+     */
+    unsigned long long total(Counter counter) const {
+      unsigned long long sum = 0;
+      for (int op = 0; op < NUM_OPERATIONS; op++) { sum += get(Operation(op), counter); }
+      return sum;
+    }
+
+    /**
+     * Sets every counter to zero.
+     */
+    void reset() {
+      for (int op = 0; op < NUM_OPERATIONS; op++) {
+        for (int c = 0; c < NUM_COUNTERS; c++) { counts_[op][c].store(0, std::memory_order_relaxed); }
+      }
+    }
+
+    /**
+     * Adds `n` to `counter` of the operation this thread is running on this
+     * GraphStats, if any.
+     */
+    void add(Counter counter, unsigned long long n = 1) {
+      for (const Scope * scope = Scope::active(); scope != nullptr; scope = scope->previous_) {
+        if (&scope->stats_ == this) {
+          counts_[scope->op_][counter].fetch_add(n, std::memory_order_relaxed);
+          return;
+        }
+      }
+    }
+
+    static const char * name(Operation op) {
+      static const char * names[] = {
+        "insertVertex", "removeVertex", "insertEdge", "removeEdge",
+        "incidentEdges", "degree", "isAdjacent", "shortestPath"
+      };
+      return names[op];
+    }
+
+    static const char * name(Counter counter) {
+      static const char * names[] = {
+        "calls", "hashLookups", "listTraversals", "allocations", "stringCopies", "edgesScanned"
+      };
+      return names[counter];
+    }
+
+    /**
+     * Marks `op` as running on `stats` in this thread for the lifetime of
+     * the Scope.  A Scope opened while another one of the same GraphStats is
+     * open charges its work to the outer operation.
+     */
+    class Scope {
+      public:
+        Scope(GraphStats & stats, Operation op) : stats_(stats), op_(op), previous_(active()) {
+          bool outermost = true;
+          for (const Scope * scope = previous_; scope != nullptr; scope = scope->previous_) {
+            if (&scope->stats_ == &stats) { op_ = scope->op_; outermost = false; break; }
+          }
+          if (outermost) { stats_.counts_[op][CALLS].fetch_add(1, std::memory_order_relaxed); }
+          active() = this;
+        }
+        ~Scope() { active() = previous_; }
+
+        Scope(const Scope & other) = delete;
+        Scope & operator=(const Scope & other) = delete;
+
+      private:
+        friend class GraphStats;
+
+        // The innermost open Scope of this thread:
+        static const Scope *& active() {
+          static thread_local const Scope * scope = nullptr;
+          return scope;
+        }
+
+        GraphStats & stats_;
+        Operation op_;
+        const Scope * previous_;
+    };
+
+    /**
+     * Prints one row per operation that was called.
+     */
+    friend std::ostream & operator<<(std::ostream & out, const GraphStats & stats) {
+      out << std::setw(14) << "operation";
+      for (int c = 0; c < NUM_COUNTERS; c++) { out << std::setw(16) << name(Counter(c)); }
+      out << std::endl;
+
+      for (int op = 0; op < NUM_OPERATIONS; op++) {
+        if (stats.get(Operation(op), CALLS) == 0) { continue; }
+        out << std::setw(14) << name(Operation(op));
+        for (int c = 0; c < NUM_COUNTERS; c++) { out << std::setw(16) << stats.get(Operation(op), Counter(c)); }
+        out << std::endl;
+      }
+      return out;
+    }
+
+  private:
+    std::atomic<unsigned long long> counts_[NUM_OPERATIONS][NUM_COUNTERS];
+};
+
+#ifdef GRAPH_STATS
+  #define GRAPH_STATS_OP(op) GraphStats::Scope graphStatsScope_(stats_, GraphStats::op)
+  #define GRAPH_COUNT(counter, n) stats_.add(GraphStats::counter, (n))
+#else
+  #define GRAPH_STATS_OP(op)
+  #define GRAPH_COUNT(counter, n)
+#endif
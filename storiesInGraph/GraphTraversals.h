@@ -0,0 +1,266 @@
+#pragma once
+
+#include "Graph.h"
+
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Lazy traversals of a Graph, returned by Graph::bfsOrder, Graph::dfsOrder
+ * and Graph::pathsBetween.
+ *
+ * Each is a range that computes its next result only when its iterator is
+ * advanced, so a caller that stops after the first few results only pays
+ * for those.  Results are references to the Graph's own vertices (no keys
+ * are copied), and vertices are told apart by address.  A traversal walks
+ * edges the way they point: both ways for an Edge, from source to dest for
+ * a DirectedEdge.
+ *
+ * A traversal is invalidated by any change to its Graph, and a result is
+ * valid until the iterator is advanced.
+ */
+
+/**
+ * An input iterator over a traversal `T`, which provides `done()`,
+ * `current()` and `next()`.
+ */
+template <class T, class Result>
+class TraversalIterator {
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef Result value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Result * pointer;
+    typedef const Result & reference;
+
+    TraversalIterator(T * traversal) : traversal_(traversal) { }
+
+    reference operator*() const { return traversal_->current(); }
+    pointer operator->() const { return &traversal_->current(); }
+    TraversalIterator & operator++() { traversal_->next(); return *this; }
+
+    // Every iterator that reached the end compares equal to end():
+    bool operator==(const TraversalIterator & other) const { return _done() == other._done(); }
+    bool operator!=(const TraversalIterator & other) const { return !(*this == other); }
+
+  private:
+    T * traversal_;
+
+    bool _done() const { return traversal_ == nullptr || traversal_->done(); }
+};
+
+/**
+ * Yields the vertices reachable from a start vertex in breadth-first order.
+ */
+template <class V, class E>
+class BfsOrder {
+  public:
+    typedef TraversalIterator<BfsOrder, V> iterator;
+
+    BfsOrder(const Graph<V,E> & g, const V & start) : g_(g) {
+      queue_.push_back(&start);
+      visited_.insert(&start);
+    }
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(nullptr); }
+
+    bool done() const { return queue_.empty(); }
+    const V & current() const { return *queue_.front(); }
+
+    void next() {
+      const V * cur = queue_.front();
+      queue_.pop_front();
+      for (const auto & it : g_.adjList.at(cur->key())) {
+        const V * neighbor = &_neighbor(*it, *cur);
+        if (visited_.insert(neighbor).second) { queue_.push_back(neighbor); }
+      }
+    }
+
+  private:
+    const Graph<V,E> & g_;
+    std::deque<const V *> queue_;
+    std::unordered_set<const V *> visited_;
+
+    static const V & _neighbor(const E & e, const V & cur) {
+      return static_cast<const V &>(&e.dest() == &cur ? e.source() : e.dest());
+    }
+};
+
+/**
+ * Yields the vertices reachable from a start vertex in depth-first
+ * preorder, visiting neighbors in adjacency-list order (the order of a
+ * recursive DFS).
+ */
+template <class V, class E>
+class DfsOrder {
+  public:
+    typedef TraversalIterator<DfsOrder, V> iterator;
+
+    DfsOrder(const Graph<V,E> & g, const V & start) : g_(g) { _visit(start); }
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(nullptr); }
+
+    bool done() const { return stack_.empty(); }
+    const V & current() const { return *current_; }
+
+    // Resumes the search where the current vertex was found:
+    void next() {
+      while (!stack_.empty()) {
+        Frame & top = stack_.back();
+        while (top.next != top.end) {
+          const V & neighbor = _neighbor(**top.next, *top.vertex);
+          ++top.next;
+          if (visited_.count(&neighbor) == 0) {
+            _visit(neighbor);
+            return;
+          }
+        }
+        stack_.pop_back();
+      }
+    }
+
+  private:
+    typedef typename std::list<typename std::list<std::reference_wrapper<E>>::iterator>::const_iterator AdjIter;
+
+    class Frame {
+      public:
+        const V * vertex;
+        AdjIter next;
+        AdjIter end;
+    };
+
+    const Graph<V,E> & g_;
+    std::vector<Frame> stack_;
+    std::unordered_set<const V *> visited_;
+    const V * current_;
+
+    void _visit(const V & v) {
+      const auto & edges = g_.adjList.at(v.key());
+      stack_.push_back(Frame{ &v, edges.begin(), edges.end() });
+      visited_.insert(&v);
+      current_ = &v;
+    }
+
+    static const V & _neighbor(const E & e, const V & cur) {
+      return static_cast<const V &>(&e.dest() == &cur ? e.source() : e.dest());
+    }
+};
+
+/**
+ * Yields every simple path (no repeated vertex) from a start vertex to an
+ * end vertex with at most `maxLength` edges, in depth-first order.
+ */
+template <class V, class E>
+class PathsBetween {
+  public:
+    typedef std::vector<std::reference_wrapper<const V>> Path;
+    typedef TraversalIterator<PathsBetween, Path> iterator;
+
+    PathsBetween(const Graph<V,E> & g, const V & start, const V & end, unsigned int maxLength) :
+      g_(g), end_(&end), maxLength_(maxLength) {
+      _push(start);
+      if (&start != end_) { next(); }
+    }
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(nullptr); }
+
+    bool done() const { return stack_.empty(); }
+    const Path & current() const { return path_; }
+
+    // Continues the search below the last vertex of the current path:
+    void next() {
+      while (!stack_.empty()) {
+        Frame & top = stack_.back();
+        // Paths stop at the end vertex, and at the length limit:
+        if (top.vertex == end_ || path_.size() > maxLength_) { top.next = top.end; }
+
+        bool extended = false;
+        while (top.next != top.end) {
+          const V & neighbor = _neighbor(**top.next, *top.vertex);
+          ++top.next;
+          if (onPath_.count(&neighbor) == 0) {
+            _push(neighbor);
+            extended = true;
+            break;
+          }
+        }
+
+        if (!extended) {
+          _pop();
+        } else if (stack_.back().vertex == end_) {
+          return;
+        }
+      }
+    }
+
+  private:
+    typedef typename std::list<typename std::list<std::reference_wrapper<E>>::iterator>::const_iterator AdjIter;
+
+    class Frame {
+      public:
+        const V * vertex;
+        AdjIter next;
+        AdjIter end;
+    };
+
+    const Graph<V,E> & g_;
+    const V * end_;
+    unsigned int maxLength_;
+    std::vector<Frame> stack_;
+    Path path_;
+    std::unordered_set<const V *> onPath_;
+
+    void _push(const V & v) {
+      const auto & edges = g_.adjList.at(v.key());
+      stack_.push_back(Frame{ &v, edges.begin(), edges.end() });
+      path_.push_back(v);
+      onPath_.insert(&v);
+    }
+
+    void _pop() {
+      onPath_.erase(stack_.back().vertex);
+      path_.pop_back();
+      stack_.pop_back();
+    }
+
+    static const V & _neighbor(const E & e, const V & cur) {
+      return static_cast<const V &>(&e.dest() == &cur ? e.source() : e.dest());
+    }
+};
+
+/**
+* @return The vertices reachable from `start`, in breadth-first order
+* @throws std::out_of_range if there is no Vertex `start`
+*/
+template <class V, class E>
+BfsOrder<V,E> Graph<V,E>::bfsOrder(const std::string & start) const
+{
+  return BfsOrder<V,E>(*this, vertexMap.at(start));
+}
+
+/**
+* @return The vertices reachable from `start`, in depth-first preorder
+* @throws std::out_of_range if there is no Vertex `start`
+*/
+template <class V, class E>
+DfsOrder<V,E> Graph<V,E>::dfsOrder(const std::string & start) const
+{
+  return DfsOrder<V,E>(*this, vertexMap.at(start));
+}
+
+/**
+* @return The simple paths from `start` to `end` with at most `maxLength` edges
+* @throws std::out_of_range if there is no Vertex `start` or `end`
+*/
+template <class V, class E>
+PathsBetween<V,E> Graph<V,E>::pathsBetween(const std::string & start, const std::string & end, unsigned int maxLength) const
+{
+  return PathsBetween<V,E>(*this, vertexMap.at(start), vertexMap.at(end), maxLength);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * A fixed-capacity cache that evicts the least recently used entry.
+ * Lookups and insertions are O(1).
+ */
+template <class K, class V>
+class LRUCache {
+  public:
+    LRUCache(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) { }
+
+    /**
+     * @return A pointer to the cached value for `key` (marking it most
+     * recently used), or nullptr if `key` is not cached.  The pointer is
+     * valid until the next call to `put`.
+     */
+    V * get(const K & key) {
+      auto it = index_.find(key);
+      if (it == index_.end()) { return nullptr; }
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return &it->second->second;
+    }
+
+    /**
+     * Caches `value` for `key`, evicting the least recently used entry if full.
+     * @return A reference to the cached value.
+     */
+    V & put(const K & key, V value) {
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        it->second->second = std::move(value);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+      }
+
+      if (entries_.size() >= capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+
+      entries_.emplace_front(key, std::move(value));
+      index_[key] = entries_.begin();
+      return entries_.front().second;
+    }
+
+    size_t size() const { return entries_.size(); }
+    size_t capacity() const { return capacity_; }
+
+    void clear() {
+      entries_.clear();
+      index_.clear();
+    }
+
+  private:
+    typedef std::list<std::pair<K, V>> EntryList;
+
+    size_t capacity_;
+    EntryList entries_;
+    std::unordered_map<K, typename EntryList::iterator> index_;
+};
@@ -0,0 +1,30 @@
+#include "LazyContentStore.h"
+#include "Trace.h"
+
+#include <fstream>
+#include <stdexcept>
+
+std::string LazyContentStore::_read(uint32_t textId, const TextRef & ref) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string * cached = cache_.get(textId);
+    if (cached != nullptr) { return *cached; }
+  }
+
+  // Read without holding the lock, so readers of other texts are not held
+  // up by the disk:
+  TRACE_SPAN("LazyContentStore::_read", "io");
+  const std::string file = dir_ + _key(ref.file) + ".md";
+  std::string raw(ref.length, '\0');
+  std::ifstream input(file, std::ios::binary);
+  input.seekg(ref.offset);
+  input.read(&raw[0], ref.length);
+  if (!input || (size_t) input.gcount() != ref.length) {
+    throw std::runtime_error("LazyContentStore: unable to read " + std::to_string(ref.length) + " bytes at offset " +
+                             std::to_string(ref.offset) + " of " + file + " (was it changed after load?)");
+  }
+
+  std::string text = normalize(raw);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.put(textId, std::move(text));
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ContentStore.h"
+#include "LRUCache.h"
+
+#include <string>
+#include <mutex>
+
+/**
+ * A ContentStore that leaves story text in the story files.
+ *
+ * Each TextRef is a byte range of `<dir>/<key>.md`, where `file` is the
+ * passage id of `key`.  Text is read from disk the first time it is
+ * requested and kept in a small LRU cache.  Reading is thread-safe; a
+ * file that no longer holds the loaded range throws std::runtime_error.
+ */
+class LazyContentStore : public ContentStore {
+  public:
+    /**
+     * @param dir The story directory, including the trailing `/`.
+     * @param cacheCapacity The number of texts kept in memory.
+     */
+    LazyContentStore(const std::string & dir, size_t cacheCapacity = 256) : dir_(dir), cache_(cacheCapacity) { }
+
+  protected:
+    std::string _read(uint32_t textId, const TextRef & ref);
+
+  private:
+    std::string dir_;
+    std::mutex mutex_;   /*< Guards `cache_` */
+    LRUCache<uint32_t, std::string> cache_;
+};
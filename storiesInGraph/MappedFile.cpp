@@ -0,0 +1,43 @@
+#include "MappedFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool MappedFile::open(const std::string & path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) { return false; }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  // mmap(2) rejects zero-length mappings; an empty file is just an empty view:
+  if (st.st_size > 0) {
+    void * addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      ::close(fd);
+      return false;
+    }
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+    data_ = static_cast<const char *>(addr);
+    size_ = st.st_size;
+  }
+
+  // The mapping keeps its own reference to the file:
+  ::close(fd);
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
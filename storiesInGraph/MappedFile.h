@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * A read-only view of an entire file, mapped into memory with mmap(2).
+ *
+ * The file is read by the kernel on demand instead of being copied through
+ * a stream buffer, and the contents are exposed as one `std::string_view`
+ * that stays valid for the lifetime of the MappedFile.
+ */
+class MappedFile {
+  public:
+    MappedFile() : data_(nullptr), size_(0) { }
+    MappedFile(const std::string & path) : data_(nullptr), size_(0) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile & other) = delete;
+    MappedFile & operator=(const MappedFile & other) = delete;
+
+    /**
+     * Maps the file at `path`, replacing any previously mapped file.
+     * @return true, if the file was opened (an empty file is a valid, empty view).
+     */
+    bool open(const std::string & path);
+
+    /**
+     * Unmaps the current file, if any.
+     */
+    void close();
+
+    /**
+     * @return The contents of the mapped file.
+     */
+    std::string_view data() const { return std::string_view(data_, size_); }
+
+  private:
+    const char * data_;
+    size_t size_;
+};
@@ -0,0 +1,144 @@
+#include "PageRank.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+PageRank::PageRank(const CsrGraph & g, PageRankOptions options) : options_(options), in_(g.transpose()) {
+  uint32_t n = g.numVertices();
+  inverseDegree_.resize(n);
+  for (uint32_t v = 0; v < n; v++) {
+    inverseDegree_[v] = (g.degree(v) > 0) ? 1.0 / g.degree(v) : 0;
+    if (g.degree(v) == 0) { dangling_.push_back(v); }
+  }
+
+  // Slices with equal work: each vertex costs its in-edges, plus one:
+  unsigned int threads = options_.threads;
+  if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+  threads = std::max(1u, std::min<unsigned int>(threads, n));
+  double work = double(g.numEdges()) + n;
+  slices_.push_back(0);
+  size_t done = 0;
+  for (uint32_t v = 0; v < n; v++) {
+    done += in_.degree(v) + 1;
+    if (slices_.size() < threads && done >= work * slices_.size() / threads) { slices_.push_back(v + 1); }
+  }
+  while (slices_.size() <= threads) { slices_.push_back(n); }
+}
+
+PageRank::Result PageRank::rank() const {
+  uint32_t n = in_.numVertices();
+  return _solve(std::vector<double>(n, n > 0 ? 1.0 / n : 0));
+}
+
+PageRank::Result PageRank::personalized(const std::vector<uint32_t> & sources) const {
+  if (sources.empty()) { throw std::invalid_argument("personalized PageRank needs a source"); }
+  std::vector<double> teleport(in_.numVertices(), 0);
+  for (uint32_t v : sources) { teleport.at(v) += 1.0 / sources.size(); }
+  return _solve(teleport);
+}
+
+/**
+* Blocks each of `count` threads until all of them have arrived; the last
+* to arrive runs `step` before releasing the others
+*/
+class PageRank::Barrier {
+  public:
+    explicit Barrier(unsigned int count) : count_(count), waiting_(0), generation_(0) { }
+
+    template <class F>
+    void arriveAndWait(F step) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      uint64_t generation = generation_;
+      if (++waiting_ == count_) {
+        step();
+        waiting_ = 0;
+        generation_++;
+        released_.notify_all();
+      } else {
+        released_.wait(lock, [&]() { return generation_ != generation; });
+      }
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable released_;
+    unsigned int count_;
+    unsigned int waiting_;
+    uint64_t generation_;
+};
+
+/**
+* Power iteration: each step moves `damping` of every rank along the edges
+* and the rest (with the rank of vertices without edges out) to `teleport`
+*/
+PageRank::Result PageRank::_solve(const std::vector<double> & teleport) const {
+  TRACE_SPAN("PageRank", "traverse");
+  uint32_t n = in_.numVertices();
+  unsigned int threads = slices_.size() - 1;
+  const double damping = options_.damping;
+
+  Result result;
+  result.ranks = teleport;
+  std::vector<double> next(n);
+  std::vector<double> share(n);   /*< What each vertex passes along each of its edges */
+  std::vector<double> nextShare(n);
+  std::vector<double> changes(threads);
+
+  for (uint32_t v = 0; v < n; v++) { share[v] = result.ranks[v] * inverseDegree_[v]; }
+
+  auto jumpFrom = [&](const std::vector<double> & ranks) {
+    double danglingRank = 0;
+    for (uint32_t v : dangling_) { danglingRank += ranks[v]; }
+    return 1 - damping + damping * danglingRank;
+  };
+  double jump = jumpFrom(result.ranks);
+  bool done = (options_.maxIterations == 0);
+
+  // Run by the last thread to finish an iteration, while the others wait.
+  // The rank of the dangling vertices is summed here, in one order, so it
+  // does not depend on the slices:
+  auto finishIteration = [&]() {
+    result.ranks.swap(next);
+    share.swap(nextShare);
+    result.iterations++;
+    result.change = 0;
+    for (double change : changes) { result.change += change; }
+    jump = jumpFrom(result.ranks);
+    done = (result.change < options_.tolerance || result.iterations >= options_.maxIterations);
+  };
+
+  Barrier barrier(threads);
+  auto iterate = [&](unsigned int t) {
+    while (!done) {
+      double change = 0;
+      for (uint32_t v = slices_[t]; v < slices_[t + 1]; v++) {
+        CsrGraph::Range from = in_.neighbors(v);
+        const uint32_t * u = from.begin();
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (; u + 4 <= from.end(); u += 4) {
+          s0 += share[u[0]];
+          s1 += share[u[1]];
+          s2 += share[u[2]];
+          s3 += share[u[3]];
+        }
+        for (; u != from.end(); ++u) { s0 += share[*u]; }
+        next[v] = damping * ((s0 + s1) + (s2 + s3)) + jump * teleport[v];
+        nextShare[v] = next[v] * inverseDegree_[v];
+        change += std::abs(next[v] - result.ranks[v]);
+      }
+      changes[t] = change;
+      barrier.arriveAndWait(finishIteration);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 1; t < threads; t++) { workers.push_back(std::thread(iterate, t)); }
+  iterate(0);
+  for (std::thread & worker : workers) { worker.join(); }
+  return result;
+}
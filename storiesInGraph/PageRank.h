@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CsrGraph.h"
+
+class PageRankOptions {
+  public:
+    double damping = 0.85;            /*< The probability of following an edge rather than teleporting */
+    double tolerance = 1e-10;         /*< Stop once an iteration changes the ranks by less than this (L1) */
+    unsigned int maxIterations = 100;
+    unsigned int threads = 0;         /*< 0: one per hardware thread */
+};
+
+/**
+ * PageRank, and personalized PageRank, of the vertices of a directed
+ * graph: the share of time a reader spends at each vertex who follows a
+ * random edge with probability `damping`, and otherwise (or at a vertex
+ * with no edges out) jumps to a random vertex, or for personalized
+ * PageRank, to one of the given sources.
+ *
+ * Ranks are found by power iteration over the transposed graph, pulling
+ * each vertex's new rank from its in-neighbors, so every thread writes
+ * only its own slice of the ranks and no atomics are needed.  The threads
+ * are started once per solve, get slices with equal numbers of in-edges,
+ * and meet at a barrier after each iteration.  Each sums its in-neighbors
+ * into four independent accumulators, so consecutive floating-point
+ * additions do not wait on each other.  A vertex's rank is summed in the
+ * same order whatever the number of threads, so the ranks do not depend
+ * on it.
+ */
+class PageRank {
+  public:
+    class Result {
+      public:
+        std::vector<double> ranks;    /*< By vertex, summing to 1 */
+        unsigned int iterations = 0;
+        double change = 0;            /*< By the last iteration (L1) */
+    };
+
+    explicit PageRank(const CsrGraph & g, PageRankOptions options = PageRankOptions());
+
+    Result rank() const;
+
+    /**
+     * @return The PageRank with every jump going to one of `sources`, which
+     * ranks vertices by their importance to readers starting there.
+     * @throws std::invalid_argument if there are no sources.
+     */
+    Result personalized(const std::vector<uint32_t> & sources) const;
+
+  private:
+    class Barrier;
+
+    PageRankOptions options_;
+    CsrGraph in_;                          /*< The in-neighbors of each vertex */
+    std::vector<double> inverseDegree_;    /*< 1 / out-degree, or 0 for a vertex with no edges out */
+    std::vector<uint32_t> dangling_;       /*< The vertices with no edges out */
+    std::vector<uint32_t> slices_;         /*< Thread t ranks the vertices [slices_[t], slices_[t+1]) */
+
+    Result _solve(const std::vector<double> & teleport) const;
+};
@@ -0,0 +1,104 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+const char * PerfCounters::name(Event event) {
+  static const char * names[] = { "cycles", "instructions", "cacheMisses", "branchMisses", "dtlbMisses" };
+  return names[event];
+}
+
+#ifdef __linux__
+
+static int openEvent(uint32_t type, uint64_t config) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  // This thread, on any CPU:
+  return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+PerfCounters::PerfCounters() {
+  fds_[CYCLES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  fds_[INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  fds_[CACHE_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  fds_[BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+  fds_[DTLB_MISSES] = openEvent(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+    (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+}
+
+PerfCounters::~PerfCounters() {
+  for (int e = 0; e < NUM_EVENTS; e++) {
+    if (fds_[e] >= 0) { close(fds_[e]); }
+  }
+}
+
+void PerfCounters::start() {
+  for (int e = 0; e < NUM_EVENTS; e++) {
+    if (fds_[e] < 0) { continue; }
+    ioctl(fds_[e], PERF_EVENT_IOC_RESET, 0);
+    ioctl(fds_[e], PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+PerfCounters::Reading PerfCounters::stop() {
+  for (int e = 0; e < NUM_EVENTS; e++) {
+    if (fds_[e] >= 0) { ioctl(fds_[e], PERF_EVENT_IOC_DISABLE, 0); }
+  }
+
+  Reading reading;
+  for (int e = 0; e < NUM_EVENTS; e++) {
+    // { value, time enabled, time running }:
+    uint64_t data[3];
+    if (fds_[e] < 0 || read(fds_[e], data, sizeof(data)) != sizeof(data)) { continue; }
+
+    reading.available[e] = true;
+    reading.values[e] = data[0];
+    if (data[2] > 0 && data[2] < data[1]) {
+      reading.values[e] = (uint64_t) (data[0] * ((double) data[1] / data[2]));
+    }
+  }
+  return reading;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+  for (int e = 0; e < NUM_EVENTS; e++) { fds_[e] = -1; }
+}
+
+PerfCounters::~PerfCounters() { }
+void PerfCounters::start() { }
+PerfCounters::Reading PerfCounters::stop() { return Reading(); }
+
+#endif
+
+bool PerfCounters::available() const {
+  for (int e = 0; e < NUM_EVENTS; e++) {
+    if (fds_[e] >= 0) { return true; }
+  }
+  return false;
+}
+
+std::ostream & operator<<(std::ostream & out, const PerfCounters::Reading & reading) {
+  bool first = true;
+  for (int e = 0; e < PerfCounters::NUM_EVENTS; e++) {
+    if (!reading.available[e]) { continue; }
+    out << (first ? "" : " ") << PerfCounters::name((PerfCounters::Event) e) << "=" << reading.values[e];
+    first = false;
+  }
+  if (first) { out << "(no performance counters available)"; }
+  return out;
+}
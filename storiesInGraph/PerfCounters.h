@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+/**
+ * Hardware performance counters of the calling thread, read through Linux
+ * perf_event_open(2).
+ *
+ * Counters that the CPU, kernel or `perf_event_paranoid` setting do not
+ * allow are reported as unavailable rather than failing; on other systems
+ * every counter is unavailable.  Only user-space events are counted.
+ */
+class PerfCounters {
+  public:
+    enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, DTLB_MISSES, NUM_EVENTS };
+
+    /**
+     * Counter values for one measured region.
+     */
+    class Reading {
+      public:
+        uint64_t values[NUM_EVENTS] = { };
+        bool available[NUM_EVENTS] = { };
+
+        /**
+         * @return The value of `event`, or 0 if it could not be counted.
+         */
+        uint64_t get(Event event) const { return available[event] ? values[event] : 0; }
+
+        /**
+         * Prints every available counter as `name=value`.
+         */
+        friend std::ostream & operator<<(std::ostream & out, const Reading & reading);
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters & other) = delete;
+    PerfCounters & operator=(const PerfCounters & other) = delete;
+
+    /**
+     * @return true, if at least one counter could be opened.
+     */
+    bool available() const;
+
+    /**
+     * Resets and starts every counter.
+     */
+    void start();
+
+    /**
+     * Stops every counter.
+     * @return The counts since `start()`, scaled up if the kernel had to
+     * multiplex the counters.
+     */
+    Reading stop();
+
+    static const char * name(Event event);
+
+  private:
+    int fds_[NUM_EVENTS];
+};
+
+
+/**
+ * Counts the events of the enclosing scope into `out`:
+ *
+ *   PerfCounters::Reading reading;
+ *   {
+ *     PerfScope scope(reading);
+ *     g.shortestPath("a", "b");
+ *   }
+ *
+ * The counters are opened before, and closed after, the measured region.
+ */
+class PerfScope {
+  public:
+    PerfScope(PerfCounters::Reading & out) : out_(out) { counters_.start(); }
+    ~PerfScope() { out_ = counters_.stop(); }
+
+    PerfScope(const PerfScope & other) = delete;
+    PerfScope & operator=(const PerfScope & other) = delete;
+
+  private:
+    PerfCounters::Reading & out_;
+    PerfCounters counters_;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Graph.h"
+#include "Edge.h"
+#include "Vertex.h"
+#include "GraphLog.h"
+
+class PersistentGraphOptions {
+  public:
+    bool durable = true;                    /*< Sync the log before a mutation returns */
+    uint64_t compactBytes = 16 << 20;       /*< Compact once the log is this large */
+    bool backgroundCompaction = true;       /*< Compact on a background thread */
+};
+
+/**
+ * A Graph stored in a directory, which survives restarts.
+ *
+ * The directory holds a `snapshot` of the graph and the mutation logs
+ * (`log.<n>`) written since.  Every mutation is checked against the
+ * in-memory Graph, appended to the current log and only then applied; with
+ * `durable` options it returns only once the log is synced, and concurrent
+ * mutations share that sync (see GraphLog).  Opening the directory maps the
+ * snapshot, replays the logs after it, and drops a torn record at the end
+ * of the last log.
+ *
+ * Once a write of the log fails, every later mutation throws before it
+ * changes the graph.  The mutations of the failed write itself may already
+ * be in `graph()`; reopening the directory shows what reached the disk.
+ *
+ * Compaction clones the graph and starts a new log while holding the lock,
+ * then writes the clone as the new snapshot without it, so mutations only
+ * wait for the clone.  It runs whenever the log grows past `compactBytes`;
+ * a failed background compaction is retried with a growing delay and
+ * reported by `sync()` until one succeeds.
+ *
+ * Mutations are thread-safe.  `graph()` may be read while no mutation is
+ * running; use the mutation functions, not the Graph, to change it.
+ */
+template <class V = Vertex, class E = Edge>
+class PersistentGraph {
+  public:
+    /**
+     * Opens the graph stored in `dir`, creating the directory if needed.
+     * @throws std::runtime_error if the directory or its log cannot be
+     * opened, or its snapshot is corrupt.
+     */
+    PersistentGraph(const std::string & dir, PersistentGraphOptions options = PersistentGraphOptions());
+    ~PersistentGraph();
+
+    PersistentGraph(const PersistentGraph & other) = delete;
+    PersistentGraph & operator=(const PersistentGraph & other) = delete;
+
+    const Graph<V,E> & graph() const { return graph_; }
+
+    // Mutations; each throws std::out_of_range for a missing vertex or edge
+    // (and then logs nothing), or std::runtime_error if the log cannot be
+    // (or could not earlier be) written:
+    const V & insertVertex(const std::string & key);
+    void removeVertex(const std::string & key);
+    const E & insertEdge(const std::string & key1, const std::string & key2);
+    void removeEdge(const std::string & key1, const std::string & key2);
+    void setVertexProperty(const std::string & key, const std::string & name, const std::string & value);
+    void setEdgeProperty(const std::string & key1, const std::string & key2, const std::string & name, const std::string & value);
+
+    /**
+     * Writes every mutation so far to the log (and syncs it, if durable).
+     * @throws std::runtime_error if the log cannot be written, or the last
+     * background compaction failed.
+     */
+    void sync();
+
+    /**
+     * Replaces the snapshot with the current graph and deletes the logs it
+     * covers.
+     * @throws std::runtime_error if the snapshot or new log cannot be written.
+     */
+    void compact();
+
+    /**
+     * @return The size of the current log.
+     */
+    uint64_t logBytes() const { return log_.bytes(); }
+
+  private:
+    // The snapshot starts with MAGIC and the id of the first log it does
+    // not cover (8 bytes, little-endian), followed by GraphLog records:
+    static constexpr char MAGIC[] = "CYOAGRPH";
+    static constexpr size_t HEADER_SIZE = 16;
+    // Without `durable`, records are written once this many are buffered:
+    static constexpr uint64_t BUFFER_BYTES = 1 << 16;
+    // Delay before retrying a failed background compaction, doubled after
+    // each failure up to the maximum:
+    static constexpr std::chrono::milliseconds MIN_RETRY_DELAY{50};
+    static constexpr std::chrono::milliseconds MAX_RETRY_DELAY{5000};
+
+    std::string dir_;
+    PersistentGraphOptions options_;
+    Graph<V,E> graph_;
+    GraphLog log_;
+    uint64_t logId_;           /*< The current log is `log.<logId_>` */
+
+    std::mutex mutex_;         /*< Guards `graph_` and `logId_` */
+    std::mutex compactMutex_;  /*< Held by the running compaction */
+    std::condition_variable compactNeeded_;
+    bool stopping_;
+    std::string compactError_; /*< Why the last background compaction failed, or empty */
+    std::thread compactor_;
+
+    void _recover();
+    void _check(const GraphLog::Record & record);
+    void _apply(const GraphLog::Record & record);
+    uint64_t _append(const GraphLog::Record & record);
+    void _commit(uint64_t seq, std::unique_lock<std::mutex> & lock);
+    E * _findEdge(const std::string & key1, const std::string & key2);
+    std::vector<uint64_t> _logIds() const;
+    void _compactionLoop();
+    std::string _logPath(uint64_t id) const { return dir_ + "log." + std::to_string(id); }
+    std::string _snapshotPath() const { return dir_ + "snapshot"; }
+};
+
+#include "PersistentGraph.hpp"
@@ -0,0 +1,372 @@
+#include "PersistentGraph.h"
+#include "MappedFile.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+template <class V, class E>
+PersistentGraph<V,E>::PersistentGraph(const std::string & dir, PersistentGraphOptions options) :
+  dir_(dir), options_(options), logId_(0), stopping_(false)
+{
+  if (dir_.empty() || dir_.back() != '/') { dir_ += "/"; }
+  mkdir(dir_.c_str(), 0755);
+  _recover();
+
+  if (options_.backgroundCompaction) {
+    compactor_ = std::thread(&PersistentGraph::_compactionLoop, this);
+  }
+}
+
+template <class V, class E>
+PersistentGraph<V,E>::~PersistentGraph()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  compactNeeded_.notify_all();
+  if (compactor_.joinable()) { compactor_.join(); }
+  log_.close();
+}
+
+/**
+* Inserts a Vertex, or returns the existing Vertex with the same key
+*/
+template <class V, class E>
+const V & PersistentGraph<V,E>::insertVertex(const std::string & key)
+{
+  GraphLog::Record record{ GraphLog::INSERT_VERTEX, key, "", "", "" };
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = graph_.vertexMap.find(key);
+  if (it != graph_.vertexMap.end()) { return it->second; }
+  uint64_t seq = _append(record);
+  const V & v = graph_.vertexMap.at(key);
+  _commit(seq, lock);
+  return v;
+}
+
+template <class V, class E>
+void PersistentGraph<V,E>::removeVertex(const std::string & key)
+{
+  GraphLog::Record record{ GraphLog::REMOVE_VERTEX, key, "", "", "" };
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t seq = _append(record);
+  _commit(seq, lock);
+}
+
+template <class V, class E>
+const E & PersistentGraph<V,E>::insertEdge(const std::string & key1, const std::string & key2)
+{
+  GraphLog::Record record{ GraphLog::INSERT_EDGE, key1, key2, "", "" };
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t seq = _append(record);
+  const E & e = graph_.edgeList.front();
+  _commit(seq, lock);
+  return e;
+}
+
+/**
+* Removes the Edge from `key1` to `key2`, if there is one (like Graph::removeEdge)
+*/
+template <class V, class E>
+void PersistentGraph<V,E>::removeEdge(const std::string & key1, const std::string & key2)
+{
+  GraphLog::Record record{ GraphLog::REMOVE_EDGE, key1, key2, "", "" };
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (_findEdge(key1, key2) == nullptr) { return; }
+  uint64_t seq = _append(record);
+  _commit(seq, lock);
+}
+
+template <class V, class E>
+void PersistentGraph<V,E>::setVertexProperty(const std::string & key, const std::string & name, const std::string & value)
+{
+  GraphLog::Record record{ GraphLog::SET_VERTEX_PROPERTY, key, "", name, value };
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t seq = _append(record);
+  _commit(seq, lock);
+}
+
+template <class V, class E>
+void PersistentGraph<V,E>::setEdgeProperty(const std::string & key1, const std::string & key2, const std::string & name, const std::string & value)
+{
+  GraphLog::Record record{ GraphLog::SET_EDGE_PROPERTY, key1, key2, name, value };
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t seq = _append(record);
+  _commit(seq, lock);
+}
+
+template <class V, class E>
+void PersistentGraph<V,E>::sync()
+{
+  if (!log_.flush(UINT64_MAX)) { throw std::runtime_error("Cannot write " + dir_ + " log"); }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!compactError_.empty()) { throw std::runtime_error("Cannot compact " + dir_ + ": " + compactError_); }
+}
+
+template <class V, class E>
+void PersistentGraph<V,E>::compact()
+{
+  TRACE_SPAN("PersistentGraph::compact", "io");
+  std::lock_guard<std::mutex> compacting(compactMutex_);
+
+  // Only the clone and the log rotation block mutations:
+  Graph<V,E> copy;
+  uint64_t nextLog;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    copy = graph_.clone();
+    nextLog = logId_ + 1;
+    if (!log_.rotate(_logPath(nextLog))) { throw std::runtime_error("Cannot start " + _logPath(nextLog)); }
+    logId_ = nextLog;
+  }
+
+  std::string data(MAGIC, 8);
+  for (int i = 0; i < 8; i++) { data.push_back((char) ((nextLog >> (8 * i)) & 0xff)); }
+
+  for (const auto & pair : copy.vertexMap) {
+    const V & v = pair.second;
+    GraphLog::encode(GraphLog::Record{ GraphLog::INSERT_VERTEX, pair.first, "", "", "" }, data);
+    for (const auto & property : v.properties()) {
+      GraphLog::encode(GraphLog::Record{ GraphLog::SET_VERTEX_PROPERTY, pair.first, "", property.first, property.second }, data);
+    }
+  }
+  // Oldest edges first, so the reloaded adjacency lists keep their order:
+  for (auto it = copy.edgeList.rbegin(); it != copy.edgeList.rend(); ++it) {
+    const E & e = *it;
+    std::string source = e.source().key(), dest = e.dest().key();
+    GraphLog::encode(GraphLog::Record{ GraphLog::INSERT_EDGE, source, dest, "", "" }, data);
+    for (const auto & property : e.properties()) {
+      GraphLog::encode(GraphLog::Record{ GraphLog::SET_EDGE_PROPERTY, source, dest, property.first, property.second }, data);
+    }
+  }
+
+  if (!GraphLog::replaceFile(_snapshotPath(), data)) { throw std::runtime_error("Cannot write " + _snapshotPath()); }
+  for (uint64_t id : _logIds()) {
+    if (id < nextLog) { std::remove(_logPath(id).c_str()); }
+  }
+}
+
+/**
+* Loads the snapshot and replays the logs after it, truncating torn records
+* off the end of each log
+*/
+template <class V, class E>
+void PersistentGraph<V,E>::_recover()
+{
+  TRACE_SPAN("PersistentGraph::_recover", "io");
+  std::remove((_snapshotPath() + ".tmp").c_str());
+
+  uint64_t firstLog = 0;
+  MappedFile snapshot;
+  if (snapshot.open(_snapshotPath())) {
+    std::string_view data = snapshot.data();
+    if (data.size() < HEADER_SIZE || data.substr(0, 8) != std::string_view(MAGIC, 8)) {
+      throw std::runtime_error(_snapshotPath() + " is not a graph snapshot");
+    }
+    for (int i = 0; i < 8; i++) { firstLog |= (uint64_t) (unsigned char) data[8 + i] << (8 * i); }
+    // The snapshot is replaced atomically, so unlike a log it is never torn:
+    std::string_view records = data.substr(HEADER_SIZE);
+    size_t intact = GraphLog::decode(records, [&](const GraphLog::Record & record) { _apply(record); });
+    if (intact < records.size()) { throw std::runtime_error(_snapshotPath() + " is corrupt"); }
+    snapshot.close();
+  }
+
+  logId_ = firstLog;
+  for (uint64_t id : _logIds()) {
+    std::string path = _logPath(id);
+    if (id < firstLog) {
+      // Left behind by a compaction that stopped after writing the snapshot:
+      std::remove(path.c_str());
+      continue;
+    }
+
+    MappedFile log;
+    if (!log.open(path)) { throw std::runtime_error("Cannot read " + path); }
+    size_t size = log.data().size();
+    size_t intact = GraphLog::decode(log.data(), [&](const GraphLog::Record & record) { _apply(record); });
+    log.close();
+    if (intact < size && truncate(path.c_str(), intact) != 0) { throw std::runtime_error("Cannot truncate " + path); }
+    logId_ = id;
+  }
+
+  if (!log_.open(_logPath(logId_), options_.durable)) { throw std::runtime_error("Cannot open " + _logPath(logId_)); }
+}
+
+/**
+* Checks that `record` can be applied to `graph_`, without changing it
+* @throws std::out_of_range if its vertex or edge does not exist
+*/
+template <class V, class E>
+void PersistentGraph<V,E>::_check(const GraphLog::Record & record)
+{
+  auto requireVertex = [&](const std::string & key) {
+    if (graph_.vertexMap.find(key) == graph_.vertexMap.end()) { throw std::out_of_range("No vertex " + key); }
+  };
+
+  switch (record.op) {
+    case GraphLog::INSERT_VERTEX:
+      break;
+    case GraphLog::INSERT_EDGE:
+      requireVertex(record.key1);
+      requireVertex(record.key2);
+      break;
+    case GraphLog::REMOVE_VERTEX:
+    case GraphLog::SET_VERTEX_PROPERTY:
+      requireVertex(record.key1);
+      break;
+    case GraphLog::REMOVE_EDGE:
+    case GraphLog::SET_EDGE_PROPERTY:
+      if (_findEdge(record.key1, record.key2) == nullptr) {
+        throw std::out_of_range("No edge from " + record.key1 + " to " + record.key2);
+      }
+      break;
+  }
+}
+
+/**
+* Applies one mutation to `graph_`
+* @throws std::out_of_range if its vertex or edge does not exist
+*/
+template <class V, class E>
+void PersistentGraph<V,E>::_apply(const GraphLog::Record & record)
+{
+  switch (record.op) {
+    case GraphLog::INSERT_VERTEX:
+      graph_.insertVertex(record.key1);
+      break;
+    case GraphLog::REMOVE_VERTEX:
+      graph_.removeVertex(record.key1);
+      break;
+    case GraphLog::INSERT_EDGE:
+      graph_.insertEdge(record.key1, record.key2);
+      break;
+    case GraphLog::REMOVE_EDGE:
+      graph_.removeEdge(record.key1, record.key2);
+      break;
+    case GraphLog::SET_VERTEX_PROPERTY:
+      graph_.vertexMap.at(record.key1).get()[record.name] = record.value;
+      break;
+    case GraphLog::SET_EDGE_PROPERTY: {
+      E * e = _findEdge(record.key1, record.key2);
+      if (e == nullptr) { throw std::out_of_range("No edge from " + record.key1 + " to " + record.key2); }
+      (*e)[record.name] = record.value;
+      break;
+    }
+  }
+}
+
+/**
+* Checks a mutation, appends it to the log and applies it, while holding `mutex_`
+* @return The sequence number of its log record, to `_commit`
+* @throws std::out_of_range (before logging) if the mutation is invalid
+* @throws std::runtime_error (before applying it) if the log has failed
+*/
+template <class V, class E>
+uint64_t PersistentGraph<V,E>::_append(const GraphLog::Record & record)
+{
+  _check(record);
+  if (log_.failed()) { throw std::runtime_error("Cannot write " + dir_ + " log"); }
+  uint64_t seq = log_.append(record);
+  _apply(record);
+  return seq;
+}
+
+/**
+* Releases `lock`, then waits for the log up to record `seq` as the options
+* require, and starts a compaction if the log is large enough
+*/
+template <class V, class E>
+void PersistentGraph<V,E>::_commit(uint64_t seq, std::unique_lock<std::mutex> & lock)
+{
+  bool compact = (log_.bytes() >= options_.compactBytes);
+  lock.unlock();
+
+  if (options_.durable || log_.pendingBytes() >= BUFFER_BYTES) {
+    if (!log_.flush(seq)) { throw std::runtime_error("Cannot write " + dir_ + " log"); }
+  }
+  if (compact) {
+    if (options_.backgroundCompaction) { compactNeeded_.notify_one(); }
+    else                               { this->compact(); }
+  }
+}
+
+/**
+* @return The most recently inserted Edge from `key1` to `key2` (the one
+* Graph::removeEdge removes), or nullptr
+* @throws std::out_of_range if there is no Vertex `key1`
+*/
+template <class V, class E>
+E * PersistentGraph<V,E>::_findEdge(const std::string & key1, const std::string & key2)
+{
+  for (const auto & it : graph_.adjList.at(key1)) {
+    E & e = *it;
+    if (e.source().key() == key1 && e.dest().key() == key2) { return &e; }
+  }
+  return nullptr;
+}
+
+/**
+* @return The ids of the `log.<n>` files in the directory, in increasing order
+*/
+template <class V, class E>
+std::vector<uint64_t> PersistentGraph<V,E>::_logIds() const
+{
+  std::vector<uint64_t> ids;
+  DIR * dir = opendir(dir_.c_str());
+  if (dir == nullptr) { return ids; }
+
+  struct dirent * ent;
+  while ((ent = readdir(dir)) != nullptr) {
+    std::string name = ent->d_name;
+    if (name.size() <= 4 || name.compare(0, 4, "log.") != 0) { continue; }
+    if (name.find_first_not_of("0123456789", 4) != std::string::npos) { continue; }
+    ids.push_back(std::stoull(name.substr(4)));
+  }
+  closedir(dir);
+
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+/**
+* Compacts whenever the log grows past `compactBytes`, until `stopping_`.  A
+* failure is kept in `compactError_` and retried after a growing delay.
+*/
+template <class V, class E>
+void PersistentGraph<V,E>::_compactionLoop()
+{
+  std::chrono::milliseconds delay(0);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (delay.count() > 0) { compactNeeded_.wait_for(lock, delay, [&]() { return stopping_; }); }
+    // A failed compaction may have started a new log already, so it is
+    // retried however large the log is:
+    compactNeeded_.wait(lock, [&]() {
+      return stopping_ || !compactError_.empty() || log_.bytes() >= options_.compactBytes;
+    });
+    if (stopping_) { return; }
+
+    lock.unlock();
+    std::string error;
+    try {
+      compact();
+    } catch (const std::exception & e) {
+      error = e.what();
+    }
+    lock.lock();
+
+    compactError_ = error;
+    if (error.empty()) { delay = std::chrono::milliseconds(0); }
+    else               { delay = std::min(std::max(delay * 2, MIN_RETRY_DELAY), MAX_RETRY_DELAY); }
+  }
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * A hash map whose copies share structure (a hash array mapped trie).
+ *
+ * Entries live in a 32-way trie indexed five bits of the key's hash at a
+ * time.  Nodes are immutable and shared between copies: copying a map is
+ * O(1), and `set` or `erase` copies only the O(log n) nodes on the path to
+ * the entry, leaving every other copy unchanged.
+ */
+template <class K, class T, class Hash = std::hash<K>>
+class PersistentHashMap {
+  public:
+    PersistentHashMap() : size_(0) { }
+
+    /**
+     * @return A pointer to the value for `key`, or nullptr if `key` is not
+     * in the map.  The pointer is valid until this map is changed.
+     */
+    const T * find(const K & key) const {
+      size_t hash = Hash()(key);
+      const Node * node = root_.get();
+      for (unsigned int shift = 0; node != nullptr; shift += BITS) {
+        if (node->children.empty()) {
+          for (const Entry & entry : node->entries) {
+            if (entry.hash == hash && entry.key == key) { return &entry.value; }
+          }
+          return nullptr;
+        }
+        node = node->children[_index(hash, shift)].get();
+      }
+      return nullptr;
+    }
+
+    /**
+     * Sets the value for `key`, adding `key` if it is not in the map.
+     */
+    void set(const K & key, T value) {
+      bool added = false;
+      root_ = _set(root_, Hash()(key), 0, key, std::move(value), added);
+      if (added) { size_++; }
+    }
+
+    /**
+     * Removes `key` from the map.
+     * @return true, if `key` was in the map.
+     */
+    bool erase(const K & key) {
+      if (find(key) == nullptr) { return false; }
+      root_ = _erase(root_, Hash()(key), 0, key);
+      size_--;
+      return true;
+    }
+
+    size_t size() const { return size_; }
+
+    /**
+     * Calls `visit(key, value)` for every entry, in no particular order.
+     */
+    template <class F>
+    void forEach(F visit) const { _forEach(root_.get(), visit); }
+
+  private:
+    static constexpr unsigned int BITS = 5;
+    static constexpr unsigned int WIDTH = 1 << BITS;
+    // A leaf splits into a branch when it holds more entries than this:
+    static constexpr size_t LEAF_CAPACITY = 8;
+
+    class Entry {
+      public:
+        size_t hash;
+        K key;
+        T value;
+    };
+
+    // A branch has WIDTH children (some null); a leaf has none, only entries:
+    class Node {
+      public:
+        std::vector<std::shared_ptr<const Node>> children;
+        std::vector<Entry> entries;
+    };
+    typedef std::shared_ptr<const Node> NodePtr;
+
+    NodePtr root_;
+    size_t size_;
+
+    static unsigned int _index(size_t hash, unsigned int shift) {
+      return (hash >> shift) & (WIDTH - 1);
+    }
+
+    static NodePtr _set(const NodePtr & node, size_t hash, unsigned int shift, const K & key, T && value, bool & added) {
+      if (!node) {
+        std::shared_ptr<Node> leaf = std::make_shared<Node>();
+        leaf->entries.push_back(Entry{ hash, key, std::move(value) });
+        added = true;
+        return leaf;
+      }
+
+      std::shared_ptr<Node> copy = std::make_shared<Node>(*node);
+      if (!copy->children.empty()) {
+        NodePtr & child = copy->children[_index(hash, shift)];
+        child = _set(child, hash, shift + BITS, key, std::move(value), added);
+        return copy;
+      }
+
+      for (Entry & entry : copy->entries) {
+        if (entry.hash == hash && entry.key == key) {
+          entry.value = std::move(value);
+          return copy;
+        }
+      }
+      copy->entries.push_back(Entry{ hash, key, std::move(value) });
+      added = true;
+
+      // Split a full leaf, unless the hash has no bits left to split on:
+      if (copy->entries.size() > LEAF_CAPACITY && shift + BITS < sizeof(size_t) * 8) {
+        std::shared_ptr<Node> branch = std::make_shared<Node>();
+        branch->children.resize(WIDTH);
+        for (Entry & entry : copy->entries) {
+          bool unused = false;
+          NodePtr & child = branch->children[_index(entry.hash, shift)];
+          child = _set(child, entry.hash, shift + BITS, entry.key, std::move(entry.value), unused);
+        }
+        return branch;
+      }
+      return copy;
+    }
+
+    static NodePtr _erase(const NodePtr & node, size_t hash, unsigned int shift, const K & key) {
+      std::shared_ptr<Node> copy = std::make_shared<Node>(*node);
+      if (!copy->children.empty()) {
+        NodePtr & child = copy->children[_index(hash, shift)];
+        child = _erase(child, hash, shift + BITS, key);
+        for (const NodePtr & c : copy->children) {
+          if (c) { return copy; }
+        }
+        return NodePtr();
+      }
+
+      for (size_t i = 0; i < copy->entries.size(); i++) {
+        if (copy->entries[i].hash == hash && copy->entries[i].key == key) {
+          copy->entries.erase(copy->entries.begin() + i);
+          break;
+        }
+      }
+      if (copy->entries.empty()) { return NodePtr(); }
+      return copy;
+    }
+
+    template <class F>
+    static void _forEach(const Node * node, F & visit) {
+      if (node == nullptr) { return; }
+      for (const NodePtr & child : node->children) { _forEach(child.get(), visit); }
+      for (const Entry & entry : node->entries) { visit(entry.key, entry.value); }
+    }
+};
@@ -0,0 +1,117 @@
+#include "PlaythroughSimulator.h"
+#include "Trace.h"
+#include "Xoshiro256.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+/**
+* Vose's alias method, for the choices of each vertex: choice i is kept
+* with probability threshold_[i] and otherwise replaced by alias_[i], so
+* that every choice comes up in proportion to its weight
+*/
+void PlaythroughSimulator::_buildAliasTables(const std::vector<double> & weights) {
+  uint32_t n = graph_.numVertices();
+  threshold_.assign(graph_.numEdges(), 1);
+  alias_.resize(graph_.numEdges());
+  stuck_.assign(n, false);
+  std::vector<double> scaled;
+  std::vector<uint32_t> small, large;
+
+  for (uint32_t v = 0; v < n; v++) {
+    size_t first = graph_.firstEdge(v);
+    uint32_t degree = graph_.degree(v);
+    if (degree == 0) { continue; }
+    double total = 0;
+    for (uint32_t i = 0; i < degree; i++) { total += weights[first + i]; }
+    if (total == 0) { stuck_[v] = true; continue; }
+
+    scaled.resize(degree);
+    small.clear();
+    large.clear();
+    for (uint32_t i = 0; i < degree; i++) {
+      alias_[first + i] = i;
+      scaled[i] = weights[first + i] * degree / total;
+      (scaled[i] < 1 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      uint32_t s = small.back(), l = large.back();
+      small.pop_back();
+      threshold_[first + s] = scaled[s];
+      alias_[first + s] = l;
+      scaled[l] -= 1 - scaled[s];
+      if (scaled[l] < 1) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // What is left is 1, up to rounding:
+    for (uint32_t i : small) { threshold_[first + i] = 1; }
+    for (uint32_t i : large) { threshold_[first + i] = 1; }
+  }
+}
+
+SimulationResult PlaythroughSimulator::run(const std::string & start, uint64_t playthroughs, SimulationOptions options) const {
+  TRACE_SPAN("PlaythroughSimulator::run", "simulate");
+  uint32_t startId = id(start);
+  unsigned int threads = options.threads;
+  if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+  threads = std::max<uint64_t>(1, std::min<uint64_t>(threads, playthroughs));
+
+  std::vector<SimulationResult> partial(threads);
+  std::vector<std::thread> workers;
+  for (unsigned int t = 0; t < threads; t++) {
+    uint64_t share = playthroughs / threads + (t < playthroughs % threads ? 1 : 0);
+    workers.push_back(std::thread(&PlaythroughSimulator::_play, this, startId, share, options.seed, t, options.maxSteps, std::ref(partial[t])));
+  }
+  for (std::thread & worker : workers) { worker.join(); }
+
+  SimulationResult result;
+  result.endings.assign(numVertices(), 0);
+  result.visits.assign(numVertices(), 0);
+  for (const SimulationResult & part : partial) {
+    result.playthroughs += part.playthroughs;
+    result.unfinished += part.unfinished;
+    for (uint32_t v = 0; v < numVertices(); v++) {
+      result.endings[v] += part.endings[v];
+      result.visits[v] += part.visits[v];
+    }
+  }
+  return result;
+}
+
+/**
+* One thread's playthroughs, on stream `stream` of `seed`, counted in a
+* local result (which is only copied out at the end, so that threads do
+* not write next to each other)
+*/
+void PlaythroughSimulator::_play(uint32_t start, uint64_t playthroughs, uint64_t seed, unsigned int stream, unsigned int maxSteps, SimulationResult & out) const {
+  Xoshiro256 random(seed);
+  for (unsigned int i = 0; i < stream; i++) { random.jump(); }
+  SimulationResult result;
+  result.endings.assign(numVertices(), 0);
+  result.visits.assign(numVertices(), 0);
+  result.playthroughs = playthroughs;
+
+  for (uint64_t p = 0; p < playthroughs; p++) {
+    uint32_t v = start;
+    for (unsigned int step = 0; ; step++) {
+      result.visits[v]++;
+      size_t first = graph_.firstEdge(v);
+      uint32_t degree = graph_.degree(v);
+      if (degree == 0) {
+        result.endings[v]++;
+        break;
+      }
+      if (step == maxSteps || stuck_[v]) {
+        result.unfinished++;
+        break;
+      }
+      uint32_t choice = random.below(degree);
+      if (random.uniform() >= threshold_[first + choice]) { choice = alias_[first + choice]; }
+      v = graph_.neighbors(v).begin()[choice];
+    }
+  }
+  out = std::move(result);
+}
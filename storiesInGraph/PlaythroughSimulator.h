@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "CsrGraph.h"
+
+class SimulationOptions {
+  public:
+    unsigned int threads = 0;        /*< 0: one per hardware thread */
+    uint64_t seed = 1;
+    unsigned int maxSteps = 100000;  /*< Choices before a playthrough is given up */
+};
+
+/**
+ * The totals of a batch of playthroughs, by vertex id.
+ */
+class SimulationResult {
+  public:
+    uint64_t playthroughs = 0;
+    uint64_t unfinished = 0;         /*< Given up after maxSteps, or stuck where every choice weighs 0 */
+    std::vector<uint64_t> endings;   /*< The playthroughs that ended at each vertex */
+    std::vector<uint64_t> visits;    /*< Visits to each vertex, over every playthrough */
+};
+
+/**
+ * Plays a story many times at random, in parallel, for balancing: which
+ * endings readers reach, and how often they pass each vertex.
+ *
+ * A reader at a vertex picks one of its outgoing edges with probability
+ * proportional to the edge's weight, read from an edge property (the
+ * Edge's own weight if the property is not set, and 0 if it is negative or
+ * not a number), and stops at an ending, a vertex with no outgoing edges.
+ *
+ * The story is copied into a CsrGraph, with an alias table per vertex
+ * (Vose's method), so each choice is one random number and one array
+ * lookup.  Each thread has its own xoshiro256** stream (jumped apart from
+ * the same seed) and its own counters, which are summed at the end, so
+ * the threads share nothing while they run; a run is reproducible for a
+ * given seed and thread count.
+ */
+class PlaythroughSimulator {
+  public:
+    template <class V, class E>
+    PlaythroughSimulator(const Graph<V,E> & g, const std::string & weightProperty = "weight");
+
+    uint32_t numVertices() const { return graph_.numVertices(); }
+    const std::string & key(uint32_t v) const { return graph_.key(v); }
+
+    /**
+     * @throws std::out_of_range if there is no such vertex.
+     */
+    uint32_t id(const std::string & key) const { return graph_.id(key); }
+
+    /**
+     * Plays `playthroughs` times from `start`.
+     * @throws std::out_of_range if there is no Vertex `start`.
+     */
+    SimulationResult run(const std::string & start, uint64_t playthroughs, SimulationOptions options = SimulationOptions()) const;
+
+  private:
+    CsrGraph graph_;
+    std::vector<double> threshold_;    /*< Alias table, by edge: keep choice i if a uniform draw is below this */
+    std::vector<uint32_t> alias_;      /*< ...or take the alias, an index among the same choices */
+    std::vector<bool> stuck_;          /*< Every choice weighs 0 */
+
+    void _buildAliasTables(const std::vector<double> & weights);
+    void _play(uint32_t start, uint64_t playthroughs, uint64_t seed, unsigned int stream, unsigned int maxSteps, SimulationResult & result) const;
+};
+
+template <class V, class E>
+PlaythroughSimulator::PlaythroughSimulator(const Graph<V,E> & g, const std::string & weightProperty) :
+  graph_(CsrGraph::fromGraph(g))
+{
+  // incidentEdges lists a vertex's edges in the CsrGraph's order, followed
+  // by the directed edges into it:
+  std::vector<double> weights;
+  weights.reserve(graph_.numEdges());
+  for (uint32_t v = 0; v < graph_.numVertices(); v++) {
+    uint32_t choices = graph_.degree(v);
+    for (const E & e : g.incidentEdges(graph_.key(v))) {
+      if (choices-- == 0) { break; }
+      std::string property = e.property(weightProperty);
+      char * end = nullptr;
+      double weight = property.empty() ? e.weight() : std::strtod(property.c_str(), &end);
+      if (!property.empty() && (end == property.c_str() || *end != '\0')) { weight = 0; }
+      weights.push_back(weight > 0 ? weight : 0);
+    }
+  }
+  _buildAliasTables(weights);
+}
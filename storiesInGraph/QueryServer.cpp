@@ -0,0 +1,556 @@
+#include "QueryServer.h"
+#include "Trace.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+
+static void putU32(std::string & out, uint32_t value) {
+  for (int i = 0; i < 4; i++) { out.push_back((char) ((value >> (8 * i)) & 0xff)); }
+}
+
+static bool getU32(std::string_view & in, uint32_t & value) {
+  if (in.size() < 4) { return false; }
+  value = 0;
+  for (int i = 0; i < 4; i++) { value |= (uint32_t) (unsigned char) in[i] << (8 * i); }
+  in.remove_prefix(4);
+  return true;
+}
+
+static void putString(std::string & out, const std::string & s) {
+  putU32(out, s.size());
+  out.append(s);
+}
+
+static bool getString(std::string_view & in, std::string & s) {
+  uint32_t length;
+  if (!getU32(in, length) || in.size() < length) { return false; }
+  s.assign(in.data(), length);
+  in.remove_prefix(length);
+  return true;
+}
+
+static void putFrame(std::string & out, const std::string & body) {
+  putU32(out, body.size());
+  out.append(body);
+}
+
+// Takes the body of the frame at the start of `in`, if it is all there:
+static bool getFrame(std::string_view & in, std::string_view & body, uint32_t limit) {
+  std::string_view rest = in;
+  uint32_t length;
+  if (!getU32(rest, length)) { return false; }
+  if (length > limit) { throw std::runtime_error("Query frame of " + std::to_string(length) + " bytes is too large"); }
+  if (rest.size() < length) { return false; }
+  body = rest.substr(0, length);
+  in = rest.substr(length);
+  return true;
+}
+
+void QueryProtocol::encode(const Request & request, std::string & out) {
+  std::string body;
+  putU32(body, request.id);
+  body.push_back((char) request.op);
+  putString(body, request.key1);
+  putString(body, request.key2);
+  putFrame(out, body);
+}
+
+void QueryProtocol::encode(const Response & response, std::string & out) {
+  std::string body;
+  putU32(body, response.id);
+  body.push_back((char) response.status);
+  putU32(body, response.value);
+  putU32(body, response.keys.size());
+  for (const std::string & key : response.keys) { putString(body, key); }
+  putFrame(out, body);
+}
+
+bool QueryProtocol::decode(std::string_view & in, Request & request) {
+  std::string_view body;
+  if (!getFrame(in, body, MAX_FRAME)) { return false; }
+  if (!getU32(body, request.id) || body.empty()) { throw std::runtime_error("Malformed query request"); }
+  request.op = (Op) body[0];
+  body.remove_prefix(1);
+  if (!getString(body, request.key1) || !getString(body, request.key2)) { throw std::runtime_error("Malformed query request"); }
+  return true;
+}
+
+bool QueryProtocol::decode(std::string_view & in, Response & response) {
+  std::string_view body;
+  if (!getFrame(in, body, UINT32_MAX)) { return false; }
+  uint32_t count;
+  if (!getU32(body, response.id) || body.empty()) { throw std::runtime_error("Malformed query response"); }
+  response.status = (Status) body[0];
+  body.remove_prefix(1);
+  if (!getU32(body, response.value) || !getU32(body, count)) { throw std::runtime_error("Malformed query response"); }
+  response.keys.resize(count);
+  for (std::string & key : response.keys) {
+    if (!getString(body, key)) { throw std::runtime_error("Malformed query response"); }
+  }
+  return true;
+}
+
+
+QueryServer::QueryServer(const Graph<Vertex, DirectedEdge> & g, unsigned int workers) :
+  g_(g), listenFd_(-1), epollFd_(epoll_create1(EPOLL_CLOEXEC)), eventFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+  stopping_(false), nextConnection_(1), shutdown_(false), queries_(0), batches_(0), traversals_(0)
+{
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.fd = eventFd_;
+  epoll_ctl(epollFd_, EPOLL_CTL_ADD, eventFd_, &ev);
+
+  if (workers == 0) { workers = std::max(1u, std::thread::hardware_concurrency()); }
+  for (unsigned int i = 0; i < workers; i++) { workers_.push_back(std::thread(&QueryServer::_work, this)); }
+}
+
+QueryServer::~QueryServer() {
+  {
+    std::lock_guard<std::mutex> lock(workMutex_);
+    shutdown_ = true;
+  }
+  workReady_.notify_all();
+  for (std::thread & worker : workers_) { worker.join(); }
+
+  for (auto & pair : connections_) { ::close(pair.first); }
+  if (listenFd_ >= 0) {
+    ::close(listenFd_);
+    unlink(path_.c_str());
+  }
+  ::close(epollFd_);
+  ::close(eventFd_);
+}
+
+bool QueryServer::listen(const std::string & path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) { return false; }
+  std::strcpy(addr.sun_path, path.c_str());
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) { return false; }
+  unlink(path.c_str());
+  if (bind(fd, (sockaddr *) &addr, sizeof(addr)) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.fd = fd;
+  epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+  listenFd_ = fd;
+  path_ = path;
+  return true;
+}
+
+void QueryServer::run() {
+  epoll_event events[64];
+  while (!stopping_) {
+    int n = epoll_wait(epollFd_, events, 64, -1);
+    if (n < 0) {
+      if (errno == EINTR) { continue; }
+      break;
+    }
+
+    // Everything read in this round is answered as one batch:
+    std::vector<Pending> batch;
+    for (int i = 0; i < n; i++) {
+      int fd = events[i].data.fd;
+      if (fd == listenFd_) { _accept(); continue; }
+      if (fd == eventFd_) {
+        uint64_t count;
+        while (::read(eventFd_, &count, sizeof(count)) > 0) { }
+        _deliver();
+        continue;
+      }
+
+      auto it = connections_.find(fd);
+      if (it == connections_.end()) { continue; }
+      bool open = true;
+      if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) { open = _read(fd, it->second, batch); }
+      if (open && (events[i].events & EPOLLOUT)) { open = _write(fd, it->second); }
+      if (!open || it->second.finished()) { _close(fd); }
+    }
+    if (!batch.empty()) { _dispatch(batch); }
+  }
+}
+
+void QueryServer::stop() {
+  stopping_ = true;
+  uint64_t one = 1;
+  ssize_t unused = ::write(eventFd_, &one, sizeof(one));
+  (void) unused;
+}
+
+QueryServer::Stats QueryServer::stats() const {
+  Stats stats;
+  stats.queries = queries_;
+  stats.batches = batches_;
+  stats.traversals = traversals_;
+  return stats;
+}
+
+void QueryServer::_accept() {
+  while (true) {
+    int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) { return; }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    connections_[fd].id = nextConnection_++;
+  }
+}
+
+/**
+* Reads everything available on `fd` and adds its complete requests to
+* `batch`.  At the end of the client's input, the connection stays open for
+* the responses to what it sent.
+* @return false, if the connection should be closed
+*/
+bool QueryServer::_read(int fd, Connection & connection, std::vector<Pending> & batch) {
+  char buffer[1 << 16];
+  while (true) {
+    ssize_t n = ::read(fd, buffer, sizeof(buffer));
+    if (n > 0) { connection.in.append(buffer, n); continue; }
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) { return false; }
+    if (n == 0) {
+      // Input is no longer watched, so a second end of input means a hangup:
+      if (connection.readClosed) { return false; }
+      connection.readClosed = true;
+      _watch(fd, connection);
+    }
+    break;
+  }
+
+  std::string_view in = connection.in;
+  try {
+    Pending pending{ fd, connection.id, QueryProtocol::Request() };
+    while (QueryProtocol::decode(in, pending.request)) {
+      batch.push_back(pending);
+      connection.unanswered++;
+    }
+  } catch (const std::runtime_error & e) {
+    return false;
+  }
+  connection.in.erase(0, connection.in.size() - in.size());
+  return true;
+}
+
+/**
+* Writes as much of the connection's output as `fd` accepts, and waits for
+* EPOLLOUT while some is left
+* @return false, if the connection should be closed
+*/
+bool QueryServer::_write(int fd, Connection & connection) {
+  while (!connection.out.empty()) {
+    ssize_t n = ::send(fd, connection.out.data(), connection.out.size(), MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (!connection.writing) {
+        connection.writing = true;
+        _watch(fd, connection);
+      }
+      return true;
+    }
+    if (n < 0) { return false; }
+    connection.out.erase(0, n);
+  }
+
+  if (connection.writing) {
+    connection.writing = false;
+    _watch(fd, connection);
+  }
+  return true;
+}
+
+/**
+* Waits for input until the client stops sending, and for EPOLLOUT while
+* output is waiting
+*/
+void QueryServer::_watch(int fd, const Connection & connection) {
+  epoll_event ev{};
+  ev.events = (connection.readClosed ? 0u : uint32_t(EPOLLIN)) | (connection.writing ? uint32_t(EPOLLOUT) : 0u);
+  ev.data.fd = fd;
+  epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void QueryServer::_close(int fd) {
+  epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+  ::close(fd);
+  connections_.erase(fd);
+}
+
+/**
+* Splits a batch into work items: one per start vertex of its shortestPath
+* requests, and chunks of the cheap requests
+*/
+void QueryServer::_dispatch(std::vector<Pending> & batch) {
+  queries_ += batch.size();
+  batches_++;
+
+  std::unordered_map<std::string, std::vector<Pending>> byStart;
+  std::vector<std::vector<Pending>> items(1);
+  for (Pending & pending : batch) {
+    if (pending.request.op == QueryProtocol::SHORTEST_PATH) {
+      byStart[pending.request.key1].push_back(std::move(pending));
+      continue;
+    }
+    if (items.back().size() >= 64) { items.emplace_back(); }
+    items.back().push_back(std::move(pending));
+  }
+  if (items.back().empty()) { items.pop_back(); }
+  for (auto & pair : byStart) { items.push_back(std::move(pair.second)); }
+
+  {
+    std::lock_guard<std::mutex> lock(workMutex_);
+    for (std::vector<Pending> & item : items) { work_.push_back(std::move(item)); }
+  }
+  workReady_.notify_all();
+}
+
+/**
+* Queues the responses the workers finished on their connections
+*/
+void QueryServer::_deliver() {
+  std::vector<Completion> done;
+  {
+    std::lock_guard<std::mutex> lock(doneMutex_);
+    done.swap(done_);
+  }
+
+  for (Completion & completion : done) {
+    auto it = connections_.find(completion.fd);
+    // The connection may have closed (and its fd been reused) meanwhile:
+    if (it == connections_.end() || it->second.id != completion.connection) { continue; }
+    Connection & connection = it->second;
+    connection.unanswered--;
+    connection.out.append(completion.bytes);
+    bool open = connection.writing || _write(completion.fd, connection);
+    if (!open || connection.finished()) { _close(completion.fd); }
+  }
+}
+
+void QueryServer::_work() {
+  while (true) {
+    std::vector<Pending> item;
+    {
+      std::unique_lock<std::mutex> lock(workMutex_);
+      workReady_.wait(lock, [&]() { return shutdown_ || !work_.empty(); });
+      if (shutdown_) { return; }
+      item = std::move(work_.front());
+      work_.pop_front();
+    }
+
+    std::vector<Completion> completions;
+    _answer(item, completions);
+    {
+      std::lock_guard<std::mutex> lock(doneMutex_);
+      for (Completion & completion : completions) { done_.push_back(std::move(completion)); }
+    }
+    uint64_t one = 1;
+    ssize_t unused = ::write(eventFd_, &one, sizeof(one));
+    (void) unused;
+  }
+}
+
+void QueryServer::_answer(const std::vector<Pending> & item, std::vector<Completion> & out) {
+  std::vector<QueryProtocol::Response> responses(item.size());
+  if (item.front().request.op == QueryProtocol::SHORTEST_PATH) {
+    _shortestPaths(item, responses);
+  } else {
+    for (size_t i = 0; i < item.size(); i++) {
+      const QueryProtocol::Request & request = item[i].request;
+      QueryProtocol::Response & response = responses[i];
+      try {
+        switch (request.op) {
+          case QueryProtocol::DEGREE:
+            response.value = g_.degree(request.key1);
+            break;
+          case QueryProtocol::INCIDENT_EDGES:
+            for (const DirectedEdge & e : g_.incidentEdges(request.key1)) {
+              response.keys.push_back(e.source().key());
+              response.keys.push_back(e.dest().key());
+            }
+            break;
+          case QueryProtocol::IS_ADJACENT:
+            g_.degree(request.key2);
+            response.value = g_.isAdjacent(request.key1, request.key2) ? 1 : 0;
+            break;
+          default:
+            response.status = QueryProtocol::BAD_REQUEST;
+        }
+      } catch (const std::out_of_range & e) {
+        response = QueryProtocol::Response();
+        response.status = QueryProtocol::NOT_FOUND;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < item.size(); i++) {
+    responses[i].id = item[i].request.id;
+    Completion completion{ item[i].fd, item[i].connection, "" };
+    QueryProtocol::encode(responses[i], completion.bytes);
+    out.push_back(std::move(completion));
+  }
+}
+
+/**
+* Answers shortestPath requests that share a start vertex from one
+* breadth-first search.  The search visits edges in the same order as
+* Graph::shortestPath, so it finds the same paths.
+*/
+void QueryServer::_shortestPaths(const std::vector<Pending> & item, std::vector<QueryProtocol::Response> & responses) {
+  TRACE_SPAN("QueryServer::_shortestPaths", "traverse");
+  const std::string & start = item.front().request.key1;
+  std::unordered_map<std::string, std::string> predecessor;
+  std::unordered_map<std::string, int> distance;
+
+  try {
+    g_.degree(start);
+  } catch (const std::out_of_range & e) {
+    for (QueryProtocol::Response & response : responses) { response.status = QueryProtocol::NOT_FOUND; }
+    return;
+  }
+
+  traversals_++;
+  std::queue<std::string> q;
+  distance[start] = 0;
+  q.push(start);
+  while (!q.empty()) {
+    std::string cur = q.front();
+    q.pop();
+    for (const DirectedEdge & e : g_.incidentEdges(cur)) {
+      const std::string next = (e.dest().key() == cur) ? e.source().key() : e.dest().key();
+      if (distance.find(next) == distance.end()) {
+        distance[next] = distance[cur] + 1;
+        predecessor[next] = cur;
+        q.push(next);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < item.size(); i++) {
+    const std::string & end = item[i].request.key2;
+    try {
+      g_.degree(end);
+    } catch (const std::out_of_range & e) {
+      responses[i].status = QueryProtocol::NOT_FOUND;
+      continue;
+    }
+
+    std::vector<std::string> & path = responses[i].keys;
+    for (std::string cur = end; ; ) {
+      path.push_back(cur);
+      auto it = predecessor.find(cur);
+      if (it == predecessor.end()) { break; }
+      cur = it->second;
+    }
+    std::reverse(path.begin(), path.end());
+  }
+}
+
+
+bool QueryClient::connect(const std::string & path) {
+  close();
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) { return false; }
+  std::strcpy(addr.sun_path, path.c_str());
+
+  fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) { return false; }
+  if (::connect(fd_, (sockaddr *) &addr, sizeof(addr)) != 0) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void QueryClient::close() {
+  if (fd_ >= 0) { ::close(fd_); }
+  fd_ = -1;
+  in_.clear();
+}
+
+void QueryClient::closeWrite() {
+  if (fd_ >= 0) { ::shutdown(fd_, SHUT_WR); }
+}
+
+uint32_t QueryClient::send(QueryProtocol::Op op, const std::string & key1, const std::string & key2) {
+  QueryProtocol::Request request{ nextId_++, op, key1, key2 };
+  std::string bytes;
+  QueryProtocol::encode(request, bytes);
+
+  std::string_view out = bytes;
+  while (!out.empty()) {
+    ssize_t n = ::send(fd_, out.data(), out.size(), MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n < 0) { throw std::runtime_error("Cannot send to the query server"); }
+    out.remove_prefix(n);
+  }
+  return request.id;
+}
+
+QueryProtocol::Response QueryClient::receive() {
+  QueryProtocol::Response response;
+  while (true) {
+    std::string_view in = in_;
+    if (QueryProtocol::decode(in, response)) {
+      in_.erase(0, in_.size() - in.size());
+      return response;
+    }
+
+    char buffer[1 << 16];
+    ssize_t n = ::read(fd_, buffer, sizeof(buffer));
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0) { throw std::runtime_error("The query server closed the connection"); }
+    in_.append(buffer, n);
+  }
+}
+
+/**
+* Sends one request and waits for its response (dropping responses to
+* requests still pipelined with `send`)
+*/
+QueryProtocol::Response QueryClient::_query(QueryProtocol::Op op, const std::string & key1, const std::string & key2) {
+  uint32_t id = send(op, key1, key2);
+  QueryProtocol::Response response;
+  do { response = receive(); } while (response.id != id);
+
+  if (response.status == QueryProtocol::NOT_FOUND) { throw std::out_of_range("No vertex " + key1 + (key2.empty() ? "" : " or " + key2)); }
+  if (response.status != QueryProtocol::OK) { throw std::runtime_error("The query server rejected the request"); }
+  return response;
+}
+
+std::list<std::string> QueryClient::shortestPath(const std::string & start, const std::string & end) {
+  QueryProtocol::Response response = _query(QueryProtocol::SHORTEST_PATH, start, end);
+  return std::list<std::string>(response.keys.begin(), response.keys.end());
+}
+
+unsigned int QueryClient::degree(const std::string & key) {
+  return _query(QueryProtocol::DEGREE, key, "").value;
+}
+
+std::vector<std::pair<std::string, std::string>> QueryClient::incidentEdges(const std::string & key) {
+  QueryProtocol::Response response = _query(QueryProtocol::INCIDENT_EDGES, key, "");
+  std::vector<std::pair<std::string, std::string>> edges;
+  for (size_t i = 0; i + 1 < response.keys.size(); i += 2) { edges.push_back({ response.keys[i], response.keys[i + 1] }); }
+  return edges;
+}
+
+bool QueryClient::isAdjacent(const std::string & key1, const std::string & key2) {
+  return _query(QueryProtocol::IS_ADJACENT, key1, key2).value == 1;
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "Graph.h"
+#include "DirectedEdge.h"
+#include "Vertex.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * The binary protocol of QueryServer.
+ *
+ * Every message is a frame: a little-endian 32-bit body length, then the
+ * body.  Strings are a 32-bit length followed by their bytes.
+ *   Request body:  [u32 id][u8 op][string key1][string key2]
+ *   Response body: [u32 id][u8 status][u32 value][u32 count][count strings]
+ * A response carries the id of its request.  Responses on one connection
+ * may arrive in any order.
+ */
+class QueryProtocol {
+  public:
+    enum Op : uint8_t {
+      SHORTEST_PATH = 1,  /*< key1 -> key2; `keys` is the path */
+      DEGREE,             /*< key1; `value` is the degree */
+      INCIDENT_EDGES,     /*< key1; `keys` is source, dest of each edge */
+      IS_ADJACENT         /*< key1, key2; `value` is 1 or 0 */
+    };
+
+    enum Status : uint8_t {
+      OK = 0,
+      NOT_FOUND,          /*< A key is not a vertex of the graph */
+      BAD_REQUEST
+    };
+
+    class Request {
+      public:
+        uint32_t id;
+        Op op;
+        std::string key1;
+        std::string key2;
+    };
+
+    class Response {
+      public:
+        uint32_t id = 0;
+        Status status = OK;
+        uint32_t value = 0;
+        std::vector<std::string> keys;
+    };
+
+    // Requests larger than this are rejected, and their connection closed:
+    static constexpr uint32_t MAX_FRAME = 1 << 20;
+
+    static void encode(const Request & request, std::string & out);
+    static void encode(const Response & response, std::string & out);
+
+    /**
+     * Decodes the frame at the start of `in` and removes it from `in`.
+     * @return false, if `in` does not hold a whole frame yet.
+     * @throws std::runtime_error if the frame is malformed.
+     */
+    static bool decode(std::string_view & in, Request & request);
+    static bool decode(std::string_view & in, Response & response);
+};
+
+/**
+ * Answers queries about a loaded story graph over a Unix domain socket, so
+ * that each query costs a traversal instead of a `CYOA::load`.
+ *
+ * One thread runs an epoll(7) event loop that accepts connections, reads
+ * every request that has arrived on any of them, and hands the whole batch
+ * to a pool of worker threads.  shortestPath requests in a batch that
+ * share a start vertex are answered from one breadth-first search (the
+ * same search Graph::shortestPath does, so the paths are identical).
+ * Workers pass encoded responses back to the event loop through an
+ * eventfd, and the loop writes them out.
+ *
+ * The graph must not change while the server runs.
+ */
+class QueryServer {
+  public:
+    class Stats {
+      public:
+        uint64_t queries = 0;
+        uint64_t batches = 0;
+        uint64_t traversals = 0;  /*< Breadth-first searches run for shortestPath */
+    };
+
+    /**
+     * @param workers Number of worker threads (0: one per hardware thread).
+     */
+    QueryServer(const Graph<Vertex, DirectedEdge> & g, unsigned int workers = 0);
+    ~QueryServer();
+
+    QueryServer(const QueryServer & other) = delete;
+    QueryServer & operator=(const QueryServer & other) = delete;
+
+    /**
+     * Listens on the Unix socket `path`, replacing any file already there.
+     * @return false, if the socket could not be created.
+     */
+    bool listen(const std::string & path);
+
+    /**
+     * Serves requests until `stop` is called.
+     */
+    void run();
+
+    /**
+     * Makes `run` return.  Safe to call from any thread and from a signal
+     * handler.
+     */
+    void stop();
+
+    Stats stats() const;
+
+  private:
+    // A request, and the connection that sent it:
+    class Pending {
+      public:
+        int fd;
+        uint64_t connection;
+        QueryProtocol::Request request;
+    };
+
+    // Encoded responses for one connection:
+    class Completion {
+      public:
+        int fd;
+        uint64_t connection;
+        std::string bytes;
+    };
+
+    class Connection {
+      public:
+        uint64_t id;
+        std::string in;
+        std::string out;
+        bool writing = false;     /*< Waiting for EPOLLOUT */
+        bool readClosed = false;  /*< The client will send no more requests */
+        size_t unanswered = 0;    /*< Requests read but not yet answered */
+
+        // Once the client has stopped sending, the connection closes when
+        // every response has been written:
+        bool finished() const { return readClosed && unanswered == 0 && out.empty(); }
+    };
+
+    const Graph<Vertex, DirectedEdge> & g_;
+    std::string path_;
+    int listenFd_;
+    int epollFd_;
+    int eventFd_;
+    std::atomic<bool> stopping_;
+    uint64_t nextConnection_;
+    std::unordered_map<int, Connection> connections_;
+
+    std::vector<std::thread> workers_;
+    std::mutex workMutex_;
+    std::condition_variable workReady_;
+    std::deque<std::vector<Pending>> work_;
+    bool shutdown_;
+
+    std::mutex doneMutex_;
+    std::vector<Completion> done_;
+
+    std::atomic<uint64_t> queries_;
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> traversals_;
+
+    void _accept();
+    bool _read(int fd, Connection & connection, std::vector<Pending> & batch);
+    bool _write(int fd, Connection & connection);
+    void _watch(int fd, const Connection & connection);
+    void _close(int fd);
+    void _dispatch(std::vector<Pending> & batch);
+    void _deliver();
+    void _work();
+    void _answer(const std::vector<Pending> & item, std::vector<Completion> & out);
+    void _shortestPaths(const std::vector<Pending> & item, std::vector<QueryProtocol::Response> & responses);
+};
+
+/**
+ * A blocking client of QueryServer.
+ */
+class QueryClient {
+  public:
+    QueryClient() : fd_(-1), nextId_(1) { }
+    ~QueryClient() { close(); }
+
+    QueryClient(const QueryClient & other) = delete;
+    QueryClient & operator=(const QueryClient & other) = delete;
+
+    /**
+     * @return true, if connected to the server listening at `path`.
+     */
+    bool connect(const std::string & path);
+    void close();
+
+    /**
+     * Tells the server that no more requests will be sent; responses to
+     * the ones already sent can still be received.
+     */
+    void closeWrite();
+
+    /**
+     * Sends a request without waiting for its response (requests can be
+     * pipelined this way).
+     * @return The id of the request.
+     * @throws std::runtime_error if the server cannot be reached.
+     */
+    uint32_t send(QueryProtocol::Op op, const std::string & key1, const std::string & key2 = "");
+
+    /**
+     * Waits for the next response, whichever request it answers.
+     * @throws std::runtime_error if the server cannot be reached.
+     */
+    QueryProtocol::Response receive();
+
+    // Blocking queries, like the Graph functions of the same name; they
+    // throw std::out_of_range for a missing vertex:
+    std::list<std::string> shortestPath(const std::string & start, const std::string & end);
+    unsigned int degree(const std::string & key);
+    std::vector<std::pair<std::string, std::string>> incidentEdges(const std::string & key);
+    bool isAdjacent(const std::string & key1, const std::string & key2);
+
+  private:
+    int fd_;
+    uint32_t nextId_;
+    std::string in_;
+
+    QueryProtocol::Response _query(QueryProtocol::Op op, const std::string & key1, const std::string & key2);
+};
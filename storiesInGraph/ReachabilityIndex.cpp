@@ -0,0 +1,127 @@
+#include "ReachabilityIndex.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <utility>
+
+ReachabilityIndex::ReachabilityIndex(const CsrGraph & g, size_t maxBytes) : scc_(g) {
+  TRACE_SPAN("ReachabilityIndex", "traverse");
+  const CsrGraph & dag = scc_.condensation();
+  uint32_t count = scc_.count();
+
+  // Successors have higher numbers, so one pass from the last component
+  // down sees every successor first:
+  reachesEnding_.assign(count, false);
+  for (uint32_t c = count; c-- > 0; ) {
+    for (uint32_t v : scc_.members(c)) {
+      if (g.degree(v) == 0) { reachesEnding_[c] = true; }
+    }
+    for (uint32_t d : dag.neighbors(c)) {
+      if (reachesEnding_[d]) { reachesEnding_[c] = true; }
+    }
+  }
+
+  // The bitset of component c covers the words from c / 64 to the last:
+  size_t words = (count + 63) / 64;
+  size_t total = 0;
+  for (uint32_t c = 0; c < count; c++) { total += words - c / 64; }
+  if (total * sizeof(uint64_t) > maxBytes) {
+    _buildLabels();
+    return;
+  }
+
+  rowOffsets_.resize(count);
+  size_t offset = 0;
+  for (uint32_t c = 0; c < count; c++) {
+    rowOffsets_[c] = offset;
+    offset += words - c / 64;
+  }
+  bits_.assign(total, 0);
+
+  for (uint32_t c = count; c-- > 0; ) {
+    uint64_t * row = bits_.data() + rowOffsets_[c] - c / 64;  // Indexed by absolute word
+    row[c / 64] |= uint64_t(1) << (c % 64);
+    for (uint32_t d : dag.neighbors(c)) {
+      const uint64_t * other = bits_.data() + rowOffsets_[d] - d / 64;
+      for (size_t w = d / 64; w < words; w++) { row[w] |= other[w]; }
+    }
+  }
+}
+
+bool ReachabilityIndex::reachable(uint32_t from, uint32_t to) const {
+  uint32_t c = scc_.component(from), d = scc_.component(to);
+  if (c == d) { return true; }
+  if (d < c) { return false; }
+  if (!indexed()) {
+    if (_treeReaches(c, d)) { return true; }
+    if (!_mayReach(c, d)) { return false; }
+    return _search(c, d);
+  }
+  return (bits_[rowOffsets_[c] + d / 64 - c / 64] >> (d % 64)) & 1;
+}
+
+/**
+* Numbers the components in the post-order of a depth-first search of the
+* condensation, and fills `labels_`
+*/
+void ReachabilityIndex::_buildLabels() {
+  const CsrGraph & dag = scc_.condensation();
+  uint32_t count = scc_.count();
+  labels_.resize(count);
+
+  std::vector<bool> visited(count, false);
+  std::vector<std::pair<uint32_t, size_t>> stack;  // Component, next neighbor
+  uint32_t next = 0;
+  for (uint32_t root = 0; root < count; root++) {
+    if (visited[root]) { continue; }
+    visited[root] = true;
+    labels_[root].treeLow = next;
+    stack.push_back({ root, 0 });
+
+    while (!stack.empty()) {
+      uint32_t c = stack.back().first;
+      CsrGraph::Range neighbors = dag.neighbors(c);
+      if (stack.back().second < neighbors.size()) {
+        uint32_t d = neighbors.first[stack.back().second++];
+        if (!visited[d]) {
+          visited[d] = true;
+          labels_[d].treeLow = next;
+          stack.push_back({ d, 0 });
+        }
+      } else {
+        labels_[c].post = next++;
+        stack.pop_back();
+      }
+    }
+  }
+
+  // Successors have higher numbers, so their `low` is known first:
+  for (uint32_t c = count; c-- > 0; ) {
+    labels_[c].low = labels_[c].treeLow;
+    for (uint32_t d : dag.neighbors(c)) { labels_[c].low = std::min(labels_[c].low, labels_[d].low); }
+  }
+}
+
+/**
+* Depth-first search of the condensation from component `from` for
+* component `to`, which never enters a component numbered above `to` or
+* one whose labels show it cannot reach `to`
+*/
+bool ReachabilityIndex::_search(uint32_t from, uint32_t to) const {
+  const CsrGraph & dag = scc_.condensation();
+  std::vector<bool> visited(to - from + 1, false);
+  std::vector<uint32_t> stack{ from };
+  visited[0] = true;
+  while (!stack.empty()) {
+    uint32_t c = stack.back();
+    stack.pop_back();
+    for (uint32_t d : dag.neighbors(c)) {
+      if (d > to || visited[d - from]) { continue; }
+      if (_treeReaches(d, to)) { return true; }
+      if (!_mayReach(d, to)) { continue; }
+      visited[d - from] = true;
+      stack.push_back(d);
+    }
+  }
+  return false;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CsrGraph.h"
+#include "StronglyConnectedComponents.h"
+
+/**
+ * Answers "is `to` reachable from `from`?" and "can `v` still reach an
+ * ending?" for a directed graph without a traversal per question.
+ *
+ * The index is built over the condensation (see StronglyConnectedComponents):
+ * two vertices of one component reach each other, and because components
+ * are numbered in topological order, no component reaches a lower one.
+ * For the remaining pairs it stores the transitive closure of the
+ * condensation as one bitset per component, holding only the bits from the
+ * component's own number up (the others are all zero), so a query is one
+ * bit test.  Building it takes O(|E| * |C| / 64) time for |C| components.
+ *
+ * If the bitsets would take more than `maxBytes`, they are not built.
+ * Instead, one depth-first search of the condensation gives every
+ * component three post-order numbers, in O(|V| + |E|) time and 12 bytes
+ * per component:
+ *  - `post`, its own number;
+ *  - `treeLow`, the lowest number in its subtree of the search forest, so
+ *    a component numbered in [treeLow, post] is reachable (exact for
+ *    every pair in a tree or a chain); and
+ *  - `low`, the lowest number of any component it reaches, so one
+ *    numbered outside [low, post] is not.
+ * A pair neither label decides is searched, skipping components numbered
+ * above `to`'s and components whose labels rule `to` out.  `reachesEnding`
+ * is always O(1).
+ */
+class ReachabilityIndex {
+  public:
+    static constexpr size_t DEFAULT_MAX_BYTES = 256 << 20;
+
+    explicit ReachabilityIndex(const CsrGraph & g, size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    /**
+     * @return true, if there is a path (possibly empty) from `from` to `to`.
+     */
+    bool reachable(uint32_t from, uint32_t to) const;
+
+    /**
+     * @return true, if a path from `v` leads to an ending: a vertex with no
+     * out-neighbors.
+     */
+    bool reachesEnding(uint32_t v) const { return reachesEnding_[scc_.component(v)]; }
+
+    /**
+     * @return true, if the closure bitsets were built (rather than the
+     * post-order labels).
+     */
+    bool indexed() const { return !rowOffsets_.empty(); }
+
+    const StronglyConnectedComponents & components() const { return scc_; }
+
+  private:
+    StronglyConnectedComponents scc_;
+    std::vector<bool> reachesEnding_;  /*< By component */
+    std::vector<size_t> rowOffsets_;   /*< Where the bitset of each component starts in `bits_` */
+    std::vector<uint64_t> bits_;
+
+    class Label {
+      public:
+        uint32_t post;
+        uint32_t treeLow;
+        uint32_t low;
+    };
+    std::vector<Label> labels_;        /*< By component, if not indexed() */
+
+    void _buildLabels();
+    bool _treeReaches(uint32_t from, uint32_t to) const {
+      return labels_[from].treeLow <= labels_[to].post && labels_[to].post <= labels_[from].post;
+    }
+    bool _mayReach(uint32_t from, uint32_t to) const {
+      return labels_[from].low <= labels_[to].post && labels_[to].post <= labels_[from].post;
+    }
+    bool _search(uint32_t from, uint32_t to) const;
+};
@@ -0,0 +1,278 @@
+#include "RouteStatistics.h"
+#include "Trace.h"
+
+#include <utility>
+
+/**
+* Factors the k x k row-major matrix `a` in place into L and U, by Gaussian
+* elimination with partial pivoting; `pivot[j]` is the row swapped with j
+*/
+static void factorLU(std::vector<double> & a, uint32_t k, std::vector<uint32_t> & pivot) {
+  pivot.resize(k);
+  for (uint32_t j = 0; j < k; j++) {
+    uint32_t p = j;
+    for (uint32_t i = j + 1; i < k; i++) {
+      if (std::abs(a[size_t(i) * k + j]) > std::abs(a[size_t(p) * k + j])) { p = i; }
+    }
+    pivot[j] = p;
+    if (p != j) { std::swap_ranges(a.begin() + size_t(j) * k, a.begin() + size_t(j + 1) * k, a.begin() + size_t(p) * k); }
+
+    const double * row = &a[size_t(j) * k];
+    for (uint32_t i = j + 1; i < k; i++) {
+      double * other = &a[size_t(i) * k];
+      double factor = other[j] /= row[j];
+      if (factor == 0) { continue; }
+      for (uint32_t c = j + 1; c < k; c++) { other[c] -= factor * row[c]; }
+    }
+  }
+}
+
+/**
+* Solves a x = b, for `a` factored by factorLU, replacing b with x
+*/
+static void solveLU(const std::vector<double> & a, uint32_t k, const std::vector<uint32_t> & pivot, std::vector<double> & b) {
+  for (uint32_t j = 0; j < k; j++) { std::swap(b[j], b[pivot[j]]); }
+  for (uint32_t i = 0; i < k; i++) {
+    for (uint32_t c = 0; c < i; c++) { b[i] -= a[size_t(i) * k + c] * b[c]; }
+  }
+  for (uint32_t i = k; i-- > 0; ) {
+    for (uint32_t c = i + 1; c < k; c++) { b[i] -= a[size_t(i) * k + c] * b[c]; }
+    b[i] /= a[size_t(i) * k + i];
+  }
+}
+
+RouteStatistics::RouteStatistics(const CsrGraph & g) : scc_(g), predecessors_(g.transpose()), converged_(true) {
+  TRACE_SPAN("RouteStatistics", "traverse");
+  uint32_t n = g.numVertices();
+  uint32_t count = scc_.count();
+
+  degree_.resize(n);
+  for (uint32_t v = 0; v < n; v++) { degree_[v] = g.degree(v); }
+  cyclic_.assign(count, false);
+  for (uint32_t c = 0; c < count; c++) {
+    for (uint32_t v : scc_.members(c)) {
+      for (uint32_t w : g.neighbors(v)) {
+        if (scc_.component(w) == c) { cyclic_[c] = true; }
+      }
+    }
+  }
+
+  routes_.assign(n, 0);
+  maxLength_.assign(n, NONE);
+  probability_.assign(n, 0);
+  lengthSum_.assign(n, 0);
+  std::vector<uint32_t> index(n);  /*< Of each vertex among the members of its loop */
+
+  // Successors are in later components, so they are done first:
+  for (uint32_t c = count; c-- > 0; ) {
+    CsrGraph::Range members = scc_.members(c);
+
+    if (!cyclic_[c]) {
+      uint32_t v = *members.begin();
+      if (degree_[v] == 0) {
+        routes_[v] = 1;
+        maxLength_[v] = 0;
+        probability_[v] = 1;
+        continue;
+      }
+      for (uint32_t w : g.neighbors(v)) {
+        routes_[v] = _add(routes_[v], routes_[w]);
+        if (maxLength_[w] == NONE) { continue; }
+        uint32_t length = (maxLength_[w] == UNBOUNDED) ? UNBOUNDED : maxLength_[w] + 1;
+        if (maxLength_[v] == NONE || length > maxLength_[v]) { maxLength_[v] = length; }
+        probability_[v] += probability_[w] / degree_[v];
+        lengthSum_[v] += (probability_[w] + lengthSum_[w]) / degree_[v];
+      }
+      continue;
+    }
+
+    // A loop either leads out to an ending or traps the reader:
+    bool escapes = false;
+    for (uint32_t v : members) {
+      for (uint32_t w : g.neighbors(v)) {
+        if (scc_.component(w) != c && routes_[w] != 0) { escapes = true; }
+      }
+    }
+    if (!escapes) { continue; }
+    for (uint32_t v : members) {
+      routes_[v] = INFINITE;
+      maxLength_[v] = UNBOUNDED;
+    }
+
+    // Each probability (and length sum) is the average of its neighbors':
+    uint32_t k = members.size();
+    if (k <= DIRECT_LIMIT) {
+      uint32_t i = 0;
+      for (uint32_t v : members) { index[v] = i++; }
+      std::vector<double> a(size_t(k) * k, 0), probability(k, 0), lengthSum(k, 0);
+      std::vector<uint32_t> pivot;
+      i = 0;
+      for (uint32_t v : members) {
+        a[size_t(i) * k + i] += 1;
+        for (uint32_t w : g.neighbors(v)) {
+          if (scc_.component(w) == c) {
+            a[size_t(i) * k + index[w]] -= 1.0 / degree_[v];
+          } else {
+            probability[i] += probability_[w] / degree_[v];
+            lengthSum[i] += (probability_[w] + lengthSum_[w]) / degree_[v];
+          }
+        }
+        i++;
+      }
+      factorLU(a, k, pivot);
+      solveLU(a, k, pivot, probability);
+
+      // The lengths of choices inside the loop need its probabilities:
+      i = 0;
+      for (uint32_t v : members) {
+        for (uint32_t w : g.neighbors(v)) {
+          if (scc_.component(w) == c) { lengthSum[i] += probability[index[w]] / degree_[v]; }
+        }
+        i++;
+      }
+      solveLU(a, k, pivot, lengthSum);
+
+      i = 0;
+      for (uint32_t v : members) {
+        probability_[v] = probability[i];
+        lengthSum_[v] = lengthSum[i];
+        i++;
+      }
+      continue;
+    }
+
+    bool converged = false;
+    for (unsigned int sweep = 0; sweep < MAX_SWEEPS && !converged; sweep++) {
+      converged = true;
+      for (uint32_t v : members) {
+        double probability = 0, lengthSum = 0;
+        for (uint32_t w : g.neighbors(v)) {
+          probability += probability_[w] / degree_[v];
+          lengthSum += (probability_[w] + lengthSum_[w]) / degree_[v];
+        }
+        converged = converged && _converged(probability_[v], probability) && _converged(lengthSum_[v], lengthSum);
+        probability_[v] = probability;
+        lengthSum_[v] = lengthSum;
+      }
+    }
+    if (!converged) { converged_ = false; }
+  }
+
+  // Shortest routes, by a breadth-first search back from every ending:
+  minLength_.assign(n, NONE);
+  std::vector<uint32_t> queue;
+  for (uint32_t v = 0; v < n; v++) {
+    if (degree_[v] == 0) {
+      minLength_[v] = 0;
+      queue.push_back(v);
+    }
+  }
+  for (size_t head = 0; head < queue.size(); head++) {
+    uint32_t v = queue[head];
+    for (uint32_t u : predecessors_.neighbors(v)) {
+      if (minLength_[u] == NONE) {
+        minLength_[u] = minLength_[v] + 1;
+        queue.push_back(u);
+      }
+    }
+  }
+}
+
+double RouteStatistics::expectedLength(uint32_t v) const {
+  if (probability_[v] == 0) { return std::numeric_limits<double>::infinity(); }
+  return lengthSum_[v] / probability_[v];
+}
+
+/**
+* The same sweep forwards from `start`: the routes to each vertex, and the
+* expected number of times a reader visits it (which, at an ending, is the
+* probability of ending there)
+*/
+std::vector<RouteStatistics::Outcome> RouteStatistics::outcomes(uint32_t start) const {
+  uint32_t n = predecessors_.numVertices();
+  uint32_t count = scc_.count();
+  std::vector<Count> routes(n, 0);
+  std::vector<double> visits(n, 0);
+  std::vector<uint32_t> index(n);
+  std::vector<Outcome> result;
+  bool converged = true;
+
+  for (uint32_t c = scc_.component(start); c < count; c++) {
+    CsrGraph::Range members = scc_.members(c);
+
+    if (!cyclic_[c]) {
+      uint32_t v = *members.begin();
+      if (v == start) {
+        routes[v] = 1;
+        visits[v] = 1;
+      }
+      for (uint32_t u : predecessors_.neighbors(v)) {
+        routes[v] = _add(routes[v], routes[u]);
+        visits[v] += visits[u] / degree_[u];
+      }
+      if (degree_[v] == 0 && routes[v] != 0) { result.push_back(Outcome{ v, routes[v], visits[v], true }); }
+      continue;
+    }
+
+    // A loop the reader can enter can be gone round any number of times:
+    bool entered = false;
+    for (uint32_t v : members) {
+      if (v == start) { entered = true; }
+      for (uint32_t u : predecessors_.neighbors(v)) {
+        if (scc_.component(u) != c && routes[u] != 0) { entered = true; }
+      }
+    }
+    // (A trap is never left, so its visits do not matter.)
+    if (!entered || scc_.condensation().degree(c) == 0) { continue; }
+    for (uint32_t v : members) { routes[v] = INFINITE; }
+
+    // Each vertex is visited as often as its predecessors choose it:
+    uint32_t k = members.size();
+    if (k <= DIRECT_LIMIT) {
+      uint32_t i = 0;
+      for (uint32_t v : members) { index[v] = i++; }
+      std::vector<double> a(size_t(k) * k, 0), expected(k, 0);
+      std::vector<uint32_t> pivot;
+      i = 0;
+      for (uint32_t v : members) {
+        a[size_t(i) * k + i] += 1;
+        if (v == start) { expected[i] = 1; }
+        for (uint32_t u : predecessors_.neighbors(v)) {
+          if (scc_.component(u) == c) { a[size_t(i) * k + index[u]] -= 1.0 / degree_[u]; }
+          else                        { expected[i] += visits[u] / degree_[u]; }
+        }
+        i++;
+      }
+      factorLU(a, k, pivot);
+      solveLU(a, k, pivot, expected);
+      i = 0;
+      for (uint32_t v : members) { visits[v] = expected[i++]; }
+      continue;
+    }
+
+    bool settled = false;
+    for (unsigned int sweep = 0; sweep < MAX_SWEEPS && !settled; sweep++) {
+      settled = true;
+      for (uint32_t v : members) {
+        double expected = (v == start) ? 1 : 0;
+        for (uint32_t u : predecessors_.neighbors(v)) { expected += visits[u] / degree_[u]; }
+        settled = settled && _converged(visits[v], expected);
+        visits[v] = expected;
+      }
+    }
+    if (!settled) { converged = false; }
+  }
+
+  for (Outcome & outcome : result) { outcome.converged = converged; }
+  return result;
+}
+
+std::string RouteStatistics::toString(Count count) {
+  if (count == INFINITE) { return "infinite"; }
+  std::string digits;
+  do {
+    digits.insert(digits.begin(), char('0' + count % 10));
+    count /= 10;
+  } while (count != 0);
+  return digits;
+}
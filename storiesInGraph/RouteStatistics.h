@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "CsrGraph.h"
+#include "StronglyConnectedComponents.h"
+
+/**
+ * Statistics of the routes from each vertex of a story to its endings
+ * (vertices with no out-neighbors): how many routes there are, how long
+ * they are, and where a reader who picks each choice with equal
+ * probability ends up.
+ *
+ * Everything is computed by dynamic programming over the strongly
+ * connected components, one sweep in (reverse) topological order, instead
+ * of by enumerating routes.  A component without a cycle is one vertex,
+ * whose values follow from its neighbors'.  A loop that can reach an
+ * ending has infinitely many routes of unbounded length, and since a
+ * reader can go round it any number of times, the probabilities around it
+ * are a linear system: solved exactly, by LU decomposition, for a loop of
+ * up to DIRECT_LIMIT vertices, and by Gauss-Seidel iteration (to within
+ * `TOLERANCE`, for at most MAX_SWEEPS sweeps) for a larger one.  Iteration
+ * that runs out of sweeps is reported by `converged()`.
+ *
+ * Route counts are 128 bits wide, and saturate at INFINITE rather than
+ * overflow.
+ */
+class RouteStatistics {
+  public:
+    __extension__ typedef unsigned __int128 Count;
+
+    static constexpr Count INFINITE = ~Count(0);            /*< Routes can loop (or there are at least 2^128 - 1) */
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();  /*< No route to an ending */
+    static constexpr uint32_t UNBOUNDED = NONE - 1;         /*< Routes can loop */
+    static constexpr double TOLERANCE = 1e-12;
+    static constexpr uint32_t DIRECT_LIMIT = 512;           /*< The largest loop solved exactly, in O(k^3) */
+    static constexpr unsigned int MAX_SWEEPS = 100000;
+
+    /**
+     * Where readers from one start vertex end up.
+     */
+    class Outcome {
+      public:
+        uint32_t ending;
+        Count routes;        /*< From the start to this ending */
+        double probability;  /*< Of ending here, choosing uniformly */
+        bool converged;      /*< false: `probability` is approximate (see `converged()`) */
+    };
+
+    explicit RouteStatistics(const CsrGraph & g);
+
+    /**
+     * @return The number of routes from `v` to any ending (1 at an ending).
+     */
+    Count routes(uint32_t v) const { return routes_[v]; }
+
+    /**
+     * @return The number of choices on the shortest route from `v` to an
+     * ending, or NONE if there is no route.
+     */
+    uint32_t minLength(uint32_t v) const { return minLength_[v]; }
+
+    /**
+     * @return The number of choices on the longest route from `v` to an
+     * ending, UNBOUNDED if routes can loop, or NONE if there is no route.
+     */
+    uint32_t maxLength(uint32_t v) const { return maxLength_[v]; }
+
+    /**
+     * @return The probability that a reader at `v` reaches an ending,
+     * choosing uniformly (below 1 if some choices lead into a trap).
+     */
+    double endingProbability(uint32_t v) const { return probability_[v]; }
+
+    /**
+     * @return The expected number of choices from `v` among readers who
+     * reach an ending, or infinity if none do.
+     */
+    double expectedLength(uint32_t v) const;
+
+    /**
+     * @return false, if the probabilities and expected lengths around some
+     * loop larger than DIRECT_LIMIT did not settle within MAX_SWEEPS sweeps,
+     * so `endingProbability` and `expectedLength` are approximate.
+     */
+    bool converged() const { return converged_; }
+
+    /**
+     * @return Every ending that can be reached from `start`, with the
+     * number of routes to it and the probability of ending there.  Takes
+     * O(|V| + |E|), plus O(k^3) for each loop of k <= DIRECT_LIMIT vertices
+     * the reader can enter, or up to MAX_SWEEPS sweeps of a larger one.
+     */
+    std::vector<Outcome> outcomes(uint32_t start) const;
+
+    /**
+     * @return `count` in decimal, or "infinite".
+     */
+    static std::string toString(Count count);
+
+  private:
+    StronglyConnectedComponents scc_;
+    CsrGraph predecessors_;
+    std::vector<uint32_t> degree_;
+    std::vector<bool> cyclic_;           /*< By component: a loop (or self-loop) */
+    std::vector<Count> routes_;
+    std::vector<uint32_t> minLength_;
+    std::vector<uint32_t> maxLength_;
+    std::vector<double> probability_;
+    std::vector<double> lengthSum_;      /*< The expected length, weighted by the probability */
+    bool converged_;
+
+    static Count _add(Count a, Count b) { return (a > INFINITE - b) ? INFINITE : a + b; }
+    static bool _converged(double before, double after) {
+      return std::abs(after - before) <= TOLERANCE * std::max(1.0, std::abs(after));
+    }
+};
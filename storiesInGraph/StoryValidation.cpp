@@ -0,0 +1,39 @@
+#include "StoryValidation.h"
+
+#include <iostream>
+
+StoryValidation::Severity StoryValidation::result() const {
+  Severity result = PASS;
+  for (const Diagnostic & d : diagnostics_) {
+    if (d.severity < result) { result = d.severity; }
+  }
+  return result;
+}
+
+unsigned int StoryValidation::count(Check check) const {
+  unsigned int count = 0;
+  for (const Diagnostic & d : diagnostics_) {
+    if (d.check == check) { count++; }
+  }
+  return count;
+}
+
+std::ostream & operator<<(std::ostream & out, const StoryValidation & validation) {
+  for (const StoryValidation::Diagnostic & d : validation.diagnostics_) {
+    out << (d.severity == StoryValidation::ERR ? "ERR: " : "WARN: ");
+    if (d.file.length() > 0) {
+      out << d.file << ".md";
+      if (d.line > 0) { out << ":" << d.line; }
+      out << ": ";
+    }
+    out << d.message << std::endl;
+  }
+
+  switch (validation.result()) {
+    case StoryValidation::PASS: out << "Validation completed with no errors or warnings." << std::endl; break;
+    case StoryValidation::WARN: out << "Validation completed with warnings." << std::endl; break;
+    case StoryValidation::ERR:  out << "Validation completed with errors." << std::endl; break;
+  }
+
+  return out;
+}
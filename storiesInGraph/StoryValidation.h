@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+/**
+ * The result of validating a story directory while it is loaded by `CYOA`.
+ *
+ * Performs the same checks as `story_validator.py`, but every problem is
+ * recorded as a Diagnostic instead of being printed (or ending the run),
+ * so callers can inspect the full set of issues after one load.
+ *
+ * The rules read the files exactly as story_validator.py does: only a line
+ * starting with "# " is a choice, and every such line counts, repeats
+ * included.  The loaded graph keeps `CYOA`'s own reading, which differs on
+ * purpose in two ways:
+ *  - any line starting with `#` after trimming is a choice (the `#x` and
+ *    ` # x` lines the validator warns about or treats as text), and
+ *  - a repeated choice is one edge, with the text of its last occurrence.
+ */
+class StoryValidation {
+  public:
+    /**
+     * Severity of a diagnostic, ordered like the `results` in story_validator.py.
+     */
+    enum Severity { ERR = 0, WARN = 1, PASS = 2 };
+
+    /**
+     * The rule a diagnostic was raised by.
+     */
+    enum Check {
+      UNREADABLE_FILE,      /*< A .md file could not be opened */
+      TEMPLATE_FILE,        /*< A waf-*.md file from the template is present */
+      EMPTY_FILE,           /*< A file has no lines, or its first line is a choice */
+      MALFORMED_CHOICE,     /*< A line begins with `#` not followed by a space */
+      DANGLING_CHOICE,      /*< A choice refers to a file that does not exist */
+      TOO_MANY_CHOICES,     /*< A narrative has more than 10 choices */
+      NO_ENDING,            /*< No narrative without outgoing choices */
+      NO_THREE_CHOICES,     /*< No narrative with at least 3 choices */
+      START_COUNT,          /*< Not exactly one narrative without incoming choices */
+      TOO_FEW_NARRATIVES,   /*< Fewer than 8 narratives */
+      TOO_FEW_CHOICES       /*< Fewer than 13 choices */
+    };
+
+    class Diagnostic {
+      public:
+        Severity severity;
+        Check check;
+        std::string file;     /*< Story key (file name without .md), or empty for whole-story checks */
+        unsigned int line;    /*< 1-based line number in `file`, or 0 if not tied to a line */
+        std::string message;
+    };
+
+    /**
+     * Records a diagnostic.
+     */
+    void add(Severity severity, Check check, const std::string & file, unsigned int line, const std::string & message) {
+      diagnostics_.push_back(Diagnostic{ severity, check, file, line, message });
+    }
+
+    /**
+     * Appends every diagnostic of `other` to this result.
+     */
+    void merge(const StoryValidation & other) {
+      diagnostics_.insert(diagnostics_.end(), other.diagnostics_.begin(), other.diagnostics_.end());
+    }
+
+    /**
+     * Removes every diagnostic.
+     */
+    void clear() { diagnostics_.clear(); }
+
+    /**
+     * @return The most severe diagnostic level, or PASS if there are none.
+     */
+    Severity result() const;
+
+    /**
+     * @return `true` if no errors were found (warnings are allowed).
+     */
+    bool passed() const { return result() != ERR; }
+
+    /**
+     * @return The number of diagnostics raised by `check`.
+     */
+    unsigned int count(Check check) const;
+
+    /**
+     * @return Every diagnostic, in the order it was found.
+     */
+    const std::vector<Diagnostic> & diagnostics() const { return diagnostics_; }
+
+    /**
+     * Prints every diagnostic followed by a summary line, in the format of story_validator.py.
+     */
+    friend std::ostream & operator<<(std::ostream & out, const StoryValidation & validation);
+
+  private:
+    std::vector<Diagnostic> diagnostics_;
+};
@@ -0,0 +1,94 @@
+#include "StronglyConnectedComponents.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <limits>
+
+StronglyConnectedComponents::StronglyConnectedComponents(const CsrGraph & g) {
+  TRACE_SPAN("StronglyConnectedComponents", "traverse");
+  const uint32_t UNVISITED = std::numeric_limits<uint32_t>::max();
+  uint32_t n = g.numVertices();
+
+  // Tarjan's algorithm, with the recursion kept in `calls`:
+  class Call {
+    public:
+      uint32_t v;
+      const uint32_t * next;  /*< The next neighbor of `v` to look at */
+  };
+  std::vector<Call> calls;
+  std::vector<uint32_t> index(n, UNVISITED);
+  std::vector<uint32_t> low(n);
+  std::vector<bool> onStack(n, false);
+  std::vector<uint32_t> stack;
+  uint32_t nextIndex = 0;
+  uint32_t found = 0;
+  component_.assign(n, 0);
+
+  auto visit = [&](uint32_t v) {
+    index[v] = low[v] = nextIndex++;
+    stack.push_back(v);
+    onStack[v] = true;
+    calls.push_back(Call{ v, g.neighbors(v).begin() });
+  };
+
+  for (uint32_t root = 0; root < n; root++) {
+    if (index[root] != UNVISITED) { continue; }
+    visit(root);
+
+    while (!calls.empty()) {
+      Call & call = calls.back();
+      uint32_t v = call.v;
+      if (call.next != g.neighbors(v).end()) {
+        uint32_t w = *call.next++;
+        if (index[w] == UNVISITED) { visit(w); }
+        else if (onStack[w]) { low[v] = std::min(low[v], index[w]); }
+        continue;
+      }
+
+      calls.pop_back();
+      if (low[v] == index[v]) {
+        uint32_t w;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          onStack[w] = false;
+          component_[w] = found;
+        } while (w != v);
+        found++;
+      }
+      if (!calls.empty()) {
+        uint32_t parent = calls.back().v;
+        low[parent] = std::min(low[parent], low[v]);
+      }
+    }
+  }
+
+  // Tarjan's algorithm finds a component only after every component it
+  // reaches, so reversing the numbering makes it topological:
+  for (uint32_t & c : component_) { c = found - 1 - c; }
+
+  offsets_.assign(found + 1, 0);
+  for (uint32_t c : component_) { offsets_[c + 1]++; }
+  for (uint32_t c = 0; c < found; c++) { offsets_[c + 1] += offsets_[c]; }
+  members_.resize(n);
+  std::vector<uint32_t> next(offsets_.begin(), offsets_.end() - 1);
+  for (uint32_t v = 0; v < n; v++) { members_[next[component_[v]]++] = v; }
+
+  // One edge per pair of adjacent components; `seen[d] == c` once c -> d is added:
+  std::vector<size_t> offsets(1, 0);
+  std::vector<uint32_t> targets;
+  std::vector<uint32_t> seen(found, UNVISITED);
+  for (uint32_t c = 0; c < found; c++) {
+    for (uint32_t v : members(c)) {
+      for (uint32_t w : g.neighbors(v)) {
+        uint32_t d = component_[w];
+        if (d != c && seen[d] != c) {
+          seen[d] = c;
+          targets.push_back(d);
+        }
+      }
+    }
+    offsets.push_back(targets.size());
+  }
+  condensation_ = CsrGraph(std::move(offsets), std::move(targets));
+}
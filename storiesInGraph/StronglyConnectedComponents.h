@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CsrGraph.h"
+
+/**
+ * The strongly connected components of a directed graph, and its
+ * condensation: the DAG with one vertex per component and an edge wherever
+ * an edge of the graph joins two components.
+ *
+ * In a story, a component of several passages is a loop the reader can go
+ * around ("go back to the crossroads").  A loop with no edge out of it in
+ * the condensation is a region the reader cannot escape, and a component
+ * other than the start's with no edge into it cannot be reached.
+ *
+ * Components are found with an iterative Tarjan's algorithm in
+ * O(|V| + |E|), so deep graphs of millions of vertices do not overflow the
+ * stack.  They are numbered in topological order: every edge of the
+ * condensation goes from a lower to a higher component.
+ */
+class StronglyConnectedComponents {
+  public:
+    explicit StronglyConnectedComponents(const CsrGraph & g);
+
+    uint32_t count() const { return condensation_.numVertices(); }
+
+    /**
+     * @return The component of vertex `v`.
+     */
+    uint32_t component(uint32_t v) const { return component_[v]; }
+
+    /**
+     * @return The number of vertices in component `c`.
+     */
+    uint32_t size(uint32_t c) const { return offsets_[c + 1] - offsets_[c]; }
+
+    /**
+     * @return The vertices of component `c`.
+     */
+    CsrGraph::Range members(uint32_t c) const {
+      return CsrGraph::Range{ members_.data() + offsets_[c], members_.data() + offsets_[c + 1] };
+    }
+
+    /**
+     * @return The condensation, whose vertex `c` is component `c` (without
+     * self-loops or parallel edges).
+     */
+    const CsrGraph & condensation() const { return condensation_; }
+
+  private:
+    std::vector<uint32_t> component_;
+    std::vector<uint32_t> offsets_;   /*< Component `c` is members_[offsets_[c] .. offsets_[c+1]) */
+    std::vector<uint32_t> members_;
+    CsrGraph condensation_;
+};
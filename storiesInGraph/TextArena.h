@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+/**
+ * Append-only storage for story text.
+ *
+ * Text is copied into large blocks that are never reallocated, so every
+ * `std::string_view` handed out stays valid until the arena is cleared or
+ * destroyed.  Many small passages therefore cost one allocation per block
+ * instead of one allocation per string.
+ */
+class TextArena {
+  public:
+    TextArena(size_t blockSize = 1 << 16) : blockSize_(blockSize), used_(0), capacity_(0) { }
+
+    TextArena(const TextArena & other) = delete;
+    TextArena & operator=(const TextArena & other) = delete;
+    TextArena(TextArena && other) = default;
+    TextArena & operator=(TextArena && other) = default;
+
+    /**
+     * Copies `text` into the arena.
+     * @return A view of the arena-owned copy.
+     */
+    std::string_view append(std::string_view text) {
+      if (text.empty()) { return std::string_view(); }
+
+      char * out = reserve_(text.size());
+      std::memcpy(out, text.data(), text.size());
+      return std::string_view(out, text.size());
+    }
+
+    /**
+     * Copies every piece into the arena as one contiguous string, with
+     * `separator` placed before each piece (the CYOA content format).
+     * @return A view of the joined, arena-owned string.
+     */
+    std::string_view join(const std::vector<std::string_view> & pieces, char separator) {
+      size_t length = 0;
+      for (const std::string_view & piece : pieces) { length += piece.size() + 1; }
+      if (length == 0) { return std::string_view(); }
+
+      char * out = reserve_(length);
+      char * cur = out;
+      for (const std::string_view & piece : pieces) {
+        *cur++ = separator;
+        std::memcpy(cur, piece.data(), piece.size());
+        cur += piece.size();
+      }
+      return std::string_view(out, length);
+    }
+
+    /**
+     * Releases all text.  Views handed out earlier become invalid.
+     */
+    void clear() {
+      blocks_.clear();
+      used_ = 0;
+      capacity_ = 0;
+    }
+
+    /**
+     * @return The number of bytes allocated for blocks.
+     */
+    size_t bytesAllocated() const {
+      size_t total = 0;
+      for (const Block & block : blocks_) { total += block.size; }
+      return total;
+    }
+
+  private:
+    struct Block {
+      std::unique_ptr<char[]> data;
+      size_t size;
+    };
+
+    size_t blockSize_;
+    size_t used_;
+    size_t capacity_;
+    std::vector<Block> blocks_;
+
+    char * reserve_(size_t n) {
+      if (blocks_.empty() || capacity_ - used_ < n) {
+        // Oversized strings get a block of their own so the current block
+        // can keep filling up:
+        if (n > blockSize_ / 4 && !blocks_.empty()) {
+          blocks_.insert(blocks_.end() - 1, Block{ std::unique_ptr<char[]>(new char[n]), n });
+          return blocks_[blocks_.size() - 2].data.get();
+        }
+
+        size_t size = (n > blockSize_) ? n : blockSize_;
+        blocks_.push_back(Block{ std::unique_ptr<char[]>(new char[size]), size });
+        used_ = 0;
+        capacity_ = size;
+      }
+
+      char * out = blocks_.back().data.get() + used_;
+      used_ += n;
+      return out;
+    }
+};
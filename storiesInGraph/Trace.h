@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Timeline tracing, exported as Chrome `trace_event` JSON (open the file in
+ * chrome://tracing or https://ui.perfetto.dev).
+ *
+ * A `TRACE_SPAN(name, category)` records the time from its declaration to
+ * the end of the enclosing scope.  Nothing is recorded until
+ * `Trace::enable()` is called, and until then a span costs one atomic
+ * load.  Each thread appends finished spans to its own ring buffer without
+ * locking, and the oldest spans of a thread are overwritten once it has
+ * recorded `Trace::CAPACITY` of them.  When a thread exits its buffer, spans
+ * included, is handed to the next thread that records one, so there are
+ * only as many buffers as threads that were ever tracing at the same time
+ * (the spans of both threads then share a `tid`).
+ *
+ * Span names and categories must be string literals (only the pointers are
+ * stored).  The categories used in this project are "io", "parse", "graph"
+ * (mutation) and "traverse".
+ */
+class Trace {
+  public:
+    static constexpr size_t CAPACITY = 1 << 14;
+
+    /**
+     * Starts (or stops) recording spans.
+     */
+    static void enable(bool on = true) { enabled_.store(on, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Drops every recorded span.  Call this while no span is being recorded.
+     */
+    static void clear() {
+      std::lock_guard<std::mutex> lock(registryMutex_);
+      for (const std::unique_ptr<Buffer> & buffer : registry_) { buffer->count.store(0, std::memory_order_release); }
+    }
+
+    /**
+     * @return The number of spans that can currently be written, over all threads.
+     */
+    static size_t size() {
+      std::lock_guard<std::mutex> lock(registryMutex_);
+      size_t total = 0;
+      for (const std::unique_ptr<Buffer> & buffer : registry_) { total += buffer->size(); }
+      return total;
+    }
+
+    /**
+     * @return The number of per-thread buffers allocated so far.
+     */
+    static size_t buffers() {
+      std::lock_guard<std::mutex> lock(registryMutex_);
+      return registry_.size();
+    }
+
+    /**
+     * Writes every recorded span to `out` as a Chrome trace.  Other threads
+     * may keep recording while this runs: spans they record meanwhile may be
+     * missing, and spans they overwrite meanwhile are left out.
+     */
+    static void write(std::ostream & out) {
+      std::lock_guard<std::mutex> lock(registryMutex_);
+      out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+      bool first = true;
+      std::vector<Event> events;
+      for (const std::unique_ptr<Buffer> & buffer : registry_) {
+        buffer->snapshot(events);
+        for (const Event & e : events) {
+          out << (first ? "\n" : ",\n");
+          out << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\""
+              << ",\"ts\":" << micros(e.start) << ",\"dur\":" << micros(e.duration)
+              << ",\"pid\":1,\"tid\":" << buffer->tid << "}";
+          first = false;
+        }
+      }
+      out << "\n]}" << std::endl;
+    }
+
+    /**
+     * Writes the trace to the file `path`.
+     * @return true, if the file was written.
+     */
+    static bool writeToFile(const std::string & path) {
+      std::ofstream out(path);
+      if (!out) { return false; }
+      write(out);
+      return out.good();
+    }
+
+    /**
+     * Records the time from construction to destruction (see TRACE_SPAN).
+     */
+    class Span {
+      public:
+        Span(const char * name, const char * category) : name_(name), category_(category), start_(0), active_(enabled()) {
+          if (active_) { start_ = now(); }
+        }
+
+        ~Span() {
+          if (active_) { Trace::record(name_, category_, start_, now() - start_); }
+        }
+
+        Span(const Span & other) = delete;
+        Span & operator=(const Span & other) = delete;
+
+      private:
+        const char * name_;
+        const char * category_;
+        uint64_t start_;
+        bool active_;
+    };
+
+  private:
+    class Event {
+      public:
+        const char * name;
+        const char * category;
+        uint64_t start;     /*< ns since the first use of Trace */
+        uint64_t duration;  /*< ns */
+    };
+
+    // One per tracing thread; written only by the thread that owns it, and
+    // read by `write` while it may be written.  The fields of a slot are
+    // atomics (relaxed, so as cheap as plain stores) so that a slot being
+    // overwritten can be detected and skipped, as in a seqlock.
+    class Buffer {
+      public:
+        class Slot {
+          public:
+            std::atomic<const char *> name;
+            std::atomic<const char *> category;
+            std::atomic<uint64_t> start;
+            std::atomic<uint64_t> duration;
+        };
+
+        std::array<Slot, CAPACITY> slots;
+        std::atomic<uint64_t> count{0};
+        unsigned int tid = 0;
+        bool owned = false;   /*< Guarded by registryMutex_ */
+
+        size_t size() const {
+          uint64_t n = count.load(std::memory_order_acquire);
+          return n < CAPACITY ? n : CAPACITY;
+        }
+
+        // Called by the owning thread only:
+        void append(const char * name, const char * category, uint64_t start, uint64_t duration) {
+          uint64_t n = count.load(std::memory_order_relaxed);
+          // Orders the count of the previous span before this span's
+          // stores, for the fence in `snapshot`:
+          std::atomic_thread_fence(std::memory_order_release);
+          Slot & slot = slots[n % CAPACITY];
+          slot.name.store(name, std::memory_order_relaxed);
+          slot.category.store(category, std::memory_order_relaxed);
+          slot.start.store(start, std::memory_order_relaxed);
+          slot.duration.store(duration, std::memory_order_relaxed);
+          count.store(n + 1, std::memory_order_release);
+        }
+
+        // Copies the spans into `events`, oldest first, leaving out any slot
+        // the owner overwrote (or started to overwrite) during the copy:
+        void snapshot(std::vector<Event> & events) const {
+          events.clear();
+          uint64_t end = count.load(std::memory_order_acquire);
+          uint64_t begin = (end < CAPACITY) ? 0 : end - CAPACITY;
+          for (uint64_t i = begin; i < end; i++) {
+            const Slot & slot = slots[i % CAPACITY];
+            events.push_back(Event{ slot.name.load(std::memory_order_relaxed), slot.category.load(std::memory_order_relaxed),
+                                    slot.start.load(std::memory_order_relaxed), slot.duration.load(std::memory_order_relaxed) });
+          }
+
+          // Span `n` overwrites span `n - CAPACITY`, so with `now` spans
+          // published (and span `now` perhaps half written) every span
+          // before `now - CAPACITY + 1` may have changed under the copy:
+          std::atomic_thread_fence(std::memory_order_acquire);
+          uint64_t now = count.load(std::memory_order_relaxed);
+          uint64_t stale = (now + 1 < CAPACITY) ? 0 : now + 1 - CAPACITY;
+          if (stale > begin) { events.erase(events.begin(), events.begin() + std::min(stale - begin, end - begin)); }
+        }
+    };
+
+    // Returns the thread's buffer to the registry when the thread exits:
+    class Owner {
+      public:
+        Buffer * buffer = nullptr;
+        ~Owner() {
+          if (buffer == nullptr) { return; }
+          std::lock_guard<std::mutex> lock(registryMutex_);
+          buffer->owned = false;
+        }
+    };
+
+    static inline std::atomic<bool> enabled_{false};
+    static inline std::mutex registryMutex_;
+    static inline std::vector<std::unique_ptr<Buffer>> registry_;
+
+    // Chrome traces are in microseconds; keep the nanoseconds as decimals:
+    static std::string micros(uint64_t ns) {
+      std::string fraction = std::to_string(ns % 1000);
+      return std::to_string(ns / 1000) + "." + std::string(3 - fraction.size(), '0') + fraction;
+    }
+
+    static uint64_t now() {
+      static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    // A buffer no thread owns, or a new one:
+    static Buffer * acquire() {
+      std::lock_guard<std::mutex> lock(registryMutex_);
+      for (const std::unique_ptr<Buffer> & buffer : registry_) {
+        if (!buffer->owned) {
+          buffer->owned = true;
+          return buffer.get();
+        }
+      }
+      registry_.push_back(std::unique_ptr<Buffer>(new Buffer()));
+      Buffer * buffer = registry_.back().get();
+      buffer->tid = registry_.size();
+      buffer->owned = true;
+      return buffer;
+    }
+
+    static void record(const char * name, const char * category, uint64_t start, uint64_t duration) {
+      thread_local Owner owner;
+      if (owner.buffer == nullptr) { owner.buffer = acquire(); }
+      owner.buffer->append(name, category, start, duration);
+    }
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SPAN(name, category) Trace::Span TRACE_CONCAT(traceSpan_, __LINE__)(name, category)
@@ -30,6 +30,22 @@ class Vertex {
       return properties_[value];
     }
 
+    /**
+     * Returns the value of a key/value property of the Vertex, or an empty
+     * string if the property is not set.
+     */
+    string property(const string & name) const {
+      auto it = properties_.find(name);
+      return (it != properties_.end()) ? it->second : "";
+    }
+
+    /**
+     * Returns every key/value property of the Vertex.
+     */
+    const std::unordered_map<string, string> & properties() const {
+      return properties_;
+    }
+
     /**
      * Prints out the Vertex in a human-readable format to `out`
      */
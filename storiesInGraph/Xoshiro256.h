@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * The xoshiro256** generator of Blackman and Vigna: 64-bit outputs from
+ * 256 bits of state, a few instructions each, with a period of 2^256 - 1.
+ *
+ * Seeded from one 64-bit value through splitmix64 (so nearby seeds give
+ * unrelated states).  `jump()` advances the state by 2^128 outputs, which
+ * gives each thread its own stream that will not overlap the others.
+ */
+class Xoshiro256 {
+  public:
+    explicit Xoshiro256(uint64_t seed) {
+      for (uint64_t & word : s_) {
+        seed += 0x9e3779b97f4a7c15;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        word = z ^ (z >> 31);
+      }
+    }
+
+    uint64_t next() {
+      uint64_t result = _rotl(s_[1] * 5, 7) * 9;
+      uint64_t t = s_[1] << 17;
+      s_[2] ^= s_[0];
+      s_[3] ^= s_[1];
+      s_[1] ^= s_[2];
+      s_[0] ^= s_[3];
+      s_[2] ^= t;
+      s_[3] = _rotl(s_[3], 45);
+      return result;
+    }
+
+    /**
+     * @return A uniform double in [0, 1).
+     */
+    double uniform() { return (next() >> 11) * 0x1.0p-53; }
+
+    /**
+     * @return A uniform integer in [0, bound), for bound < 2^32.
+     */
+    uint32_t below(uint32_t bound) { return ((next() >> 32) * bound) >> 32; }
+
+    void jump() {
+      static const uint64_t JUMP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+      uint64_t t[4] = { 0, 0, 0, 0 };
+      for (uint64_t word : JUMP) {
+        for (int bit = 0; bit < 64; bit++) {
+          if (word & (uint64_t(1) << bit)) {
+            for (int i = 0; i < 4; i++) { t[i] ^= s_[i]; }
+          }
+          next();
+        }
+      }
+      for (int i = 0; i < 4; i++) { s_[i] = t[i]; }
+    }
+
+  private:
+    uint64_t s_[4];
+
+    static uint64_t _rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
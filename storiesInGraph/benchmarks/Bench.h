@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * Shared helpers for the `bench` suites.  Each suite is a subcommand of
+ * the bench binary (see BenchMain.cpp) and prints CSV to stdout.
+ */
+
+// Suites:
+int graphBench(int argc, char ** argv);
+int storyGen(int argc, char ** argv);
+int loadBench(int argc, char ** argv);
+int rankBench(int argc, char ** argv);
+
+class Timer {
+  public:
+    Timer() : start_(std::chrono::steady_clock::now()) { }
+    long long ns() const {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+    }
+    double ms() const { return ns() / 1e6; }
+  private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @return The peak resident set size of this process, in KB.
+ */
+inline long peakRssKb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+/**
+ * Runs `body` in a forked child process, so that memory it allocates (and
+ * the peak RSS it reaches) does not carry over into later measurements.
+ * @return true, if the child exited normally.
+ */
+inline bool runForked(const std::function<void()> & body) {
+  std::fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    body();
+    std::fflush(stdout);
+    _exit(0);
+  }
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
@@ -0,0 +1,21 @@
+#include "Bench.h"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char ** argv) {
+  std::string suite = (argc > 1) ? argv[1] : "";
+
+  if (suite == "graph")     { return graphBench(argc, argv); }
+  if (suite == "story-gen") { return storyGen(argc, argv); }
+  if (suite == "load")      { return loadBench(argc, argv); }
+  if (suite == "rank")      { return rankBench(argc, argv); }
+
+  std::cerr << "Usage: " << argv[0] << " <suite> [options]" << std::endl
+            << "  graph      Graph operations on synthetic graphs" << std::endl
+            << "  story-gen  Write a synthetic CYOA story directory" << std::endl
+            << "  load       CYOA::load end to end on a synthetic story" << std::endl
+            << "  rank       PageRank on synthetic graphs" << std::endl
+            << "Run a suite with --help for its options." << std::endl;
+  return 1;
+}
@@ -0,0 +1,246 @@
+/**
+ * Graph benchmark suite: `make bench && ./bench graph [options]`
+ *
+ * For every generator and size, a graph is built with insertVertex and
+ * insertEdge, then incidentEdges, isAdjacent, shortestPath, removeEdge and
+ * removeVertex are timed on random samples of vertices and edges.  Each
+ * (generator, size) case runs in its own forked process, so `peak_rss_kb`
+ * is the peak resident set of that case alone.
+ *
+ * Output is CSV, one row per operation:
+ *   generator,directed,vertices,edges,operation,ops,total_ns,ns_per_op,edges_per_sec,peak_rss_kb
+ * `edges_per_sec` counts the edges an operation touched: one per
+ * insertEdge/isAdjacent/removeEdge, the edges returned by incidentEdges,
+ * the edges removed by removeVertex, and |E| per shortestPath.
+ *
+ * With `--perf`, every row also has the hardware counters of the measured
+ * loop (see PerfCounters.h), with empty cells for unavailable counters:
+ *   ...,cycles,instructions,cache_misses,branch_misses,dtlb_misses
+ */
+
+#include "../Graph.h"
+#include "../Edge.h"
+#include "../DirectedEdge.h"
+#include "../Vertex.h"
+#include "../PerfCounters.h"
+#include "GraphGenerators.h"
+#include "Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+
+class BenchOptions {
+  public:
+    std::vector<std::string> generators{ "chain", "grid", "erdos-renyi", "rmat", "story-tree" };
+    size_t minEdges = 1000;
+    size_t maxEdges = 100000;
+    size_t samples = 1000;
+    size_t budgetMs = 500;
+    bool directed = false;
+    bool perf = false;
+    uint64_t seed = 1;
+};
+
+// Results of benchmarked calls are added here so they cannot be optimized away:
+static volatile unsigned long long sink;
+
+// Hardware counters of the running measurement, with --perf (opened by
+// runCase, in the forked process it measures):
+static PerfCounters * counters = nullptr;
+
+static Timer startMeasurement() {
+  if (counters != nullptr) { counters->start(); }
+  return Timer();
+}
+
+static void report(const GeneratedGraph & gen, const BenchOptions & opt, const char * operation,
+                   size_t ops, long long ns, unsigned long long edgesTouched) {
+  PerfCounters::Reading reading;
+  if (counters != nullptr) { reading = counters->stop(); }
+
+  double nsPerOp = ops > 0 ? double(ns) / ops : 0;
+  double edgesPerSec = ns > 0 ? edgesTouched * 1e9 / ns : 0;
+  std::printf("%s,%d,%u,%zu,%s,%zu,%lld,%.1f,%.0f,%ld", gen.name.c_str(), opt.directed ? 1 : 0,
+              gen.numVertices, gen.edges.size(), operation, ops, ns, nsPerOp, edgesPerSec, peakRssKb());
+  if (opt.perf) {
+    for (int e = 0; e < PerfCounters::NUM_EVENTS; e++) {
+      if (reading.available[e]) { std::printf(",%llu", (unsigned long long) reading.values[e]); }
+      else                      { std::printf(","); }
+    }
+  }
+  std::printf("\n");
+  std::fflush(stdout);
+}
+
+template <class E>
+static void runCase(const GeneratedGraph & gen, const BenchOptions & opt) {
+  // Counters count only the thread that opens them, so they cannot be
+  // opened before the fork:
+  PerfCounters perfCounters;
+  if (opt.perf) { counters = &perfCounters; }
+
+  std::mt19937_64 rng(opt.seed);
+  std::vector<std::string> keys(gen.numVertices);
+  for (uint32_t i = 0; i < gen.numVertices; i++) { keys[i] = GeneratedGraph::key(i); }
+
+  Graph<Vertex, E> g;
+
+  {
+    Timer t = startMeasurement();
+    for (uint32_t i = 0; i < gen.numVertices; i++) { g.insertVertex(keys[i]); }
+    report(gen, opt, "insertVertex", gen.numVertices, t.ns(), 0);
+  }
+
+  {
+    Timer t = startMeasurement();
+    for (auto & e : gen.edges) { g.insertEdge(keys[e.first], keys[e.second]); }
+    report(gen, opt, "insertEdge", gen.edges.size(), t.ns(), gen.edges.size());
+  }
+
+  std::uniform_int_distribution<uint32_t> vertex(0, gen.numVertices - 1);
+  std::uniform_int_distribution<size_t> edge(0, gen.edges.size() - 1);
+  const long long budget = (long long) opt.budgetMs * 1000000;
+
+  {
+    std::vector<uint32_t> sample(opt.samples);
+    for (uint32_t & v : sample) { v = vertex(rng); }
+
+    Timer t = startMeasurement();
+    size_t ops = 0;
+    unsigned long long touched = 0;
+    for (; ops < sample.size() && (ops == 0 || t.ns() < budget); ops++) {
+      touched += g.incidentEdges(keys[sample[ops]]).size();
+    }
+    report(gen, opt, "incidentEdges", ops, t.ns(), touched);
+  }
+
+  {
+    // Half existing edges, half random pairs:
+    std::vector<std::pair<uint32_t, uint32_t>> sample(opt.samples);
+    for (size_t i = 0; i < sample.size(); i++) {
+      sample[i] = (i % 2 == 0) ? gen.edges[edge(rng)] : std::make_pair(vertex(rng), vertex(rng));
+    }
+
+    Timer t = startMeasurement();
+    size_t ops = 0;
+    for (; ops < sample.size() && (ops == 0 || t.ns() < budget); ops++) {
+      sink += g.isAdjacent(keys[sample[ops].first], keys[sample[ops].second]);
+    }
+    report(gen, opt, "isAdjacent", ops, t.ns(), ops);
+  }
+
+  {
+    Timer t = startMeasurement();
+    size_t ops = 0;
+    for (; ops < opt.samples && (ops == 0 || t.ns() < budget); ops++) {
+      sink += g.shortestPath(keys[vertex(rng)], keys[vertex(rng)]).size();
+    }
+    report(gen, opt, "shortestPath", ops, t.ns(), (unsigned long long) ops * gen.edges.size());
+  }
+
+  {
+    std::vector<std::pair<uint32_t, uint32_t>> sample(gen.edges);
+    std::shuffle(sample.begin(), sample.end(), rng);
+    sample.resize(std::min(sample.size(), opt.samples));
+
+    Timer t = startMeasurement();
+    size_t ops = 0;
+    for (; ops < sample.size() && (ops == 0 || t.ns() < budget); ops++) {
+      g.removeEdge(keys[sample[ops].first], keys[sample[ops].second]);
+    }
+    report(gen, opt, "removeEdge", ops, t.ns(), ops);
+  }
+
+  {
+    std::vector<uint32_t> sample(gen.numVertices);
+    for (uint32_t i = 0; i < gen.numVertices; i++) { sample[i] = i; }
+    std::shuffle(sample.begin(), sample.end(), rng);
+    sample.resize(std::min<size_t>(sample.size(), opt.samples));
+
+    Timer t = startMeasurement();
+    size_t ops = 0;
+    unsigned long long touched = 0;
+    for (; ops < sample.size() && (ops == 0 || t.ns() < budget); ops++) {
+      unsigned int before = g.numEdges();
+      g.removeVertex(keys[sample[ops]]);
+      touched += before - g.numEdges();
+    }
+    report(gen, opt, "removeVertex", ops, t.ns(), touched);
+  }
+  counters = nullptr;
+}
+
+static void usage(const char * argv0) {
+  std::cerr << "Usage: " << argv0 << " graph [options]" << std::endl
+            << "  --generators a,b,...  chain, grid, erdos-renyi, rmat, story-tree (default: all)" << std::endl
+            << "  --min-edges N         smallest graph, in edges (default: 1000)" << std::endl
+            << "  --max-edges N         largest graph, in edges; sizes grow 10x (default: 100000, up to 1e7)" << std::endl
+            << "  --samples N           operations sampled per measurement (default: 1000)" << std::endl
+            << "  --budget-ms N         time limit per measurement (default: 500)" << std::endl
+            << "  --directed            use DirectedEdge instead of Edge" << std::endl
+            << "  --perf                add hardware counter columns (Linux perf_event_open)" << std::endl
+            << "  --seed N              generator and sampling seed (default: 1)" << std::endl;
+  std::exit(1);
+}
+
+int graphBench(int argc, char ** argv) {
+  BenchOptions opt;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--directed") { opt.directed = true; }
+    else if (arg == "--perf") { opt.perf = true; }
+    else if (arg == "--generators" && hasValue) {
+      opt.generators.clear();
+      std::string list = argv[++i];
+      for (size_t start = 0, end; start <= list.size(); start = end + 1) {
+        end = list.find(',', start);
+        if (end == std::string::npos) { end = list.size(); }
+        opt.generators.push_back(list.substr(start, end - start));
+      }
+    }
+    else if (arg == "--min-edges" && hasValue) { opt.minEdges = std::strtod(argv[++i], nullptr); }
+    else if (arg == "--max-edges" && hasValue) { opt.maxEdges = std::strtod(argv[++i], nullptr); }
+    else if (arg == "--samples" && hasValue)   { opt.samples = std::strtoull(argv[++i], nullptr, 10); }
+    else if (arg == "--budget-ms" && hasValue) { opt.budgetMs = std::strtoull(argv[++i], nullptr, 10); }
+    else if (arg == "--seed" && hasValue)      { opt.seed = std::strtoull(argv[++i], nullptr, 10); }
+    else { usage(argv[0]); }
+  }
+
+  for (const std::string & name : opt.generators) {
+    if (generators::byName(name) == nullptr) {
+      std::cerr << "Unknown generator: " << name << std::endl;
+      usage(argv[0]);
+    }
+  }
+
+  std::printf("generator,directed,vertices,edges,operation,ops,total_ns,ns_per_op,edges_per_sec,peak_rss_kb%s\n",
+              opt.perf ? ",cycles,instructions,cache_misses,branch_misses,dtlb_misses" : "");
+  std::fflush(stdout);
+
+  if (opt.perf && !PerfCounters().available()) {
+    std::cerr << "No hardware performance counters are available" << std::endl;
+  }
+
+  for (const std::string & name : opt.generators) {
+    for (size_t edges = opt.minEdges; edges <= opt.maxEdges; edges *= 10) {
+      bool completed = runForked([&]() {
+        GeneratedGraph gen = generators::byName(name)(edges, opt.seed);
+        if (opt.directed) { runCase<DirectedEdge>(gen, opt); }
+        else              { runCase<Edge>(gen, opt); }
+      });
+      if (!completed) {
+        std::cerr << name << " with " << edges << " edges did not complete" << std::endl;
+      }
+    }
+  }
+
+  return 0;
+}
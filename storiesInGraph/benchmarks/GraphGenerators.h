@@ -0,0 +1,167 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <random>
+#include <unordered_set>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Deterministic synthetic graph generators for benchmarks.
+ *
+ * Every generator returns a GeneratedGraph with vertices `0..numVertices-1`
+ * and roughly `targetEdges` distinct edges (no self-loops, no duplicates).
+ * The same `seed` always yields the same graph.
+ */
+class GeneratedGraph {
+  public:
+    std::string name;
+    uint32_t numVertices;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+
+    /**
+     * @return The vertex key used for vertex `i` when the graph is loaded into a Graph.
+     */
+    static std::string key(uint32_t i) { return "v" + std::to_string(i); }
+};
+
+namespace generators {
+  // Adds `u -> v` unless it is a self-loop or already present:
+  inline bool addEdge(GeneratedGraph & g, std::unordered_set<uint64_t> & seen, uint32_t u, uint32_t v) {
+    if (u == v) { return false; }
+    uint64_t code = (uint64_t(u) << 32) | v;
+    if (!seen.insert(code).second) { return false; }
+    g.edges.push_back({ u, v });
+    return true;
+  }
+
+  /**
+   * A path `0 -> 1 -> ... -> targetEdges`.
+   */
+  inline GeneratedGraph chain(size_t targetEdges, uint64_t seed = 1) {
+    GeneratedGraph g;
+    g.name = "chain";
+    g.numVertices = targetEdges + 1;
+    g.edges.reserve(targetEdges);
+    for (uint32_t i = 0; i < targetEdges; i++) { g.edges.push_back({ i, i + 1 }); }
+    return g;
+  }
+
+  /**
+   * A square grid with edges to the right and downward neighbours.
+   */
+  inline GeneratedGraph grid(size_t targetEdges, uint64_t seed = 1) {
+    GeneratedGraph g;
+    g.name = "grid";
+    uint32_t side = std::max<uint32_t>(2, (uint32_t) std::ceil(std::sqrt(targetEdges / 2.0)));
+    g.numVertices = side * side;
+    g.edges.reserve(2 * side * (side - 1));
+    for (uint32_t r = 0; r < side; r++) {
+      for (uint32_t c = 0; c < side; c++) {
+        uint32_t v = r * side + c;
+        if (c + 1 < side) { g.edges.push_back({ v, v + 1 }); }
+        if (r + 1 < side) { g.edges.push_back({ v, v + side }); }
+      }
+    }
+    return g;
+  }
+
+  /**
+   * Erdős–Rényi G(n, m): `targetEdges` uniformly random edges over
+   * `targetEdges / 4` vertices (average out-degree 4).
+   */
+  inline GeneratedGraph erdosRenyi(size_t targetEdges, uint64_t seed = 1) {
+    GeneratedGraph g;
+    g.name = "erdos-renyi";
+    g.numVertices = std::max<uint32_t>(8, targetEdges / 4);
+    g.edges.reserve(targetEdges);
+
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<uint32_t> vertex(0, g.numVertices - 1);
+    std::unordered_set<uint64_t> seen;
+    while (g.edges.size() < targetEdges) { addEdge(g, seen, vertex(rng), vertex(rng)); }
+    return g;
+  }
+
+  /**
+   * R-MAT (Chakrabarti et al.) with the Graph500 quadrant probabilities
+   * (0.57, 0.19, 0.19, 0.05), giving a skewed, community-structured graph
+   * over `2^ceil(log2(targetEdges / 8))` vertices.
+   */
+  inline GeneratedGraph rmat(size_t targetEdges, uint64_t seed = 1) {
+    GeneratedGraph g;
+    g.name = "rmat";
+    unsigned scale = std::max(3, (int) std::ceil(std::log2(std::max<size_t>(targetEdges / 8, 8))));
+    g.numVertices = 1u << scale;
+    g.edges.reserve(targetEdges);
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::unordered_set<uint64_t> seen;
+    size_t attempts = 0;
+    while (g.edges.size() < targetEdges && attempts++ < targetEdges * 16) {
+      uint32_t u = 0, v = 0;
+      for (unsigned bit = 0; bit < scale; bit++) {
+        double p = unit(rng);
+        if (p < 0.57)      { }
+        else if (p < 0.76) { v |= 1u << bit; }
+        else if (p < 0.95) { u |= 1u << bit; }
+        else               { u |= 1u << bit; v |= 1u << bit; }
+      }
+      addEdge(g, seen, u, v);
+    }
+    return g;
+  }
+
+  /**
+   * A story-shaped graph: passages are expanded breadth-first, each with a
+   * power-law number of choices (P(k) ~ k^-2.5, 0 to 10, where 0 is an
+   * ending), and about 5% of choices loop back to an earlier passage.
+   */
+  inline GeneratedGraph storyTree(size_t targetEdges, uint64_t seed = 1) {
+    GeneratedGraph g;
+    g.name = "story-tree";
+    g.edges.reserve(targetEdges);
+
+    std::vector<double> weights;
+    weights.push_back(0.6);  // Endings
+    for (int k = 1; k <= 10; k++) { weights.push_back(std::pow(k, -2.5) * 4); }
+
+    std::mt19937_64 rng(seed);
+    std::discrete_distribution<int> choices(weights.begin(), weights.end());
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::unordered_set<uint64_t> seen;
+
+    uint32_t next = 1;
+    for (uint32_t v = 0; g.edges.size() < targetEdges; v++) {
+      // Keep the story going if every open passage turned out to be an ending:
+      int k = choices(rng);
+      if (v + 1 == next && k == 0) { k = 1; }
+
+      for (int i = 0; i < k && g.edges.size() < targetEdges; i++) {
+        if (v > 0 && v + 1 < next && unit(rng) < 0.05) {
+          addEdge(g, seen, v, std::uniform_int_distribution<uint32_t>(0, v - 1)(rng));
+        } else {
+          addEdge(g, seen, v, next++);
+        }
+      }
+    }
+    g.numVertices = next;
+    return g;
+  }
+
+  /**
+   * @return The generator called `name`, or nullptr.
+   */
+  typedef GeneratedGraph (*Generator)(size_t targetEdges, uint64_t seed);
+  inline Generator byName(const std::string & name) {
+    if (name == "chain")       { return chain; }
+    if (name == "grid")        { return grid; }
+    if (name == "erdos-renyi") { return erdosRenyi; }
+    if (name == "rmat")        { return rmat; }
+    if (name == "story-tree")  { return storyTree; }
+    return nullptr;
+  }
+}
@@ -0,0 +1,212 @@
+/**
+ * Story loading benchmarks:
+ *
+ *   ./bench story-gen --dir DIR [options]
+ *     Writes a synthetic story (see StoryCorpus.h) into DIR.
+ *
+ *   ./bench load [options]
+ *     Times CYOA::load end to end, for every content mode and thread count,
+ *     on a story in --dir or on synthetic stories of each --nodes size.
+ *     Each load runs in its own forked process.  Output is CSV:
+ *       nodes,edges,mode,threads,run,scan_ms,parse_ms,validate_ms,compress_ms,build_ms,total_ms,peak_rss_kb,validation
+ *     Run 1 of every case starts with whatever the page cache holds; later
+ *     runs read the story files from memory.
+ */
+
+#include "../CYOA.h"
+#include "StoryCorpus.h"
+#include "Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+static std::vector<std::string> splitList(const std::string & list) {
+  std::vector<std::string> items;
+  for (size_t start = 0, end; start <= list.size(); start = end + 1) {
+    end = list.find(',', start);
+    if (end == std::string::npos) { end = list.size(); }
+    items.push_back(list.substr(start, end - start));
+  }
+  return items;
+}
+
+static std::string withSlash(std::string dir) {
+  if (!dir.empty() && dir.back() != '/') { dir += '/'; }
+  return dir;
+}
+
+// Options shared by `story-gen` and `load`; returns false if `argv[i]` is not one of them:
+static bool parseCorpusOption(StoryCorpusOptions & opt, int argc, char ** argv, int & i) {
+  std::string arg = argv[i];
+  if (i + 1 >= argc) { return false; }
+  if (arg == "--branching")         { opt.branching = std::strtod(argv[++i], nullptr); }
+  else if (arg == "--ending-ratio") { opt.endingRatio = std::strtod(argv[++i], nullptr); }
+  else if (arg == "--cycle-ratio")  { opt.cycleRatio = std::strtod(argv[++i], nullptr); }
+  else if (arg == "--words-mean")   { opt.wordsMean = std::strtod(argv[++i], nullptr); }
+  else if (arg == "--words-sigma")  { opt.wordsSigma = std::strtod(argv[++i], nullptr); }
+  else if (arg == "--seed")         { opt.seed = std::strtoull(argv[++i], nullptr, 10); }
+  else { return false; }
+  return true;
+}
+
+static const char * CORPUS_USAGE =
+  "  --branching X         mean choices per non-ending passage (default: 3)\n"
+  "  --ending-ratio X      fraction of passages that are endings (default: 0.1)\n"
+  "  --cycle-ratio X       fraction of choices that loop back (default: 0.05)\n"
+  "  --words-mean N        mean passage length in words, log-normal (default: 60)\n"
+  "  --words-sigma X       spread of passage lengths (default: 0.5)\n"
+  "  --seed N              story seed (default: 1)\n";
+
+
+static void storyGenUsage(const char * argv0) {
+  std::cerr << "Usage: " << argv0 << " story-gen --dir DIR [options]" << std::endl
+            << "  --nodes N             number of passages (default: 1000)" << std::endl
+            << "  --threads N           threads writing files (default: 1)" << std::endl
+            << CORPUS_USAGE;
+  std::exit(1);
+}
+
+int storyGen(int argc, char ** argv) {
+  StoryCorpusOptions opt;
+  std::string dir;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--dir" && hasValue)          { dir = withSlash(argv[++i]); }
+    else if (arg == "--nodes" && hasValue)   { opt.nodes = std::strtod(argv[++i], nullptr); }
+    else if (arg == "--threads" && hasValue) { opt.threads = std::strtoul(argv[++i], nullptr, 10); }
+    else if (!parseCorpusOption(opt, argc, argv, i)) { storyGenUsage(argv[0]); }
+  }
+  if (dir.empty()) { storyGenUsage(argv[0]); }
+
+  Timer t;
+  StoryCorpusInfo info;
+  try {
+    info = writeStoryCorpus(dir, opt);
+  } catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  std::printf("nodes,edges,endings,bytes,write_ms\n%zu,%zu,%zu,%zu,%.1f\n",
+              info.nodes, info.edges, info.endings, info.bytes, t.ms());
+  return 0;
+}
+
+
+static void loadUsage(const char * argv0) {
+  std::cerr << "Usage: " << argv0 << " load [options]" << std::endl
+            << "  --dir DIR             load an existing story instead of synthetic ones" << std::endl
+            << "  --nodes a,b,...       synthetic story sizes, in passages (default: 1000,10000,100000)" << std::endl
+            << "  --modes a,b,...       eager, lazy, compressed (default: all)" << std::endl
+            << "  --threads a,b,...     CYOA::load thread counts (default: 1,4)" << std::endl
+            << "  --runs N              loads per case (default: 3)" << std::endl
+            << CORPUS_USAGE;
+  std::exit(1);
+}
+
+static void loadCase(const std::string & dir, const std::string & mode, unsigned int threads,
+                     unsigned int numRuns) {
+  static const std::vector<std::string> MODE_NAMES{ "eager", "lazy", "compressed" };
+  CYOA::ContentMode contentMode = CYOA::EAGER;
+  for (size_t m = 0; m < MODE_NAMES.size(); m++) {
+    if (MODE_NAMES[m] == mode) { contentMode = (CYOA::ContentMode) m; }
+  }
+
+  for (unsigned int run = 1; run <= numRuns; run++) {
+    bool completed = runForked([&]() {
+      CYOA cyoa(threads);
+      cyoa.setContentMode(contentMode);
+
+      Timer t;
+      Graph<Vertex, DirectedEdge> g = cyoa.load(dir);
+      double total = t.ms();
+
+      const CYOA::LoadTimings & phases = cyoa.timings();
+      static const char * RESULTS[] = { "err", "warn", "pass" };
+      std::printf("%u,%u,%s,%u,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%ld,%s\n", g.numVertices(), g.numEdges(),
+                  mode.c_str(), threads, run, phases.scan, phases.parse, phases.validate, phases.compress, phases.build,
+                  total, peakRssKb(), RESULTS[cyoa.validation().result()]);
+    });
+    if (!completed) {
+      std::cerr << "Loading " << dir << " (" << mode << ", " << threads << " threads) did not complete" << std::endl;
+    }
+  }
+}
+
+int loadBench(int argc, char ** argv) {
+  StoryCorpusOptions corpus;
+  std::string dir;
+  std::vector<std::string> nodes{ "1000", "10000", "100000" };
+  std::vector<std::string> modes{ "eager", "lazy", "compressed" };
+  std::vector<std::string> threads{ "1", "4" };
+  unsigned int numRuns = 3;
+
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--dir" && hasValue)          { dir = withSlash(argv[++i]); }
+    else if (arg == "--nodes" && hasValue)   { nodes = splitList(argv[++i]); }
+    else if (arg == "--modes" && hasValue)   { modes = splitList(argv[++i]); }
+    else if (arg == "--threads" && hasValue) { threads = splitList(argv[++i]); }
+    else if (arg == "--runs" && hasValue)    { numRuns = std::strtoul(argv[++i], nullptr, 10); }
+    else if (!parseCorpusOption(corpus, argc, argv, i)) { loadUsage(argv[0]); }
+  }
+
+  for (const std::string & mode : modes) {
+    if (mode != "eager" && mode != "lazy" && mode != "compressed") {
+      std::cerr << "Unknown content mode: " << mode << std::endl;
+      loadUsage(argv[0]);
+    }
+  }
+
+  std::printf("nodes,edges,mode,threads,run,scan_ms,parse_ms,validate_ms,compress_ms,build_ms,total_ms,peak_rss_kb,validation\n");
+  std::fflush(stdout);
+
+  auto loadAll = [&](const std::string & storyDir) {
+    for (const std::string & mode : modes) {
+      for (const std::string & t : threads) {
+        loadCase(storyDir, mode, std::strtoul(t.c_str(), nullptr, 10), numRuns);
+      }
+    }
+  };
+
+  if (!dir.empty()) {
+    loadAll(dir);
+    return 0;
+  }
+
+  for (const std::string & n : nodes) {
+    char tmpl[] = "/tmp/cyoa-bench-XXXXXX";
+    if (mkdtemp(tmpl) == nullptr) {
+      std::cerr << "Unable to create a temporary directory" << std::endl;
+      return 1;
+    }
+    std::string storyDir = std::string(tmpl) + "/";
+
+    corpus.nodes = std::strtod(n.c_str(), nullptr);
+    bool written = true;
+    try {
+      writeStoryCorpus(storyDir, corpus);
+      loadAll(storyDir);
+    } catch (const std::exception & e) {
+      std::cerr << e.what() << std::endl;
+      written = false;
+    }
+
+    // Files written before a failure are removed too:
+    for (size_t i = 0; i < std::max<size_t>(corpus.nodes, 1); i++) {
+      std::remove((storyDir + "passage-" + std::to_string(i) + ".md").c_str());
+    }
+    rmdir(tmpl);
+    if (!written) { return 1; }
+  }
+
+  return 0;
+}
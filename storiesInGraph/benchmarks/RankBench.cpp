@@ -0,0 +1,117 @@
+/**
+ * PageRank benchmark suite: `make bench && ./bench rank [options]`
+ *
+ * For every generator, size and thread count, the generated edges are
+ * loaded into a CsrGraph and ranked with PageRank to the given tolerance.
+ * Each (generator, size) case runs in its own forked process.
+ *
+ * Output is CSV, one row per thread count:
+ *   generator,vertices,edges,threads,setup_ms,rank_ms,iterations,change,edges_per_sec,peak_rss_kb
+ * `setup_ms` is the time to build the PageRank (transposing the graph),
+ * and `edges_per_sec` counts every edge once per iteration.
+ */
+
+#include "../CsrGraph.h"
+#include "../PageRank.h"
+#include "GraphGenerators.h"
+#include "Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+class RankOptions {
+  public:
+    std::vector<std::string> generators{ "erdos-renyi", "rmat" };
+    size_t minEdges = 10000;
+    size_t maxEdges = 10000000;
+    std::vector<unsigned int> threads{ 1, 2, 4 };
+    double tolerance = 1e-10;
+    uint64_t seed = 1;
+};
+
+static std::vector<std::string> splitList(const std::string & list) {
+  std::vector<std::string> items;
+  for (size_t start = 0, end; start <= list.size(); start = end + 1) {
+    end = list.find(',', start);
+    if (end == std::string::npos) { end = list.size(); }
+    items.push_back(list.substr(start, end - start));
+  }
+  return items;
+}
+
+static void runCase(const GeneratedGraph & gen, const RankOptions & opt) {
+  CsrGraph g = CsrGraph::fromEdges(gen.numVertices, gen.edges);
+
+  for (unsigned int threads : opt.threads) {
+    PageRankOptions options;
+    options.tolerance = opt.tolerance;
+    options.threads = threads;
+
+    Timer setup;
+    PageRank pageRank(g, options);
+    double setupMs = setup.ms();
+
+    Timer t;
+    PageRank::Result result = pageRank.rank();
+    long long ns = t.ns();
+
+    double edgesPerSec = ns > 0 ? double(g.numEdges()) * result.iterations * 1e9 / ns : 0;
+    std::printf("%s,%u,%zu,%u,%.1f,%.1f,%u,%.3g,%.0f,%ld\n", gen.name.c_str(), gen.numVertices, g.numEdges(),
+                threads, setupMs, ns / 1e6, result.iterations, result.change, edgesPerSec, peakRssKb());
+    std::fflush(stdout);
+  }
+}
+
+static void usage(const char * argv0) {
+  std::cerr << "Usage: " << argv0 << " rank [options]" << std::endl
+            << "  --generators a,b,...  chain, grid, erdos-renyi, rmat, story-tree (default: erdos-renyi,rmat)" << std::endl
+            << "  --min-edges N         smallest graph, in edges (default: 10000)" << std::endl
+            << "  --max-edges N         largest graph, in edges; sizes grow 10x (default: 1e7)" << std::endl
+            << "  --threads a,b,...     thread counts to rank with (default: 1,2,4)" << std::endl
+            << "  --tolerance X         stop once an iteration changes the ranks by less (default: 1e-10)" << std::endl
+            << "  --seed N              generator seed (default: 1)" << std::endl;
+  std::exit(1);
+}
+
+int rankBench(int argc, char ** argv) {
+  RankOptions opt;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--generators" && hasValue) { opt.generators = splitList(argv[++i]); }
+    else if (arg == "--threads" && hasValue) {
+      opt.threads.clear();
+      for (const std::string & count : splitList(argv[++i])) { opt.threads.push_back(std::strtoul(count.c_str(), nullptr, 10)); }
+    }
+    else if (arg == "--min-edges" && hasValue) { opt.minEdges = std::strtod(argv[++i], nullptr); }
+    else if (arg == "--max-edges" && hasValue) { opt.maxEdges = std::strtod(argv[++i], nullptr); }
+    else if (arg == "--tolerance" && hasValue) { opt.tolerance = std::strtod(argv[++i], nullptr); }
+    else if (arg == "--seed" && hasValue)      { opt.seed = std::strtoull(argv[++i], nullptr, 10); }
+    else { usage(argv[0]); }
+  }
+
+  for (const std::string & name : opt.generators) {
+    if (generators::byName(name) == nullptr) {
+      std::cerr << "Unknown generator: " << name << std::endl;
+      usage(argv[0]);
+    }
+  }
+
+  std::printf("generator,vertices,edges,threads,setup_ms,rank_ms,iterations,change,edges_per_sec,peak_rss_kb\n");
+  std::fflush(stdout);
+
+  for (const std::string & name : opt.generators) {
+    for (size_t edges = opt.minEdges; edges <= opt.maxEdges; edges *= 10) {
+      bool completed = runForked([&]() { runCase(generators::byName(name)(edges, opt.seed), opt); });
+      if (!completed) {
+        std::cerr << name << " with " << edges << " edges did not complete" << std::endl;
+      }
+    }
+  }
+
+  return 0;
+}
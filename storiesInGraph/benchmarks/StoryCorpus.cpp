@@ -0,0 +1,131 @@
+#include "StoryCorpus.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Word list used to build passages; drawn with a Zipf-like skew so the text
+// is about as repetitive as real prose:
+static const char * WORDS[] = {
+  "the", "a", "you", "and", "to", "of", "in", "it", "is", "path", "door", "forest", "river", "light",
+  "dark", "old", "stone", "walk", "turn", "open", "look", "around", "quietly", "suddenly", "voice",
+  "hear", "see", "feel", "cold", "warm", "wind", "tree", "cave", "castle", "tower", "key", "map",
+  "friend", "stranger", "night", "morning", "rain", "bridge", "village", "road", "shadow", "fire",
+  "water", "mountain", "valley", "ancient", "hidden", "broken", "silver", "golden", "whisper",
+  "decide", "follow", "remember", "forget", "wait", "run", "climb", "fall", "laugh", "cry", "smile",
+  "behind", "beyond", "under", "above", "between", "towards", "away", "again", "never", "always",
+};
+static const size_t NUM_WORDS = sizeof(WORDS) / sizeof(WORDS[0]);
+
+static std::string passageKey(size_t i) { return "passage-" + std::to_string(i); }
+
+// Appends `numWords` words to `out`, wrapped at about 72 columns:
+static void appendText(std::string & out, size_t numWords, std::mt19937_64 & rng) {
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  size_t column = 0;
+  for (size_t w = 0; w < numWords; w++) {
+    size_t index = (size_t) (NUM_WORDS * std::pow(unit(rng), 2.0));
+    const char * word = WORDS[std::min(index, NUM_WORDS - 1)];
+    if (column > 72) { out += '\n'; column = 0; }
+    else if (column > 0) { out += ' '; column++; }
+    out += word;
+    column += std::char_traits<char>::length(word);
+  }
+  out += '\n';
+}
+
+StoryCorpusInfo writeStoryCorpus(const std::string & dir, const StoryCorpusOptions & options) {
+  StoryCorpusInfo info;
+  size_t n = std::max<size_t>(options.nodes, 1);
+
+  // Part 1: the story structure, built breadth-first.  Passage `next` is the
+  // first one no choice leads to yet; a passage that would leave it
+  // unreachable always takes it as its first choice.  Once every passage is
+  // reachable, forward choices lead to a random later passage instead.
+  // Loops never lead back to `passage-0`, which stays the only passage
+  // without incoming choices.
+  std::vector<std::vector<uint32_t>> choices(n);
+  std::mt19937_64 rng(options.seed);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::poisson_distribution<int> extraChoices(std::max(0.0, options.branching - 1));
+
+  size_t next = 1;
+  for (size_t v = 0; v < n && n > 1; v++) {
+    bool mustContinue = (next == v + 1 && next < n);
+    if (!mustContinue && v > 0 && unit(rng) < options.endingRatio) { continue; }
+
+    // Draw until `k` distinct choices (a few more draws than that, at most,
+    // for passages near the end of a small story):
+    size_t k = std::min(10, 1 + extraChoices(rng));
+    for (size_t attempt = 0; choices[v].size() < k && attempt < 4 * k; attempt++) {
+      bool first = choices[v].empty();
+      bool canLoop = v > 0 && !(first && mustContinue);
+      bool loop = canLoop && (v + 1 >= n || unit(rng) < options.cycleRatio);
+      uint32_t dest;
+      if (loop)          { dest = std::uniform_int_distribution<uint32_t>(1, v)(rng); }
+      else if (next < n) { dest = next++; }
+      else if (v + 1 < n) { dest = std::uniform_int_distribution<uint32_t>(v + 1, n - 1)(rng); }
+      else               { break; }
+
+      if (std::find(choices[v].begin(), choices[v].end(), dest) == choices[v].end()) {
+        choices[v].push_back(dest);
+      }
+    }
+  }
+
+  for (size_t v = 0; v < n; v++) {
+    info.edges += choices[v].size();
+    if (choices[v].empty()) { info.endings++; }
+  }
+  info.nodes = n;
+
+  // Part 2: write the files, each thread with its own deterministic RNG:
+  unsigned int numThreads = std::max(1u, options.threads);
+  std::atomic<size_t> bytes(0);
+  std::mutex failedMutex;
+  std::string failed;
+
+  auto writeRange = [&](unsigned int t) {
+    std::mt19937_64 textRng(options.seed * 7919 + t);
+    std::lognormal_distribution<double> passageWords(std::log(std::max(1.0, options.wordsMean)), options.wordsSigma);
+    std::uniform_int_distribution<int> choiceWords(3, 12);
+    std::string text;
+    size_t written = 0;
+
+    for (size_t v = n * t / numThreads; v < n * (t + 1) / numThreads; v++) {
+      text.clear();
+      appendText(text, std::max<size_t>(1, (size_t) passageWords(textRng)), textRng);
+      for (uint32_t dest : choices[v]) {
+        text += "\n# " + passageKey(dest) + "\n";
+        appendText(text, choiceWords(textRng), textRng);
+      }
+
+      std::string file = dir + passageKey(v) + ".md";
+      std::ofstream out(file, std::ios::binary);
+      if (out) { out.write(text.data(), text.size()); }
+      if (out) { out.close(); }
+      if (!out) {
+        std::lock_guard<std::mutex> lock(failedMutex);
+        if (failed.empty()) { failed = file; }
+        break;
+      }
+      written += text.size();
+    }
+    bytes += written;
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 1; t < numThreads; t++) { workers.push_back(std::thread(writeRange, t)); }
+  writeRange(0);
+  for (std::thread & worker : workers) { worker.join(); }
+
+  if (!failed.empty()) { throw std::runtime_error("Unable to write " + failed); }
+  info.bytes = bytes;
+  return info;
+}
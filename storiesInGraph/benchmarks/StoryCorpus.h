@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+/**
+ * Parameters of a synthetic CYOA story directory.
+ */
+class StoryCorpusOptions {
+  public:
+    size_t nodes = 1000;          /*< Number of passages (`.md` files) */
+    double branching = 3;         /*< Mean number of choices of a non-ending passage (1 to 10) */
+    double endingRatio = 0.1;     /*< Fraction of passages that are endings */
+    double cycleRatio = 0.05;     /*< Fraction of choices that lead back to an earlier passage */
+    double wordsMean = 60;        /*< Mean passage length, in words */
+    double wordsSigma = 0.5;      /*< Spread of the log-normal passage length distribution */
+    unsigned int threads = 1;     /*< Threads used to write files */
+    uint64_t seed = 1;
+};
+
+/**
+ * Summary of a written story directory.
+ */
+class StoryCorpusInfo {
+  public:
+    size_t nodes = 0;
+    size_t edges = 0;
+    size_t endings = 0;
+    size_t bytes = 0;
+};
+
+/**
+ * Writes a synthetic story into `dir` (which must exist), in the `.md`
+ * format read by CYOA::load: passage lines, then a `# <key>` line and a
+ * line of choice text for every choice.
+ *
+ * Passages are expanded breadth-first from `passage-0`, so every passage is
+ * reachable from the start and no choice dangles.  The same options always
+ * produce the same files.  Throws std::runtime_error if a file cannot be
+ * written.
+ */
+StoryCorpusInfo writeStoryCorpus(const std::string & dir, const StoryCorpusOptions & options);
@@ -22,6 +22,7 @@ using std::vector;
 #include "lodepng/lodepng.h"
 #include "PNG.h"
 #include "RGB_HSL.h"
+#include "../Trace.h"
 
 
 namespace cs225 {
@@ -107,6 +108,7 @@ namespace cs225 {
   }
 
   bool PNG::readFromFile(string const & fileName) {
+    TRACE_SPAN("PNG::readFromFile", "io");
     vector<unsigned char> byteData;
     unsigned error = lodepng::decode(byteData, width_, height_, fileName);
 
@@ -137,6 +139,7 @@ namespace cs225 {
   }
 
   bool PNG::writeToFile(string const & fileName) {
+    TRACE_SPAN("PNG::writeToFile", "io");
     unsigned char *byteData = new unsigned char[width_ * height_ * 4];
 
     for (unsigned i = 0; i < width_ * height_; i++) {
@@ -4,6 +4,8 @@
 #   EXE: The name of the result file
 #   OBJS: Array of objects files (.o) to be generated
 #   CLEAN_RM: Optional list of additional files to delete on `make clean`
+#   BENCH: Optional name of the benchmark executable built by `make bench`
+#   TEST_STATS: Optional name of the test executable built with GRAPH_STATS
 #
 # @author Wade Fagen-Ulmschneider, <waf@illinois.edu>
 # @author Jeffrey Tolar
@@ -26,11 +28,16 @@ DEPFILE_FLAGS = -MMD -MP
 # Provide lots of helpful warning/errors:
 WARNINGS = -pedantic -Wall -Werror -Wfatal-errors -Wextra -Wno-unused-parameter -Wno-unused-variable
 
+# Opt-in Graph operation counters for every target, see GraphStats.h (`make clean` before toggling):
+ifdef GRAPH_STATS
+CS225 += -DGRAPH_STATS
+endif
+
 # Flags for compile:
-CXXFLAGS += $(CS225) -std=c++1y -stdlib=libc++ -O0 $(WARNINGS) $(DEPFILE_FLAGS) -g -c
+CXXFLAGS += $(CS225) -std=c++17 -stdlib=libc++ -pthread -O0 $(WARNINGS) $(DEPFILE_FLAGS) -g -c
 
 # Flags for linking:
-LDFLAGS += $(CS225) -std=c++1y -stdlib=libc++
+LDFLAGS += $(CS225) -std=c++17 -stdlib=libc++ -pthread
 
 # Rule for `all` (first/default rule):
 all: $(EXE)
@@ -53,6 +60,7 @@ $(OBJS_DIR):
 # - Every object file is required by $(EXE)
 # - Generates the rule requiring the .cpp file of the same name
 $(OBJS_DIR)/%.o: %.cpp | $(OBJS_DIR)
+	@mkdir -p $(dir $@)
 	$(CXX) $(CXXFLAGS) $< -o $@
 
 
@@ -67,6 +75,37 @@ OBJS_TEST += $(CPP_TEST:.cpp=.o)
 $(TEST): $(patsubst %.o, $(OBJS_DIR)/%.o, $(OBJS_TEST))
 	$(LD) $^ $(LDFLAGS) -o $@
 
+# Rules for compiling the benchmark suite.
+# - Grab every .cpp file in benchmarks/ and link them with the project objects
+# - Everything is rebuilt with optimizations in $(BENCH_OBJS_DIR), so the
+#   -O0 debug objects used by $(EXE) and $(TEST) are left alone
+BENCH_OBJS_DIR = $(OBJS_DIR)/bench
+CXXFLAGS_BENCH = $(filter-out -O0 -g, $(CXXFLAGS)) -O2 -DNDEBUG
+OBJS_BENCH += $(filter-out $(EXE_OBJ), $(OBJS))
+CPP_BENCH = $(wildcard benchmarks/*.cpp)
+OBJS_BENCH += $(CPP_BENCH:.cpp=.o)
+
+$(BENCH): $(patsubst %.o, $(BENCH_OBJS_DIR)/%.o, $(OBJS_BENCH))
+	$(LD) $^ $(LDFLAGS) -o $@
+
+$(BENCH_OBJS_DIR)/%.o: %.cpp | $(OBJS_DIR)
+	@mkdir -p $(dir $@)
+	$(CXX) $(CXXFLAGS_BENCH) $< -o $@
+
+# Rules for compiling the test suite with Graph operation counters.
+# - GRAPH_STATS changes the layout of Graph, so every object is rebuilt with
+#   it in $(STATS_OBJS_DIR) rather than mixed with the objects of $(TEST)
+STATS_OBJS_DIR = $(OBJS_DIR)/stats
+CXXFLAGS_STATS = $(CXXFLAGS) -DGRAPH_STATS
+
+$(TEST_STATS): $(patsubst %.o, $(STATS_OBJS_DIR)/%.o, $(OBJS_TEST))
+	$(LD) $^ $(LDFLAGS) -o $@
+
+$(STATS_OBJS_DIR)/%.o: %.cpp | $(OBJS_DIR)
+	@mkdir -p $(dir $@)
+	$(CXX) $(CXXFLAGS_STATS) $< -o $@
+
+
 # Additional dependencies for object files are included in the clang++
 # generated .d files (from $(DEPFILE_FLAGS)):
 -include $(OBJS_DIR)/*.d
@@ -74,11 +113,18 @@ $(TEST): $(patsubst %.o, $(OBJS_DIR)/%.o, $(OBJS_TEST))
 -include $(OBJS_DIR)/cs225/catch/*.d
 -include $(OBJS_DIR)/cs225/lodepng/*.d
 -include $(OBJS_DIR)/tests/*.d
+-include $(OBJS_DIR)/benchmarks/*.d
+-include $(BENCH_OBJS_DIR)/*.d
+-include $(BENCH_OBJS_DIR)/*/*.d
+-include $(BENCH_OBJS_DIR)/*/*/*.d
+-include $(STATS_OBJS_DIR)/*.d
+-include $(STATS_OBJS_DIR)/*/*.d
+-include $(STATS_OBJS_DIR)/*/*/*.d
 
 
 # Standard C++ Makefile rules:
 clean:
-	rm -rf $(EXE) $(TEST) $(OBJS_DIR) $(CLEAN_RM) *.o *.d
+	rm -rf $(EXE) $(TEST) $(BENCH) $(TEST_STATS) $(OBJS_DIR) $(CLEAN_RM) *.o *.d
 
 tidy: clean
 	rm -rf doc
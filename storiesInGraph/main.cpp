@@ -4,14 +4,172 @@
 #include "DirectedEdge.h"
 
 #include "CYOA.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+#include "QueryServer.h"
+#include "RouteStatistics.h"
+#include "PlaythroughSimulator.h"
+#include "BetweennessCentrality.h"
 
 #include <string>
 #include <iostream>
+#include <cstdlib>
+#include <csignal>
+
+static QueryServer * runningServer = nullptr;
+
+static void stopServer(int signal) {
+  if (runningServer != nullptr) { runningServer->stop(); }
+}
+
+// `stories serve [socket]`: keeps the story loaded and answers queries on a
+// Unix socket until SIGINT or SIGTERM:
+static int serve(const Graph<Vertex, DirectedEdge> & g, const std::string & path) {
+  QueryServer server(g);
+  if (!server.listen(path)) {
+    std::cerr << "Unable to listen on " << path << std::endl;
+    return 1;
+  }
+  runningServer = &server;
+  std::signal(SIGINT, stopServer);
+  std::signal(SIGTERM, stopServer);
+  std::cerr << "Serving " << g.numVertices() << " passages on " << path << std::endl;
+  server.run();
+  runningServer = nullptr;
+  return 0;
+}
+
+// `stories query <socket> <shortestPath|degree|incidentEdges|isAdjacent> <key> [key2]`:
+static int query(int argc, char ** argv) {
+  if (argc < 5) {
+    std::cerr << "Usage: " << argv[0] << " query <socket> <shortestPath|degree|incidentEdges|isAdjacent> <key> [key2]" << std::endl;
+    return 1;
+  }
+  QueryClient client;
+  if (!client.connect(argv[2])) {
+    std::cerr << "Unable to connect to " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::string op = argv[3], key1 = argv[4], key2 = (argc > 5) ? argv[5] : "";
+  try {
+    if (op == "shortestPath") {
+      for (const std::string & key : client.shortestPath(key1, key2)) { std::cout << key << " -> "; }
+      std::cout << "[THE END]" << std::endl;
+    } else if (op == "degree") {
+      std::cout << client.degree(key1) << std::endl;
+    } else if (op == "incidentEdges") {
+      for (const auto & edge : client.incidentEdges(key1)) { std::cout << edge.first << " -> " << edge.second << std::endl; }
+    } else if (op == "isAdjacent") {
+      std::cout << (client.isAdjacent(key1, key2) ? "true" : "false") << std::endl;
+    } else {
+      std::cerr << "Unknown query: " << op << std::endl;
+      return 1;
+    }
+  } catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+// `stories routes [start]`: counts and measures the routes from `start` to
+// each ending, without enumerating them:
+static int routes(const Graph<Vertex, DirectedEdge> & g, const std::string & start) {
+  CsrGraph csr = CsrGraph::fromGraph(g);
+  uint32_t id;
+  try {
+    id = csr.id(start);
+  } catch (const std::out_of_range & e) {
+    std::cerr << "No passage " << start << std::endl;
+    return 1;
+  }
+
+  RouteStatistics stats(csr);
+  auto length = [](uint32_t length) {
+    if (length == RouteStatistics::NONE) { return std::string("none"); }
+    if (length == RouteStatistics::UNBOUNDED) { return std::string("unbounded"); }
+    return std::to_string(length);
+  };
+  std::cout << "Routes from " << start << ": " << RouteStatistics::toString(stats.routes(id)) << std::endl;
+  std::cout << "  choices: " << length(stats.minLength(id)) << " to " << length(stats.maxLength(id))
+            << ", " << stats.expectedLength(id) << " expected" << std::endl;
+  std::cout << "  reaches an ending: " << stats.endingProbability(id) << std::endl;
+  bool converged = stats.converged();
+  for (const RouteStatistics::Outcome & outcome : stats.outcomes(id)) {
+    std::cout << "  " << csr.key(outcome.ending) << ": " << RouteStatistics::toString(outcome.routes)
+              << " routes, " << outcome.probability << std::endl;
+    converged = converged && outcome.converged;
+  }
+  if (!converged) { std::cout << "  (approximate: the probabilities around a large loop did not converge)" << std::endl; }
+  return 0;
+}
+
+// `stories simulate [playthroughs] [start]`: plays the story at random, with
+// each choice weighted by its `weight` property, and prints how often each
+// ending is reached:
+static int simulate(const Graph<Vertex, DirectedEdge> & g, uint64_t playthroughs, const std::string & start) {
+  PlaythroughSimulator simulator(g);
+  SimulationResult result;
+  try {
+    result = simulator.run(start, playthroughs);
+  } catch (const std::out_of_range & e) {
+    std::cerr << "No passage " << start << std::endl;
+    return 1;
+  }
+
+  std::cout << result.playthroughs << " playthroughs from " << start << ":" << std::endl;
+  for (uint32_t v = 0; v < simulator.numVertices(); v++) {
+    if (result.endings[v] == 0) { continue; }
+    std::cout << "  " << simulator.key(v) << ": " << result.endings[v] << std::endl;
+  }
+  std::cout << "  (unfinished): " << result.unfinished << std::endl;
+  return 0;
+}
+
+// `stories bottlenecks [count] [samples]`: the `count` passages the most
+// shortest routes pass through, estimated from `samples` starting passages
+// (0: from every passage):
+static int bottlenecks(const Graph<Vertex, DirectedEdge> & g, size_t count, uint32_t samples) {
+  CsrGraph csr = CsrGraph::fromGraph(g);
+  BetweennessOptions options;
+  options.samples = samples;
+  BetweennessCentrality centrality(csr, options);
+
+  std::cout << "Bottlenecks, from " << (centrality.exact() ? "all " : std::to_string(centrality.sources()) + " of ")
+            << csr.numVertices() << " passages:" << std::endl;
+  for (uint32_t v : centrality.top(count)) {
+    std::cout << "  " << csr.key(v) << ": " << centrality.centrality(v) << std::endl;
+  }
+  return 0;
+}
+
+int main(int argc, char ** argv) {
+  std::string mode = (argc > 1) ? argv[1] : "";
+  if (mode == "query") { return query(argc, argv); }
+
+  // CYOA_TRACE=<file> records a Chrome trace of the run into <file>:
+  const char * tracePath = std::getenv("CYOA_TRACE");
+  if (tracePath != nullptr) { Trace::enable(); }
+
+  // CYOA_PERF=1 prints the hardware counters of loading the story:
+  const bool perf = (std::getenv("CYOA_PERF") != nullptr);
+
+  PerfCounters counters;
+  if (perf) { counters.start(); }
 
-int main() {
   CYOA cyoa;
   Graph<Vertex, DirectedEdge> g = cyoa.load("story_data/");
-  std::cout << g << std::endl;
+  if (perf) { std::cerr << "CYOA::load: " << counters.stop() << std::endl; }
+  if (cyoa.validation().result() != StoryValidation::PASS) {
+    std::cerr << cyoa.validation();
+  }
+  int status = 0;
+  if (mode == "serve")            { status = serve(g, (argc > 2) ? argv[2] : "stories.sock"); }
+  else if (mode == "routes")      { status = routes(g, (argc > 2) ? argv[2] : "start"); }
+  else if (mode == "simulate")    { status = simulate(g, (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1000000, (argc > 3) ? argv[3] : "start"); }
+  else if (mode == "bottlenecks") { status = bottlenecks(g, (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 10, (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 0); }
+  else                            { std::cout << g << std::endl; }
 
   // Modify the g.shortestPath call to find the shortest path to your story:
   /*
@@ -22,5 +180,8 @@ int main() {
   std::cout << "[THE END]" << std::endl;
   */
 
-  return 0;
+  if (tracePath != nullptr && !Trace::writeToFile(tracePath)) {
+    std::cerr << "Unable to write trace to " << tracePath << std::endl;
+  }
+  return status;
 }
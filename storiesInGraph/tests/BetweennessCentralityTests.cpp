@@ -0,0 +1,118 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../CsrGraph.h"
+#include "../BetweennessCentrality.h"
+#include "../DirectedEdge.h"
+#include "StoryFixture.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+// By definition: the share of the shortest routes between each pair through each vertex:
+static std::vector<double> naiveCentrality(const CsrGraph & g) {
+  const uint32_t FAR = std::numeric_limits<uint32_t>::max();
+  uint32_t n = g.numVertices();
+  std::vector<std::vector<uint32_t>> distance(n, std::vector<uint32_t>(n, FAR));
+  std::vector<std::vector<double>> routes(n, std::vector<double>(n, 0));
+  for (uint32_t s = 0; s < n; s++) {
+    std::vector<uint32_t> queue{ s };
+    distance[s][s] = 0;
+    routes[s][s] = 1;
+    for (size_t head = 0; head < queue.size(); head++) {
+      uint32_t v = queue[head];
+      for (uint32_t w : g.neighbors(v)) {
+        if (distance[s][w] == FAR) { distance[s][w] = distance[s][v] + 1; queue.push_back(w); }
+        if (distance[s][w] == distance[s][v] + 1) { routes[s][w] += routes[s][v]; }
+      }
+    }
+  }
+
+  std::vector<double> centrality(n, 0);
+  for (uint32_t s = 0; s < n; s++) {
+    for (uint32_t t = 0; t < n; t++) {
+      if (s == t || distance[s][t] == FAR) { continue; }
+      for (uint32_t v = 0; v < n; v++) {
+        if (v == s || v == t || distance[s][v] == FAR || distance[v][t] == FAR) { continue; }
+        if (distance[s][v] + distance[v][t] == distance[s][t]) {
+          centrality[v] += routes[s][v] * routes[v][t] / routes[s][t];
+        }
+      }
+    }
+  }
+  return centrality;
+}
+
+TEST_CASE("BetweennessCentrality finds the bottlenecks of a story", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> story = createTrapStory();
+  CsrGraph g = CsrGraph::fromGraph(story);
+  BetweennessCentrality centrality(g);
+
+  REQUIRE( centrality.exact() );
+  REQUIRE( centrality.sources() == 7 );
+  REQUIRE( centrality.centrality(g.id("cross")) == Approx(9) );
+  REQUIRE( centrality.centrality(g.id("right")) == Approx(9) );
+  REQUIRE( centrality.centrality(g.id("trap1")) == Approx(4) );
+  REQUIRE( centrality.centrality(g.id("start")) == 0 );
+  REQUIRE( centrality.centrality(g.id("left")) == 0 );
+  REQUIRE( centrality.centrality(g.id("end")) == 0 );
+
+  std::vector<uint32_t> top = centrality.top(3);
+  REQUIRE( top.size() == 3 );
+  REQUIRE( centrality.centrality(top[0]) == Approx(9) );
+  REQUIRE( top[2] == g.id("trap1") );
+  REQUIRE( centrality.top(100).size() == 7 );
+
+  // Two equally short routes share the credit:
+  BetweennessCentrality diamond(CsrGraph::fromEdges(4, { { 0, 1 }, { 0, 2 }, { 1, 3 }, { 2, 3 } }));
+  REQUIRE( diamond.centrality(1) == Approx(0.5) );
+  REQUIRE( diamond.centrality(2) == Approx(0.5) );
+  REQUIRE( diamond.centrality(0) == 0 );
+
+  REQUIRE( BetweennessCentrality(CsrGraph()).centralities().empty() );
+}
+
+TEST_CASE("BetweennessCentrality matches the definition, with any number of threads", "[weight=1]") {
+  CsrGraph g = randomGraph(120, 300, 3);
+  std::vector<double> expected = naiveCentrality(g);
+
+  for (unsigned int threads : { 1, 3, 8 }) {
+    BetweennessOptions options;
+    options.threads = threads;
+    BetweennessCentrality centrality(g, options);
+    for (uint32_t v = 0; v < g.numVertices(); v++) { REQUIRE( centrality.centrality(v) == Approx(expected[v]) ); }
+  }
+}
+
+TEST_CASE("BetweennessCentrality estimates from a sample of sources", "[weight=1]") {
+  CsrGraph g = randomGraph(1000, 4000, 5);
+  BetweennessCentrality exact(g);
+
+  BetweennessOptions options;
+  options.samples = 1000;
+  BetweennessCentrality all(g, options);
+  REQUIRE( all.exact() );
+  for (uint32_t v = 0; v < g.numVertices(); v++) { REQUIRE( all.centrality(v) == Approx(exact.centrality(v)) ); }
+
+  // A quarter of the sources estimates the total closely, and each vertex on average:
+  double total = 0;
+  for (double c : exact.centralities()) { total += c; }
+  uint32_t busiest = exact.top(1)[0];
+  double busiestMean = 0;
+  options.samples = 250;
+  options.threads = 2;
+  for (options.seed = 1; options.seed <= 16; options.seed++) {
+    BetweennessCentrality sampled(g, options);
+    REQUIRE( sampled.sources() == 250 );
+    REQUIRE( !sampled.exact() );
+    double sampledTotal = 0;
+    for (double c : sampled.centralities()) { sampledTotal += c; }
+    REQUIRE( sampledTotal == Approx(total).epsilon(0.05) );
+    busiestMean += sampled.centrality(busiest) / 16;
+  }
+  REQUIRE( busiestMean == Approx(exact.centrality(busiest)).epsilon(0.05) );
+
+  // The same seed and threads give the same estimate:
+  options.seed = 1;
+  REQUIRE( BetweennessCentrality(g, options).centralities() == BetweennessCentrality(g, options).centralities() );
+}
@@ -0,0 +1,34 @@
+#include "ComplexityHarness.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// The counting allocator: every allocation in the test binary goes through
+// here.  All forms are replaced (not only the ones the others forward to by
+// default) so that tools which intercept operator new see matching pairs.
+static void * countedAlloc(std::size_t size) noexcept {
+  complexity::allocations++;
+  return std::malloc(size > 0 ? size : 1);
+}
+
+void * operator new(std::size_t size) {
+  void * p = countedAlloc(size);
+  if (p == nullptr) { throw std::bad_alloc(); }
+  return p;
+}
+
+void * operator new[](std::size_t size) {
+  void * p = countedAlloc(size);
+  if (p == nullptr) { throw std::bad_alloc(); }
+  return p;
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete[](void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void * p, std::size_t) noexcept { std::free(p); }
+void operator delete(void * p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void * p, const std::nothrow_t &) noexcept { std::free(p); }
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "../Graph.h"
+#include "../Vertex.h"
+#include "../Edge.h"
+#include "../DirectedEdge.h"
+
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * Counts the work a Graph operation does, so that tests can assert how that
+ * work grows with the size of the graph instead of timing it.
+ *
+ * Four things are counted:
+ * - allocations: every global `operator new` in the test binary (replaced in
+ *   ComplexityHarness.cpp),
+ * - hashes: vertex keys hashed by a Graph<CountingVertex, ...> (through
+ *   GraphKeyHash<CountingVertex>),
+ * - keyCalls: CountingVertex::key() calls,
+ * - endpointCalls: source() and dest() calls on a CountingEdge.
+ */
+namespace complexity {
+  inline std::atomic<size_t> allocations(0);
+  inline std::atomic<size_t> hashes(0);
+  inline std::atomic<size_t> keyCalls(0);
+  inline std::atomic<size_t> endpointCalls(0);
+
+  class Cost {
+    public:
+      size_t allocations = 0;
+      size_t hashes = 0;
+      size_t keyCalls = 0;
+      size_t endpointCalls = 0;
+  };
+
+  /**
+   * @return The counters accumulated while running `operation()`.
+   */
+  template <class F>
+  Cost measure(F operation) {
+    Cost before{ allocations, hashes, keyCalls, endpointCalls };
+    operation();
+    return Cost{ allocations - before.allocations, hashes - before.hashes,
+                 keyCalls - before.keyCalls, endpointCalls - before.endpointCalls };
+  }
+
+  /**
+   * Measures `operation(i)` for i = 0 .. repeats-1 one at a time.
+   * @return The median of each counter, which ignores the occasional
+   * rehash or reallocation an amortized-O(1) operation triggers.
+   */
+  template <class F>
+  Cost median(size_t repeats, F operation) {
+    std::vector<Cost> costs;
+    for (size_t i = 0; i < repeats; i++) { costs.push_back(measure([&]() { operation(i); })); }
+
+    auto mid = [&](size_t Cost::*counter) {
+      std::vector<size_t> values;
+      for (const Cost & c : costs) { values.push_back(c.*counter); }
+      std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+      return values[values.size() / 2];
+    };
+    return Cost{ mid(&Cost::allocations), mid(&Cost::hashes), mid(&Cost::keyCalls), mid(&Cost::endpointCalls) };
+  }
+
+  enum Growth { CONSTANT, LOGARITHMIC, LINEAR, LINEARITHMIC, QUADRATIC };
+
+  inline double bound(Growth growth, double n) {
+    switch (growth) {
+      case CONSTANT:     return 1;
+      case LOGARITHMIC:  return std::log2(n);
+      case LINEAR:       return n;
+      case LINEARITHMIC: return n * std::log2(n);
+      case QUADRATIC:    return n * n;
+    }
+    return 1;
+  }
+
+  /**
+   * Returns `true` if `counter` grows no faster than `growth` across
+   * `costs`, where `costs[i]` was measured on an input of size `sizes[i]`
+   * (sizes in increasing order).  The count at each size may be at most
+   * `slack` times what the smallest size predicts, plus `slack` to absorb
+   * small constant terms.
+   */
+  inline bool growsAtMost(const std::vector<size_t> & sizes, const std::vector<Cost> & costs,
+                          size_t Cost::*counter, Growth growth, double slack = 2) {
+    double perUnit = (costs.front().*counter) / bound(growth, sizes.front());
+    for (size_t i = 1; i < sizes.size(); i++) {
+      double predicted = perUnit * bound(growth, sizes[i]);
+      if (costs[i].*counter > slack * predicted + slack) { return false; }
+    }
+    return true;
+  }
+
+  /**
+   * Hashes vertex keys like std::hash, counting every call.
+   */
+  class CountingHash {
+    public:
+      size_t operator()(const std::string & key) const {
+        hashes++;
+        return std::hash<std::string>()(key);
+      }
+  };
+}
+
+
+/**
+ * A Vertex that counts calls to key().
+ */
+class CountingVertex : public Vertex {
+  public:
+    CountingVertex(const std::string key = "") : Vertex(key) { }
+
+    string key() const {
+      complexity::keyCalls++;
+      return Vertex::key();
+    }
+};
+
+template <>
+struct GraphKeyHash<CountingVertex> {
+  typedef complexity::CountingHash type;
+};
+
+
+/**
+ * An Edge (or DirectedEdge) that counts calls to source() and dest().
+ */
+template <class BaseEdge>
+class CountingEdgeOf : public BaseEdge {
+  public:
+    using BaseEdge::BaseEdge;
+
+    const Vertex & source() const {
+      complexity::endpointCalls++;
+      return BaseEdge::source();
+    }
+
+    const Vertex & dest() const {
+      complexity::endpointCalls++;
+      return BaseEdge::dest();
+    }
+};
+
+typedef CountingEdgeOf<Edge> CountingEdge;
+typedef CountingEdgeOf<DirectedEdge> CountingDirectedEdge;
@@ -0,0 +1,140 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "ComplexityHarness.hpp"
+
+#include <string>
+#include <vector>
+
+using complexity::Cost;
+
+// Every operation is measured on graphs of these sizes; the vertices the
+// operations touch keep the same degree at every size.
+static const std::vector<size_t> SIZES{ 100, 1000, 10000 };
+static const size_t SAMPLES = 21;
+
+/**
+ * Builds a chain of `n` vertices (`c0` - `c1` - ... ) next to a hub with
+ * five leaves: hub-leaf0, hub-leaf1, hub-leaf2, leaf3-hub and leaf4-hub.
+ */
+template <class E>
+static void buildHubAndChain(Graph<CountingVertex, E> & g, size_t n) {
+  for (size_t i = 0; i < n; i++) { g.insertVertex("c" + std::to_string(i)); }
+  for (size_t i = 0; i + 1 < n; i++) { g.insertEdge("c" + std::to_string(i), "c" + std::to_string(i + 1)); }
+
+  g.insertVertex("hub");
+  for (int i = 0; i < 5; i++) { g.insertVertex("leaf" + std::to_string(i)); }
+  for (int i = 0; i < 3; i++) { g.insertEdge("hub", "leaf" + std::to_string(i)); }
+  g.insertEdge("leaf3", "hub");
+  g.insertEdge("leaf4", "hub");
+}
+
+/**
+ * Builds a graph of every size and returns the cost of `operation(g)` on each.
+ */
+template <class E, class F>
+static std::vector<Cost> costAcrossSizes(F operation) {
+  std::vector<Cost> costs;
+  for (size_t n : SIZES) {
+    Graph<CountingVertex, E> g;
+    buildHubAndChain(g, n);
+    costs.push_back(operation(g));
+  }
+  return costs;
+}
+
+static bool isConstant(const std::vector<Cost> & costs) {
+  return complexity::growsAtMost(SIZES, costs, &Cost::allocations, complexity::CONSTANT) &&
+         complexity::growsAtMost(SIZES, costs, &Cost::hashes, complexity::CONSTANT) &&
+         complexity::growsAtMost(SIZES, costs, &Cost::keyCalls, complexity::CONSTANT) &&
+         complexity::growsAtMost(SIZES, costs, &Cost::endpointCalls, complexity::CONSTANT);
+}
+
+
+TEST_CASE("complexity::growsAtMost tells constant from linear growth", "[weight=1]") {
+  std::vector<Cost> constant{ Cost{ 3 }, Cost{ 4 }, Cost{ 3 } };
+  std::vector<Cost> linear{ Cost{ 100 }, Cost{ 1000 }, Cost{ 10000 } };
+
+  REQUIRE( complexity::growsAtMost(SIZES, constant, &Cost::allocations, complexity::CONSTANT) );
+  REQUIRE( complexity::growsAtMost(SIZES, linear, &Cost::allocations, complexity::LINEAR) );
+  REQUIRE_FALSE( complexity::growsAtMost(SIZES, linear, &Cost::allocations, complexity::CONSTANT) );
+}
+
+TEST_CASE("complexity::measure counts allocations, hashes and key calls", "[weight=1]") {
+  Graph<CountingVertex, CountingEdge> g;
+  Cost cost = complexity::measure([&]() { g.insertVertex("a"); });
+  REQUIRE( cost.allocations > 0 );
+  REQUIRE( cost.hashes > 0 );
+
+  g.insertVertex("b");
+  cost = complexity::measure([&]() { g.insertEdge("a", "b"); });
+  REQUIRE( cost.keyCalls > 0 );
+  REQUIRE( complexity::measure([&]() { g.isAdjacent("a", "b"); }).endpointCalls > 0 );
+}
+
+TEST_CASE("Graph::insertVertex and Graph::insertEdge do O(1) work", "[weight=1]") {
+  REQUIRE( isConstant(costAcrossSizes<CountingEdge>([](Graph<CountingVertex, CountingEdge> & g) {
+    return complexity::median(SAMPLES, [&](size_t i) { g.insertVertex("new" + std::to_string(i)); });
+  })) );
+
+  REQUIRE( isConstant(costAcrossSizes<CountingEdge>([](Graph<CountingVertex, CountingEdge> & g) {
+    return complexity::median(SAMPLES, [&](size_t i) { g.insertEdge("hub", "c" + std::to_string(i)); });
+  })) );
+
+  REQUIRE( isConstant(costAcrossSizes<CountingDirectedEdge>([](Graph<CountingVertex, CountingDirectedEdge> & g) {
+    return complexity::median(SAMPLES, [&](size_t i) { g.insertEdge("c" + std::to_string(i), "hub"); });
+  })) );
+}
+
+TEST_CASE("Graph::incidentEdges and Graph::degree do O(degree) work", "[weight=1]") {
+  REQUIRE( isConstant(costAcrossSizes<CountingEdge>([](Graph<CountingVertex, CountingEdge> & g) {
+    return complexity::median(SAMPLES, [&](size_t) { g.incidentEdges("hub"); g.degree("hub"); });
+  })) );
+}
+
+TEST_CASE("Directed: Graph::incidentEdges and Graph::degree do O(degree) work", "[weight=1]") {
+  REQUIRE( isConstant(costAcrossSizes<CountingDirectedEdge>([](Graph<CountingVertex, CountingDirectedEdge> & g) {
+    return complexity::median(SAMPLES, [&](size_t) { g.incidentEdges("hub"); });
+  })) );
+
+  REQUIRE( isConstant(costAcrossSizes<CountingDirectedEdge>([](Graph<CountingVertex, CountingDirectedEdge> & g) {
+    return complexity::median(SAMPLES, [&](size_t) { g.degree("hub"); });
+  })) );
+}
+
+TEST_CASE("Graph::isAdjacent does O(degree) work", "[weight=1]") {
+  REQUIRE( isConstant(costAcrossSizes<CountingEdge>([](Graph<CountingVertex, CountingEdge> & g) {
+    return complexity::median(SAMPLES, [&](size_t) { g.isAdjacent("hub", "leaf4"); g.isAdjacent("leaf0", "hub"); });
+  })) );
+
+  REQUIRE( isConstant(costAcrossSizes<CountingDirectedEdge>([](Graph<CountingVertex, CountingDirectedEdge> & g) {
+    return complexity::median(SAMPLES, [&](size_t) { g.isAdjacent("hub", "leaf2"); g.isAdjacent("leaf3", "hub"); });
+  })) );
+}
+
+TEST_CASE("Graph::removeEdge and Graph::removeVertex do O(degree) work", "[weight=1]") {
+  REQUIRE( isConstant(costAcrossSizes<CountingEdge>([](Graph<CountingVertex, CountingEdge> & g) {
+    return complexity::measure([&]() { g.removeEdge("hub", "leaf1"); });
+  })) );
+
+  REQUIRE( isConstant(costAcrossSizes<CountingDirectedEdge>([](Graph<CountingVertex, CountingDirectedEdge> & g) {
+    return complexity::measure([&]() { g.removeEdge("leaf3", "hub"); });
+  })) );
+
+  REQUIRE( isConstant(costAcrossSizes<CountingEdge>([](Graph<CountingVertex, CountingEdge> & g) {
+    return complexity::measure([&]() { g.removeVertex("hub"); });
+  })) );
+
+  REQUIRE( isConstant(costAcrossSizes<CountingDirectedEdge>([](Graph<CountingVertex, CountingDirectedEdge> & g) {
+    return complexity::measure([&]() { g.removeVertex("hub"); });
+  })) );
+}
+
+TEST_CASE("Graph::shortestPath does O(|V| + |E|) work", "[weight=1]") {
+  std::vector<Cost> costs = costAcrossSizes<CountingEdge>([](Graph<CountingVertex, CountingEdge> & g) {
+    return complexity::measure([&]() { g.shortestPath("c0", "c50"); });
+  });
+
+  REQUIRE( complexity::growsAtMost(SIZES, costs, &Cost::allocations, complexity::LINEAR) );
+  REQUIRE( complexity::growsAtMost(SIZES, costs, &Cost::hashes, complexity::LINEAR) );
+  REQUIRE( complexity::growsAtMost(SIZES, costs, &Cost::endpointCalls, complexity::LINEAR) );
+}
@@ -0,0 +1,174 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../CYOA.h"
+#include "../LRUCache.h"
+#include "../CompressedContentStore.h"
+#include "StoryFixture.hpp"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+
+static std::vector<std::pair<std::string, std::string>> contentStory() {
+  return {
+    { "start", "  You wake up.  \n\nThe trees are tall.\r\n# left\nGo left,\n  towards the river.\n#right\nGo right.\n# left\nLeft again.\n" },
+    { "left", "The river.\n# end\nSwim.\n" },
+    { "right", "The cave.\n# end" },
+    { "end", "THE END" },
+  };
+}
+
+TEST_CASE("LRUCache evicts the least recently used entry", "[weight=1]") {
+  LRUCache<int, std::string> cache(2);
+  cache.put(1, "one");
+  cache.put(2, "two");
+  REQUIRE( *cache.get(1) == "one" );
+
+  cache.put(3, "three");
+  REQUIRE( cache.size() == 2 );
+  REQUIRE( cache.get(2) == nullptr );
+  REQUIRE( *cache.get(1) == "one" );
+  REQUIRE( *cache.get(3) == "three" );
+}
+
+TEST_CASE("CYOA::load stores content in vertex and edge properties by default", "[weight=1]") {
+  CYOA cyoa;
+  Graph<Vertex, DirectedEdge> g = cyoa.load(writeStory(contentStory()));
+
+  REQUIRE( g.numEdges() == 4 );
+  for (DirectedEdge & e : g.incidentEdges("start")) {
+    if (e.dest().key() == "left") { REQUIRE( e["content"] == " Left again." ); }
+    if (e.dest().key() == "right") { REQUIRE( cyoa.content(e) == " Go right." ); }
+  }
+}
+
+TEST_CASE("CYOA::load in LAZY mode reads the same content on demand", "[weight=1]") {
+  StoryDir dir = writeStory(contentStory());
+
+  CYOA eager;
+  CYOA lazy;
+  lazy.setContentMode(CYOA::LAZY);
+  Graph<Vertex, DirectedEdge> g1 = eager.load(dir);
+  Graph<Vertex, DirectedEdge> g2 = lazy.load(dir);
+
+  for (std::string key : { "start", "left", "right", "end" }) {
+    std::list<std::reference_wrapper<DirectedEdge>> edges1 = g1.incidentEdges(key);
+    std::list<std::reference_wrapper<DirectedEdge>> edges2 = g2.incidentEdges(key);
+    REQUIRE( edges1.size() == edges2.size() );
+
+    for (DirectedEdge & e1 : edges1) {
+      bool found = false;
+      for (DirectedEdge & e2 : edges2) {
+        if (e1.source().key() != e2.source().key() || e1.dest().key() != e2.dest().key()) { continue; }
+        found = true;
+
+        // LAZY mode keeps nothing in the properties:
+        REQUIRE( e2.property("content") == "" );
+        REQUIRE( lazy.content(e2) == eager.content(e1) );
+        REQUIRE( lazy.content(e2.source()) == eager.content(e1.source()) );
+        REQUIRE( lazy.content(e2.dest()) == eager.content(e1.dest()) );
+      }
+      REQUIRE( found );
+    }
+  }
+
+  REQUIRE( ContentStore::normalize("  You wake up.  \n\nThe trees are tall.\r\n") == " You wake up. The trees are tall." );
+}
+
+TEST_CASE("CYOA::load in LAZY mode throws when a story file was truncated", "[weight=1]") {
+  StoryDir dir = writeStory(contentStory());
+
+  CYOA lazy;
+  lazy.setContentMode(CYOA::LAZY);
+  Graph<Vertex, DirectedEdge> g = lazy.load(dir);
+
+  std::ofstream(dir.path() + "left.md", std::ios::trunc) << "The";
+  REQUIRE_THROWS_AS( lazy.content(Vertex("left")), std::runtime_error );
+  REQUIRE( lazy.content(Vertex("end")) == " THE END" );
+}
+
+TEST_CASE("CYOA::load in LAZY mode can be read from several threads", "[weight=1]") {
+  StoryDir dir = writeStory(contentStory());
+
+  CYOA eager;
+  CYOA lazy;
+  lazy.setContentMode(CYOA::LAZY);
+  Graph<Vertex, DirectedEdge> g1 = eager.load(dir);
+  Graph<Vertex, DirectedEdge> g2 = lazy.load(dir);
+
+  std::vector<std::string> keys = { "start", "left", "right", "end" };
+  std::vector<std::string> expected;
+  for (const std::string & key : keys) {
+    // Every passage of the story has a choice to or from it:
+    const DirectedEdge & e = g1.incidentEdges(key).front();
+    expected.push_back(eager.content(e.source().key() == key ? e.source() : e.dest()));
+  }
+
+  std::atomic<unsigned> mismatches(0);
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.push_back(std::thread([&, t]() {
+      for (int i = 0; i < 2000; i++) {
+        size_t k = (i + t) % keys.size();
+        if (lazy.content(Vertex(keys[k])) != expected[k]) { mismatches++; }
+      }
+    }));
+  }
+  for (std::thread & reader : readers) { reader.join(); }
+  REQUIRE( mismatches == 0 );
+}
+
+TEST_CASE("CompressedContentStore reads back text across sealed blocks", "[weight=1]") {
+  CompressedContentStore store(64, 1);
+  std::vector<std::string> texts;
+  std::vector<uint32_t> ids;
+  for (int i = 0; i < 50; i++) {
+    texts.push_back(" Passage " + std::to_string(i) + ": the river runs past the old oak tree.");
+    ids.push_back(store.addPassage("p" + std::to_string(i), store.append(texts.back())));
+  }
+  store.seal();
+
+  // Read in an order that defeats the one-block cache:
+  for (int i = 49; i >= 0; i -= 7) {
+    REQUIRE( store.vertexContent("p" + std::to_string(i)) == texts[i] );
+  }
+
+  // Repetitive text in a full-size block compresses well:
+  CompressedContentStore large;
+  for (const std::string & text : texts) { large.append(text); }
+  large.seal();
+  REQUIRE( large.compressedBytes() * 2 < large.rawBytes() );
+}
+
+TEST_CASE("CompressedContentStore throws instead of returning text it does not hold", "[weight=1]") {
+  CompressedContentStore store;
+  store.addPassage("start", store.append(" You wake up."));
+  store.addPassage("lost", TextRef{ 0, 5, 100 });
+  store.seal();
+
+  REQUIRE( store.vertexContent("start") == " You wake up." );
+  REQUIRE_THROWS_AS( store.vertexContent("lost"), std::runtime_error );
+}
+
+TEST_CASE("CYOA::load in COMPRESSED mode returns the same content", "[weight=1]") {
+  StoryDir dir = writeStory(contentStory());
+
+  CYOA eager;
+  CYOA compressed;
+  compressed.setContentMode(CYOA::COMPRESSED);
+  Graph<Vertex, DirectedEdge> g1 = eager.load(dir);
+  Graph<Vertex, DirectedEdge> g2 = compressed.load(dir);
+
+  for (DirectedEdge & e2 : g2.incidentEdges("start")) {
+    REQUIRE( e2.property("content") == "" );
+    for (DirectedEdge & e1 : g1.incidentEdges("start")) {
+      if (e1.dest().key() == e2.dest().key() && e1.source().key() == e2.source().key()) {
+        REQUIRE( compressed.content(e2) == eager.content(e1) );
+        REQUIRE( compressed.content(e2.dest()) == eager.content(e1.dest()) );
+      }
+    }
+  }
+}
@@ -0,0 +1,117 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../CowGraph.h"
+#include "../PersistentHashMap.h"
+#include "../DirectedEdge.h"
+#include "ComplexityHarness.hpp"
+
+#include <string>
+#include <vector>
+
+static CowGraph<Vertex, Edge> createCowChain(size_t n) {
+  CowGraph<Vertex, Edge> g;
+  for (size_t i = 0; i < n; i++) { g.insertVertex("v" + std::to_string(i)); }
+  for (size_t i = 0; i + 1 < n; i++) { g.insertEdge("v" + std::to_string(i), "v" + std::to_string(i + 1)); }
+  return g;
+}
+
+TEST_CASE("PersistentHashMap copies are independent", "[weight=1]") {
+  PersistentHashMap<std::string, int> map;
+  for (int i = 0; i < 1000; i++) { map.set(std::to_string(i), i); }
+  PersistentHashMap<std::string, int> copy = map;
+
+  copy.set("5", 50);
+  copy.erase("7");
+  copy.set("new", -1);
+
+  REQUIRE( map.size() == 1000 );
+  REQUIRE( *map.find("5") == 5 );
+  REQUIRE( *map.find("7") == 7 );
+  REQUIRE( map.find("new") == nullptr );
+  REQUIRE( copy.size() == 1000 );
+  REQUIRE( *copy.find("5") == 50 );
+  REQUIRE( copy.find("7") == nullptr );
+
+  size_t sum = 0;
+  map.forEach([&](const std::string & key, int value) { sum += value; });
+  REQUIRE( sum == 999 * 1000 / 2 );
+}
+
+TEST_CASE("CowGraph clones do not see each other's edits", "[weight=1]") {
+  CowGraph<Vertex, Edge> g = createCowChain(10);
+  CowGraph<Vertex, Edge> shortcut = g.clone();
+  shortcut.insertEdge("v0", "v9");
+  CowGraph<Vertex, Edge> broken = g.clone();
+  broken.removeVertex("v5");
+
+  REQUIRE( g.shortestPath("v0", "v9").size() == 10 );
+  REQUIRE( shortcut.shortestPath("v0", "v9").size() == 2 );
+  REQUIRE( broken.shortestPath("v0", "v9").size() == 1 );  // Unreachable: only "v9"
+
+  REQUIRE( g.numEdges() == 9 );
+  REQUIRE( shortcut.numEdges() == 10 );
+  REQUIRE( broken.numVertices() == 9 );
+  REQUIRE( broken.numEdges() == 7 );
+  REQUIRE( g.degree("v5") == 2 );
+}
+
+TEST_CASE("CowGraph properties are copied on write", "[weight=1]") {
+  CowGraph<Vertex, Edge> g = createCowChain(3);
+  g.setVertexProperty("v1", "color", "red");
+  g.setEdgeProperty("v0", "v1", "choice", "left");
+
+  CowGraph<Vertex, Edge> copy = g.clone();
+  copy.setVertexProperty("v1", "color", "blue");
+  copy.setEdgeProperty("v0", "v1", "choice", "right");
+
+  REQUIRE( g.vertex("v1").property("color") == "red" );
+  REQUIRE( copy.vertex("v1").property("color") == "blue" );
+  REQUIRE( g.incidentEdges("v1").front().get().property("choice") == "left" );
+  REQUIRE( copy.incidentEdges("v1").front().get().property("choice") == "right" );
+  REQUIRE_THROWS( copy.setEdgeProperty("v0", "v2", "choice", "none") );
+}
+
+TEST_CASE("CowGraph matches the Graph it was built from", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "a", "b", "c", "d", "e" }) { g.insertVertex(key); }
+  g.insertEdge("a", "b");
+  g.insertEdge("b", "c");
+  g.insertEdge("c", "a");
+  g.insertEdge("c", "d");
+  g.insertEdge("e", "c")["content"] = "back";
+
+  CowGraph<Vertex, DirectedEdge> cow(g);
+  REQUIRE( cow.numVertices() == g.numVertices() );
+  REQUIRE( cow.numEdges() == g.numEdges() );
+  for (std::string key : { "a", "b", "c", "d", "e" }) {
+    REQUIRE( cow.degree(key) == g.degree(key) );
+    REQUIRE( cow.shortestPath("a", key) == g.shortestPath("a", key) );
+  }
+  REQUIRE( cow.isAdjacent("c", "a") );
+  REQUIRE_FALSE( cow.isAdjacent("a", "c") );
+  REQUIRE( cow.incidentEdges("e").front().get().property("content") == "back" );
+
+  cow.removeVertex("c");
+  REQUIRE( cow.numEdges() == 1 );
+  REQUIRE( g.numEdges() == 5 );
+}
+
+TEST_CASE("CowGraph clones are O(1) and edits allocate O(log |V|)", "[weight=1]") {
+  using complexity::Cost;
+  std::vector<size_t> sizes{ 100, 1000, 10000 };
+  std::vector<Cost> cloneCosts, editCosts;
+
+  for (size_t n : sizes) {
+    CowGraph<Vertex, Edge> g = createCowChain(n);
+    CowGraph<Vertex, Edge> copy;
+    cloneCosts.push_back(complexity::measure([&]() { copy = g.clone(); }));
+    editCosts.push_back(complexity::measure([&]() {
+      copy.insertEdge("v0", "v50");
+      copy.removeEdge("v10", "v11");
+    }));
+    REQUIRE( g.numEdges() == n - 1 );
+  }
+
+  REQUIRE( cloneCosts.back().allocations == 0 );
+  REQUIRE( complexity::growsAtMost(sizes, editCosts, &Cost::allocations, complexity::LOGARITHMIC) );
+}
@@ -106,6 +106,24 @@ TEST_CASE("Directed: Graph::removeEdge is correct", "[weight=1]") {
   REQUIRE( g.isAdjacent("c", "a") == false );
 }
 
+TEST_CASE("Directed: Graph::removeEdge(Edge) removes the edge and its incoming entry", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTestDiGraph();
+  // No edge runs a -> c, so the reverse of c -> a is not removed:
+  g.removeEdge(DirectedEdge(Vertex("a"), Vertex("c")));
+  REQUIRE( g.numEdges() == 9 );
+
+  g.removeEdge(DirectedEdge(Vertex("c"), Vertex("a")));
+  REQUIRE( g.numEdges() == 8 );
+  REQUIRE( g.incidentEdges("a").size() == 2 );
+  REQUIRE( g.degree("a") == 2 );
+  REQUIRE( g.incidentEdges("c").size() == 3 );
+  REQUIRE( g.isAdjacent("c", "a") == false );
+
+  // Removing a vertex afterwards does not touch the removed edge:
+  g.removeVertex("a");
+  REQUIRE( g.numEdges() == 6 );
+}
+
 TEST_CASE("Directed: Graph::removeVertex is correct", "[weight=1]") {
   Graph<Vertex, DirectedEdge> g = createTestDiGraph();
   g.removeVertex("a");
@@ -115,3 +133,17 @@ TEST_CASE("Directed: Graph::removeVertex is correct", "[weight=1]") {
   REQUIRE( g.incidentEdges("c").size() == 3 );
   REQUIRE( g.incidentEdges("d").size() == 1 );
 }
+
+TEST_CASE("Directed: Graph::clone keeps edge directions", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTestDiGraph();
+  Graph<Vertex, DirectedEdge> copy = g.clone();
+
+  REQUIRE( copy.numEdges() == g.numEdges() );
+  REQUIRE( copy.degree("c") == 4 );
+  REQUIRE( copy.isAdjacent("c", "a") == true );
+  REQUIRE( copy.isAdjacent("a", "c") == false );
+
+  copy.removeVertex("c");
+  REQUIRE( copy.degree("a") == 2 );
+  REQUIRE( g.degree("a") == 3 );
+}
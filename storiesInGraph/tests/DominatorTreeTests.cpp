@@ -0,0 +1,97 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../DominatorTree.h"
+#include "../DirectedEdge.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Two ways around to the crossroads, then a detour before the ending:
+static Graph<Vertex, DirectedEdge> createDiamondStory() {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "forest", "river", "cross", "inn", "detour", "end", "island" }) { g.insertVertex(key); }
+  g.insertEdge("start", "forest");
+  g.insertEdge("start", "river");
+  g.insertEdge("forest", "cross");
+  g.insertEdge("river", "cross");
+  g.insertEdge("cross", "inn");
+  g.insertEdge("inn", "end");
+  g.insertEdge("inn", "detour");
+  g.insertEdge("detour", "end");
+  g.insertEdge("end", "forest");
+  return g;
+}
+
+// Every vertex reachable from `from` without passing through `avoid`:
+static std::vector<bool> search(const CsrGraph & g, uint32_t from, uint32_t avoid) {
+  std::vector<bool> seen(g.numVertices(), false);
+  if (from == avoid) { return seen; }
+  std::vector<uint32_t> stack{ from };
+  seen[from] = true;
+  while (!stack.empty()) {
+    uint32_t v = stack.back();
+    stack.pop_back();
+    for (uint32_t w : g.neighbors(v)) {
+      if (w != avoid && !seen[w]) { seen[w] = true; stack.push_back(w); }
+    }
+  }
+  return seen;
+}
+
+TEST_CASE("DominatorTree finds the passages every route to an ending passes", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createDiamondStory();
+  CsrGraph csr = CsrGraph::fromGraph(g);
+  DominatorTree tree(csr, csr.id("start"));
+
+  std::vector<std::string> mustVisit;
+  for (uint32_t v : tree.dominators(csr.id("end"))) { mustVisit.push_back(csr.key(v)); }
+  REQUIRE( mustVisit == std::vector<std::string>{ "start", "cross", "inn", "end" } );
+
+  REQUIRE( tree.idom(csr.id("cross")) == csr.id("start") );
+  REQUIRE( tree.idom(csr.id("start")) == DominatorTree::NONE );
+  REQUIRE( tree.dominates(csr.id("inn"), csr.id("detour")) );
+  REQUIRE( tree.dominates(csr.id("cross"), csr.id("cross")) );
+  REQUIRE_FALSE( tree.dominates(csr.id("forest"), csr.id("cross")) );
+  REQUIRE_FALSE( tree.dominates(csr.id("detour"), csr.id("end")) );
+
+  REQUIRE_FALSE( tree.reachable(csr.id("island")) );
+  REQUIRE( tree.idom(csr.id("island")) == DominatorTree::NONE );
+  REQUIRE( tree.dominators(csr.id("island")).empty() );
+  REQUIRE_FALSE( tree.dominates(csr.id("start"), csr.id("island")) );
+}
+
+TEST_CASE("DominatorTree agrees with removing each vertex in turn", "[weight=1]") {
+  const uint32_t n = 120;
+  std::mt19937 random(11);
+  std::uniform_int_distribution<uint32_t> vertex(0, n - 1);
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (int i = 0; i < 200; i++) { edges.push_back({ vertex(random), vertex(random) }); }
+  CsrGraph g = CsrGraph::fromEdges(n, edges);
+  DominatorTree tree(g, 0);
+
+  std::vector<bool> reachable = search(g, 0, DominatorTree::NONE);
+  size_t mismatches = 0;
+  for (uint32_t a = 0; a < n; a++) {
+    std::vector<bool> without = search(g, 0, a);
+    for (uint32_t b = 0; b < n; b++) {
+      bool dominates = reachable[a] && reachable[b] && (a == b || !without[b]);
+      if (tree.dominates(a, b) != dominates) { mismatches++; }
+    }
+    if (tree.reachable(a) != reachable[a]) { mismatches++; }
+  }
+  REQUIRE( mismatches == 0 );
+}
+
+TEST_CASE("DominatorTree handles a million-vertex chain", "[weight=1]") {
+  const uint32_t n = 1000000;
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t v = 0; v + 1 < n; v++) { edges.push_back({ v, v + 1 }); }
+  edges.push_back({ n - 1, 0 });
+
+  DominatorTree tree(CsrGraph::fromEdges(n, edges), 0);
+  REQUIRE( tree.idom(n - 1) == n - 2 );
+  REQUIRE( tree.dominates(1, n - 1) );
+  REQUIRE_FALSE( tree.dominates(n - 1, 1) );
+  REQUIRE( tree.dominators(n - 1).size() == n );
+}
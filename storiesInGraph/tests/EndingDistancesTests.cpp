@@ -0,0 +1,116 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../EndingDistances.h"
+#include "../DirectedEdge.h"
+#include "StoryFixture.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Counts the vertices where `table` differs from a table built from
+// scratch, or whose next hop is not an edge one step closer to an ending:
+template <class V, class E>
+static size_t mismatches(Graph<V,E> & g, const EndingDistances<V,E> & table, const std::vector<std::string> & keys) {
+  EndingDistances<V,E> expected(g);
+  size_t count = 0;
+  for (const std::string & key : keys) {
+    unsigned int distance = table.distance(key);
+    if (distance != expected.distance(key)) { count++; continue; }
+    const V * next = table.nextHop(key);
+    if (distance == 0 || distance == EndingDistances<V,E>::UNREACHABLE) {
+      if (next != nullptr) { count++; }
+    } else if (next == nullptr || !g.isAdjacent(key, next->key()) || table.distance(next->key()) != distance - 1) {
+      count++;
+    }
+  }
+  return count;
+}
+
+TEST_CASE("EndingDistances counts the choices left to the nearest ending", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTrapStory();
+  EndingDistances<Vertex, DirectedEdge> table(g);
+  const unsigned int UNREACHABLE = EndingDistances<Vertex, DirectedEdge>::UNREACHABLE;
+
+  REQUIRE( table.distance("end") == 0 );
+  REQUIRE( table.distance("right") == 1 );
+  REQUIRE( table.distance("left") == 3 );
+  REQUIRE( table.distance("start") == 3 );
+  REQUIRE( table.distance("trap1") == UNREACHABLE );
+  REQUIRE( table.nextHop("cross")->key() == "right" );
+  REQUIRE( table.nextHop("end") == nullptr );
+  REQUIRE( table.nextHop("trap2") == nullptr );
+  REQUIRE( table.pathToEnding("start") == std::list<std::string>{ "start", "cross", "right", "end" } );
+  REQUIRE( table.pathToEnding("trap1").empty() );
+  REQUIRE_THROWS_AS( table.distance("nowhere"), std::out_of_range );
+}
+
+TEST_CASE("EndingDistances repairs itself after each edit", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTrapStory();
+  EndingDistances<Vertex, DirectedEdge> table(g);
+  const unsigned int UNREACHABLE = EndingDistances<Vertex, DirectedEdge>::UNREACHABLE;
+
+  // A way out of the trap:
+  table.insertEdge("trap2", "end");
+  REQUIRE( table.distance("trap1") == 2 );
+
+  table.removeEdge("right", "end");
+  REQUIRE( table.distance("right") == 3 );
+  REQUIRE( table.distance("start") == 5 );
+  REQUIRE( table.pathToEnding("right") == std::list<std::string>{ "right", "trap1", "trap2", "end" } );
+
+  // Removing the only ending leaves no way to finish:
+  table.removeVertex("end");
+  for (std::string key : { "start", "cross", "left", "right", "trap1", "trap2" }) { REQUIRE( table.distance(key) == UNREACHABLE ); }
+
+  table.insertVertex("epilogue");
+  REQUIRE( table.distance("epilogue") == 0 );
+  table.insertEdge("left", "epilogue");
+  REQUIRE( table.distance("left") == 1 );
+  REQUIRE( table.distance("start") == 3 );
+  REQUIRE( table.distance("trap1") == UNREACHABLE );
+
+  // The epilogue is not an ending once it leads somewhere:
+  table.insertEdge("epilogue", "trap1");
+  REQUIRE( table.distance("start") == UNREACHABLE );
+  REQUIRE( g.numEdges() == 9 );
+}
+
+TEST_CASE("EndingDistances agrees with a rebuild after random edits", "[weight=1]") {
+  std::mt19937 random(7);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 40; i++) { keys.push_back("p" + std::to_string(i)); }
+  std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+  std::uniform_int_distribution<int> op(0, 9);
+
+  Graph<Vertex, DirectedEdge> directed;
+  Graph<Vertex, Edge> undirected;
+  EndingDistances<Vertex, DirectedEdge> directedTable(directed);
+  EndingDistances<Vertex, Edge> undirectedTable(undirected);
+  for (const std::string & key : keys) {
+    directedTable.insertVertex(key);
+    undirectedTable.insertVertex(key);
+  }
+
+  size_t count = 0;
+  for (int i = 0; i < 1500; i++) {
+    const std::string & a = keys[pick(random)];
+    const std::string & b = keys[pick(random)];
+    int choice = op(random);
+    if (choice < 4) {
+      directedTable.insertEdge(a, b);
+      if (a != b) { undirectedTable.insertEdge(a, b); }
+    } else if (choice < 9) {
+      // Remove an edge of `a`, if it has one:
+      for (const Edge & e : directed.incidentEdges(a)) { directedTable.removeEdge(e.source().key(), e.dest().key()); break; }
+      for (const Edge & e : undirected.incidentEdges(a)) { undirectedTable.removeEdge(e.source().key(), e.dest().key()); break; }
+    } else {
+      directedTable.removeVertex(a);
+      undirectedTable.removeVertex(a);
+      directedTable.insertVertex(a);
+      undirectedTable.insertVertex(a);
+    }
+    count += mismatches(directed, directedTable, keys) + mismatches(undirected, undirectedTable, keys);
+  }
+  REQUIRE( count == 0 );
+}
@@ -0,0 +1,86 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../Graph.h"
+#include "../Edge.h"
+#include "../DirectedEdge.h"
+#include "../Vertex.h"
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+Graph<Vertex, Edge> createTestGraph();
+
+static const std::vector<std::pair<std::string, std::string>> STORY_EDGES{
+  { "start", "forest" }, { "start", "river" }, { "forest", "cross" }, { "river", "cross" },
+  { "cross", "inn" }, { "inn", "end" }, { "inn", "detour" }, { "detour", "end" }
+};
+
+static Graph<Vertex, DirectedEdge> createStory(const std::vector<std::pair<std::string, std::string>> & edges) {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "forest", "river", "cross", "inn", "detour", "end", "epilogue" }) { g.insertVertex(key); }
+  for (const auto & edge : edges) { g.insertEdge(edge.first, edge.second); }
+  return g;
+}
+
+// Checks that consecutive keys of `cycle` (and the last and first) are joined by one of `edges`:
+static bool isCycle(const std::list<std::string> & cycle, const std::vector<std::pair<std::string, std::string>> & edges) {
+  std::set<std::pair<std::string, std::string>> edgeSet(edges.begin(), edges.end());
+  std::vector<std::string> keys(cycle.begin(), cycle.end());
+  if (keys.empty() || std::set<std::string>(keys.begin(), keys.end()).size() != keys.size()) { return false; }
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (edgeSet.count({ keys[i], keys[(i + 1) % keys.size()] }) == 0) { return false; }
+  }
+  return true;
+}
+
+TEST_CASE("Graph::topologicalOrder puts every passage before its choices", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createStory(STORY_EDGES);
+  std::list<std::string> order = g.topologicalOrder();
+  REQUIRE( order.size() == 8 );
+
+  std::unordered_map<std::string, size_t> position;
+  for (const std::string & key : order) { position[key] = position.size(); }
+  REQUIRE( position.size() == 8 );
+  for (const auto & edge : STORY_EDGES) { REQUIRE( position.at(edge.first) < position.at(edge.second) ); }
+  REQUIRE( g.findCycle().empty() );
+}
+
+TEST_CASE("Graph::findCycle returns a cycle the story loops around", "[weight=1]") {
+  std::vector<std::pair<std::string, std::string>> edges = STORY_EDGES;
+  edges.push_back({ "detour", "forest" });
+  Graph<Vertex, DirectedEdge> g = createStory(edges);
+
+  REQUIRE( g.topologicalOrder().empty() );
+  std::list<std::string> cycle = g.findCycle();
+  REQUIRE( cycle.size() == 4 );
+  REQUIRE( isCycle(cycle, edges) );
+
+  // A passage that leads back to itself:
+  Graph<Vertex, DirectedEdge> loop = createStory({ { "start", "end" }, { "end", "end" } });
+  REQUIRE( loop.findCycle() == std::list<std::string>{ "end" } );
+
+  // Any undirected Edge can be walked there and back:
+  REQUIRE( createTestGraph().topologicalOrder().empty() );
+  REQUIRE( createTestGraph().findCycle().size() == 2 );
+}
+
+TEST_CASE("Graph::findCycle finds a long cycle among half a million edges", "[weight=1]") {
+  const int n = 50000;
+  Graph<Vertex, DirectedEdge> g;
+  for (int i = 0; i < n; i++) { g.insertVertex(std::to_string(i)); }
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j <= i + 10 && j < n; j++) { g.insertEdge(std::to_string(i), std::to_string(j)); }
+  }
+  REQUIRE( g.numEdges() > 490000 );
+  REQUIRE( g.topologicalOrder().front() == "0" );
+  REQUIRE( g.findCycle().empty() );
+
+  g.insertEdge(std::to_string(n - 1), "0");
+  std::list<std::string> cycle = g.findCycle();
+  REQUIRE( cycle.size() >= 2 );
+  REQUIRE( g.isAdjacent(cycle.back(), cycle.front()) );
+  REQUIRE( g.topologicalOrder().empty() );
+}
@@ -0,0 +1,81 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../Graph.h"
+#include "../Edge.h"
+#include "../DirectedEdge.h"
+#include "../Vertex.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+Graph<Vertex, Edge> createTestGraph();
+
+TEST_CASE("Graph::kShortestPaths returns the shortest routes first", "[weight=1]") {
+  Graph<Vertex, Edge> g = createTestGraph();
+  std::vector<std::list<std::string>> paths = g.kShortestPaths("a", "e", 3);
+
+  REQUIRE( paths.size() == 3 );
+  REQUIRE( paths[0].size() == 3 );
+  REQUIRE( paths[1].size() == 3 );
+  REQUIRE( paths[2] == std::list<std::string>{ "a", "b", "c", "e" } );
+  REQUIRE( std::set<std::list<std::string>>(paths.begin(), paths.begin() + 2) == std::set<std::list<std::string>>{
+    { "a", "c", "e" }, { "a", "d", "e" }
+  } );
+  REQUIRE( paths[0].size() == g.shortestPath("a", "e").size() );
+
+  REQUIRE( g.kShortestPaths("a", "e", 0).empty() );
+  REQUIRE( g.kShortestPaths("a", "a", 5) == std::vector<std::list<std::string>>{ { "a" } } );
+  REQUIRE_THROWS_AS( g.kShortestPaths("a", "nowhere", 1), std::out_of_range );
+}
+
+TEST_CASE("Graph::kShortestPaths follows the direction of directed edges", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "left", "right", "end" }) { g.insertVertex(key); }
+  g.insertEdge("start", "left");
+  g.insertEdge("start", "right");
+  g.insertEdge("left", "end");
+  g.insertEdge("right", "end");
+  g.insertEdge("left", "right");
+
+  std::vector<std::list<std::string>> paths = g.kShortestPaths("start", "end", 10);
+  REQUIRE( paths.size() == 3 );
+  REQUIRE( paths[2] == std::list<std::string>{ "start", "left", "right", "end" } );
+  REQUIRE( g.kShortestPaths("end", "start", 10).empty() );
+}
+
+TEST_CASE("Graph::kShortestPaths agrees with enumerating every simple path", "[weight=1]") {
+  std::mt19937 random(5);
+  for (int trial = 0; trial < 5; trial++) {
+    Graph<Vertex, DirectedEdge> g;
+    const int n = 12;
+    for (int i = 0; i < n; i++) { g.insertVertex(std::to_string(i)); }
+    for (int i = 0; i < 36; i++) {
+      std::string a = std::to_string(random() % n), b = std::to_string(random() % n);
+      if (a != b && !g.isAdjacent(a, b)) { g.insertEdge(a, b); }
+    }
+
+    std::vector<size_t> lengths;
+    std::set<std::vector<std::string>> all;
+    for (const auto & path : g.pathsBetween("0", "1", n)) {
+      std::vector<std::string> keys;
+      for (const Vertex & v : path) { keys.push_back(v.key()); }
+      all.insert(keys);
+      lengths.push_back(keys.size());
+    }
+    std::sort(lengths.begin(), lengths.end());
+
+    std::vector<std::list<std::string>> paths = g.kShortestPaths("0", "1", 20);
+    REQUIRE( paths.size() == std::min<size_t>(20, all.size()) );
+    std::set<std::vector<std::string>> distinct;
+    for (size_t i = 0; i < paths.size(); i++) {
+      REQUIRE( paths[i].size() == lengths[i] );
+      std::vector<std::string> keys(paths[i].begin(), paths[i].end());
+      REQUIRE( all.count(keys) == 1 );
+      distinct.insert(keys);
+    }
+    REQUIRE( distinct.size() == paths.size() );
+  }
+}
@@ -0,0 +1,104 @@
+#include "../cs225/catch/catch.hpp"
+
+// Counters change the layout of Graph, so they are enabled for a whole
+// build: these tests count only in `make test-stats`.
+
+#include "../Graph.h"
+#include "../Edge.h"
+#include "../Vertex.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+static Graph<Vertex, Edge> createStar(int leaves) {
+  Graph<Vertex, Edge> g;
+  g.insertVertex("hub");
+  for (int i = 0; i < leaves; i++) {
+    g.insertVertex("leaf" + std::to_string(i));
+    g.insertEdge("hub", "leaf" + std::to_string(i));
+  }
+  return g;
+}
+
+#ifdef GRAPH_STATS
+
+TEST_CASE("Graph::stats counts calls of each operation", "[weight=1]") {
+  Graph<Vertex, Edge> g = createStar(10);
+  GraphStats stats = g.stats();
+
+  REQUIRE( stats.get(GraphStats::INSERT_VERTEX, GraphStats::CALLS) == 11 );
+  REQUIRE( stats.get(GraphStats::INSERT_EDGE, GraphStats::CALLS) == 10 );
+  REQUIRE( stats.get(GraphStats::INSERT_EDGE, GraphStats::ALLOCATIONS) > 0 );
+  REQUIRE( stats.get(GraphStats::SHORTEST_PATH, GraphStats::CALLS) == 0 );
+}
+
+TEST_CASE("Graph::stats counts the work insertVertex does", "[weight=1]") {
+  Graph<Vertex, Edge> g;
+  g.insertVertex("a");
+  GraphStats stats = g.stats();
+
+  // A lookup for an existing vertex, then the vertex and one node in each
+  // of vertexMap and adjList, each with a copy of the key:
+  REQUIRE( stats.get(GraphStats::INSERT_VERTEX, GraphStats::HASH_LOOKUPS) == 3 );
+  REQUIRE( stats.get(GraphStats::INSERT_VERTEX, GraphStats::ALLOCATIONS) == 3 );
+  REQUIRE( stats.get(GraphStats::INSERT_VERTEX, GraphStats::STRING_COPIES) == 3 );
+}
+
+TEST_CASE("Graph::stats charges nested work to the outermost operation", "[weight=1]") {
+  Graph<Vertex, Edge> g = createStar(10);
+  g.resetStats();
+  REQUIRE( g.stats().total(GraphStats::CALLS) == 0 );
+
+  g.shortestPath("leaf0", "leaf1");
+  GraphStats stats = g.stats();
+
+  // shortestPath calls incidentEdges internally:
+  REQUIRE( stats.get(GraphStats::SHORTEST_PATH, GraphStats::CALLS) == 1 );
+  REQUIRE( stats.get(GraphStats::INCIDENT_EDGES, GraphStats::CALLS) == 0 );
+  REQUIRE( stats.get(GraphStats::SHORTEST_PATH, GraphStats::EDGES_SCANNED) >= 10 );
+  REQUIRE( stats.get(GraphStats::SHORTEST_PATH, GraphStats::HASH_LOOKUPS) > 0 );
+}
+
+TEST_CASE("Graph::stats shows isAdjacent scanning only the first vertex's edges", "[weight=1]") {
+  Graph<Vertex, Edge> g = createStar(10);
+  g.resetStats();
+
+  g.isAdjacent("leaf3", "hub");
+  REQUIRE( g.stats().get(GraphStats::IS_ADJACENT, GraphStats::EDGES_SCANNED) == 1 );
+
+  // The hub's newest edges come first, so leaf3 is the 7th of them; each
+  // edge scanned copies the keys of both of its endpoints:
+  g.resetStats();
+  g.isAdjacent("hub", "leaf3");
+  REQUIRE( g.stats().get(GraphStats::IS_ADJACENT, GraphStats::EDGES_SCANNED) == 7 );
+  REQUIRE( g.stats().get(GraphStats::IS_ADJACENT, GraphStats::STRING_COPIES) == 14 );
+}
+
+TEST_CASE("Graph::stats counts const queries made from several threads", "[weight=1]") {
+  const Graph<Vertex, Edge> g = createStar(10);
+  const_cast<Graph<Vertex, Edge> &>(g).resetStats();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([&g]() {
+      for (int i = 0; i < 1000; i++) { g.isAdjacent("leaf3", "hub"); }
+    }));
+  }
+  for (std::thread & thread : threads) { thread.join(); }
+
+  REQUIRE( g.stats().get(GraphStats::IS_ADJACENT, GraphStats::CALLS) == 4000 );
+  REQUIRE( g.stats().get(GraphStats::IS_ADJACENT, GraphStats::EDGES_SCANNED) == 4000 );
+}
+
+#else
+
+TEST_CASE("Graph::stats is all zeros without GRAPH_STATS", "[weight=1]") {
+  Graph<Vertex, Edge> g = createStar(10);
+  g.shortestPath("leaf0", "leaf1");
+
+  REQUIRE( g.stats().total(GraphStats::CALLS) == 0 );
+  REQUIRE( g.stats().total(GraphStats::EDGES_SCANNED) == 0 );
+}
+
+#endif
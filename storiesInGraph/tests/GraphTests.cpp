@@ -132,6 +132,25 @@ TEST_CASE("Graph::removeEdge is correct", "[weight=1]") {
   REQUIRE( g.incidentEdges("c").size() == 3 );
 }
 
+TEST_CASE("Graph::removeEdge(Edge) matches an undirected edge in either direction", "[weight=1]") {
+  Graph<Vertex, Edge> g = createTestGraph();
+  g.removeEdge(Edge(Vertex("c"), Vertex("a")));
+  REQUIRE( g.numEdges() == 8 );
+  REQUIRE( g.incidentEdges("a").size() == 2 );
+  REQUIRE( g.incidentEdges("c").size() == 3 );
+  REQUIRE( g.isAdjacent("a", "c") == false );
+
+  // A loop is in its vertex's list twice:
+  g.insertEdge("f", "f");
+  REQUIRE( g.degree("f") == 3 );
+  g.removeEdge(Edge(Vertex("f"), Vertex("f")));
+  REQUIRE( g.degree("f") == 1 );
+  REQUIRE( g.numEdges() == 8 );
+
+  g.removeVertex("c");
+  REQUIRE( g.numEdges() == 5 );
+}
+
 TEST_CASE("Graph::removeVertex is correct", "[weight=1]") {
   Graph<Vertex, Edge> g = createTestGraph();
   g.removeVertex("a");
@@ -141,3 +160,62 @@ TEST_CASE("Graph::removeVertex is correct", "[weight=1]") {
   REQUIRE( g.incidentEdges("c").size() == 3 );
   REQUIRE( g.incidentEdges("d").size() == 1 );
 }
+
+TEST_CASE("Graph::insertVertex returns the existing vertex for a repeated key", "[weight=1]") {
+  Graph<Vertex, Edge> g;
+  Vertex & a = g.insertVertex("a");
+  a["prop"] = "kept";
+  g.insertVertex("b");
+  g.insertEdge("a", "b");
+
+  Vertex & again = g.insertVertex("a");
+  REQUIRE( &again == &a );
+  REQUIRE( again.property("prop") == "kept" );
+  REQUIRE( g.numVertices() == 2 );
+  REQUIRE( g.degree("a") == 1 );
+}
+
+TEST_CASE("Graph move construction and assignment transfer every vertex and edge", "[weight=1]") {
+  Graph<Vertex, Edge> g = createTestGraph();
+  Edge & ab = g.incidentEdges("a").back();
+
+  Graph<Vertex, Edge> moved(std::move(g));
+  REQUIRE( g.numVertices() == 0 );
+  REQUIRE( g.numEdges() == 0 );
+  REQUIRE( moved.numVertices() == 8 );
+  REQUIRE( moved.numEdges() == 9 );
+  REQUIRE( &moved.incidentEdges("a").back().get() == &ab );
+
+  Graph<Vertex, Edge> assigned;
+  assigned.insertVertex("z");
+  assigned = std::move(moved);
+  REQUIRE( assigned.numVertices() == 8 );
+  REQUIRE( assigned.numEdges() == 9 );
+  assigned.removeVertex("a");
+  REQUIRE( assigned.numEdges() == 6 );
+  REQUIRE( assigned.shortestPath("b", "e").size() == 3 );
+}
+
+TEST_CASE("Graph::clone is a deep copy", "[weight=1]") {
+  Graph<Vertex, Edge> g = createTestGraph();
+  g.insertEdge("f", "f")["name"] = "loop";
+  Graph<Vertex, Edge> copy = g.clone();
+
+  REQUIRE( copy.numVertices() == g.numVertices() );
+  REQUIRE( copy.numEdges() == g.numEdges() );
+  REQUIRE( copy.incidentEdges("f").front().get().property("name") == "loop" );
+  REQUIRE( &copy.incidentEdges("f").front().get() != &g.incidentEdges("f").front().get() );
+
+  // Adjacency lists keep their order:
+  std::list<std::reference_wrapper<Edge>> original = g.incidentEdges("c"), cloned = copy.incidentEdges("c");
+  REQUIRE( std::equal(original.begin(), original.end(), cloned.begin(),
+    [](const Edge & e1, const Edge & e2) { return e1 == e2; }) );
+
+  // Changing one graph leaves the other alone:
+  copy.removeVertex("c");
+  copy.removeVertex("f");
+  REQUIRE( g.numEdges() == 10 );
+  REQUIRE( g.incidentEdges("c").size() == 4 );
+  REQUIRE( g.shortestPath("a", "h").size() == 3 );
+  REQUIRE( copy.numEdges() == 4 );
+}
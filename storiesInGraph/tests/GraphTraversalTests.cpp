@@ -0,0 +1,109 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../Graph.h"
+#include "../Edge.h"
+#include "../DirectedEdge.h"
+#include "../Vertex.h"
+#include "ComplexityHarness.hpp"
+
+#include <set>
+#include <string>
+#include <vector>
+
+Graph<Vertex, Edge> createTestGraph();
+
+template <class V, class E>
+static std::vector<std::string> keys(const std::vector<std::reference_wrapper<const V>> & path) {
+  std::vector<std::string> result;
+  for (const V & v : path) { result.push_back(v.key()); }
+  return result;
+}
+
+TEST_CASE("Graph::bfsOrder visits every reachable vertex by distance", "[weight=1]") {
+  Graph<Vertex, Edge> g = createTestGraph();
+  std::vector<std::string> order;
+  for (const Vertex & v : g.bfsOrder("a")) { order.push_back(v.key()); }
+
+  REQUIRE( order.size() == 8 );
+  REQUIRE( order.front() == "a" );
+  REQUIRE( std::set<std::string>(order.begin(), order.end()).size() == 8 );
+  for (size_t i = 1; i < order.size(); i++) {
+    REQUIRE( g.shortestPath("a", order[i - 1]).size() <= g.shortestPath("a", order[i]).size() );
+  }
+}
+
+TEST_CASE("Graph::dfsOrder visits every reachable vertex once, depth first", "[weight=1]") {
+  Graph<Vertex, Edge> g = createTestGraph();
+  std::vector<std::string> order;
+  for (const Vertex & v : g.dfsOrder("f")) { order.push_back(v.key()); }
+
+  REQUIRE( order.size() == 8 );
+  REQUIRE( std::set<std::string>(order.begin(), order.end()).size() == 8 );
+  // f - g - h is the only way into the rest of the graph:
+  REQUIRE( order[0] == "f" );
+  REQUIRE( order[1] == "g" );
+  REQUIRE( order[2] == "h" );
+  REQUIRE( order[3] == "c" );
+}
+
+TEST_CASE("Graph::pathsBetween yields every simple path up to a length", "[weight=1]") {
+  Graph<Vertex, Edge> g = createTestGraph();
+  std::set<std::vector<std::string>> paths;
+  for (const auto & path : g.pathsBetween("a", "e", 3)) { paths.insert(keys<Vertex, Edge>(path)); }
+
+  REQUIRE( paths == std::set<std::vector<std::string>>{
+    { "a", "c", "e" }, { "a", "d", "e" }, { "a", "b", "c", "e" }
+  } );
+
+  size_t count = 0;
+  for (const auto & path : g.pathsBetween("a", "e", 2)) { count++; }
+  REQUIRE( count == 2 );
+
+  count = 0;
+  for (const auto & path : g.pathsBetween("a", "a", 5)) { count++; }
+  REQUIRE( count == 1 );
+  REQUIRE_THROWS_AS( g.pathsBetween("a", "nowhere", 5), std::out_of_range );
+}
+
+TEST_CASE("Lazy traversals follow the direction of directed edges", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "left", "right", "end" }) { g.insertVertex(key); }
+  g.insertEdge("start", "left");
+  g.insertEdge("start", "right");
+  g.insertEdge("left", "end");
+  g.insertEdge("right", "end");
+
+  size_t count = 0;
+  for (const Vertex & v : g.bfsOrder("left")) { count++; }
+  REQUIRE( count == 2 );
+
+  std::set<std::vector<std::string>> paths;
+  for (const auto & path : g.pathsBetween("start", "end", 10)) { paths.insert(keys<Vertex, DirectedEdge>(path)); }
+  REQUIRE( paths.size() == 2 );
+  REQUIRE( g.pathsBetween("end", "start", 10).begin() == g.pathsBetween("end", "start", 10).end() );
+}
+
+TEST_CASE("Stopping a lazy traversal early costs O(1) at any graph size", "[weight=1]") {
+  using complexity::Cost;
+  std::vector<size_t> sizes{ 100, 1000, 10000 };
+  std::vector<Cost> bfsCosts, dfsCosts;
+
+  for (size_t n : sizes) {
+    Graph<CountingVertex, CountingEdge> g;
+    for (size_t i = 0; i < n; i++) { g.insertVertex("c" + std::to_string(i)); }
+    for (size_t i = 0; i + 1 < n; i++) { g.insertEdge("c" + std::to_string(i), "c" + std::to_string(i + 1)); }
+
+    auto firstFive = [](auto && traversal) {
+      size_t count = 0;
+      for (auto it = traversal.begin(); it != traversal.end() && count < 5; ++it) { count++; }
+      return count;
+    };
+    bfsCosts.push_back(complexity::measure([&]() { REQUIRE( firstFive(g.bfsOrder("c0")) == 5 ); }));
+    dfsCosts.push_back(complexity::measure([&]() { REQUIRE( firstFive(g.dfsOrder("c0")) == 5 ); }));
+  }
+
+  REQUIRE( complexity::growsAtMost(sizes, bfsCosts, &Cost::allocations, complexity::CONSTANT) );
+  REQUIRE( complexity::growsAtMost(sizes, bfsCosts, &Cost::keyCalls, complexity::CONSTANT) );
+  REQUIRE( complexity::growsAtMost(sizes, dfsCosts, &Cost::allocations, complexity::CONSTANT) );
+  REQUIRE( complexity::growsAtMost(sizes, dfsCosts, &Cost::keyCalls, complexity::CONSTANT) );
+}
@@ -0,0 +1,102 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../CsrGraph.h"
+#include "../PageRank.h"
+#include "../DirectedEdge.h"
+#include "StoryFixture.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// A plain power iteration, one edge at a time:
+static std::vector<double> naiveRanks(const CsrGraph & g, const std::vector<double> & teleport, double damping) {
+  uint32_t n = g.numVertices();
+  std::vector<double> ranks = teleport;
+  for (int i = 0; i < 500; i++) {
+    std::vector<double> next(n, 0);
+    double lost = 1 - damping;
+    for (uint32_t v = 0; v < n; v++) {
+      if (g.degree(v) == 0) { lost += damping * ranks[v]; }
+      for (uint32_t w : g.neighbors(v)) { next[w] += damping * ranks[v] / g.degree(v); }
+    }
+    for (uint32_t v = 0; v < n; v++) { next[v] += lost * teleport[v]; }
+    ranks = next;
+  }
+  return ranks;
+}
+
+static double sum(const std::vector<double> & values) {
+  double total = 0;
+  for (double value : values) { total += value; }
+  return total;
+}
+
+TEST_CASE("PageRank ranks a cycle evenly and a sink highest", "[weight=1]") {
+  PageRank cycle(CsrGraph::fromEdges(3, { { 0, 1 }, { 1, 2 }, { 2, 0 } }));
+  PageRank::Result result = cycle.rank();
+  for (double rank : result.ranks) { REQUIRE( rank == Approx(1.0 / 3) ); }
+
+  // Everything leads to 0, which jumps anywhere:
+  PageRank star(CsrGraph::fromEdges(4, { { 1, 0 }, { 2, 0 }, { 3, 0 } }));
+  result = star.rank();
+  REQUIRE( sum(result.ranks) == Approx(1) );
+  REQUIRE( result.ranks[0] > result.ranks[1] );
+  REQUIRE( result.ranks[1] == Approx(result.ranks[3]) );
+  REQUIRE( result.change < 1e-10 );
+
+  REQUIRE( PageRank(CsrGraph()).rank().ranks.empty() );
+}
+
+TEST_CASE("PageRank matches a plain power iteration", "[weight=1]") {
+  CsrGraph g = randomGraph(2000, 10000, 7, 10);
+  PageRankOptions options;
+  options.tolerance = 1e-13;
+  options.maxIterations = 500;
+  PageRank pageRank(g, options);
+
+  PageRank::Result result = pageRank.rank();
+  std::vector<double> expected = naiveRanks(g, std::vector<double>(2000, 1.0 / 2000), options.damping);
+  REQUIRE( result.iterations < 500 );
+  REQUIRE( sum(result.ranks) == Approx(1) );
+  for (uint32_t v = 0; v < 2000; v++) { REQUIRE( std::abs(result.ranks[v] - expected[v]) < 1e-12 ); }
+
+  // Stopping early:
+  options.maxIterations = 3;
+  REQUIRE( PageRank(g, options).rank().iterations == 3 );
+}
+
+TEST_CASE("PageRank::personalized ranks only what the sources reach", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> story = createTrapStory();
+  CsrGraph g = CsrGraph::fromGraph(story);
+  PageRank pageRank(g);
+
+  PageRank::Result result = pageRank.personalized({ g.id("right") });
+  REQUIRE( sum(result.ranks) == Approx(1) );
+  REQUIRE( result.ranks[g.id("start")] == 0 );
+  REQUIRE( result.ranks[g.id("cross")] == 0 );
+  REQUIRE( result.ranks[g.id("left")] == 0 );
+  REQUIRE( result.ranks[g.id("trap1")] > result.ranks[g.id("end")] );
+
+  // Agrees with the plain iteration, with every jump to one of the sources:
+  std::vector<double> teleport(g.numVertices(), 0);
+  teleport[g.id("start")] = teleport[g.id("trap2")] = 0.5;
+  std::vector<double> expected = naiveRanks(g, teleport, 0.85);
+  result = pageRank.personalized({ g.id("start"), g.id("trap2") });
+  for (uint32_t v = 0; v < g.numVertices(); v++) { REQUIRE( result.ranks[v] == Approx(expected[v]) ); }
+
+  REQUIRE_THROWS_AS( pageRank.personalized({}), std::invalid_argument );
+}
+
+TEST_CASE("PageRank gives the same ranks with any number of threads", "[weight=1]") {
+  CsrGraph g = randomGraph(100000, 500000, 11, 10);
+  PageRankOptions options;
+  options.threads = 1;
+  PageRank::Result one = PageRank(g, options).rank();
+  options.threads = 4;
+  PageRank::Result four = PageRank(g, options).rank();
+
+  REQUIRE( one.iterations == four.iterations );
+  REQUIRE( one.ranks == four.ranks );
+  REQUIRE( one.change < options.tolerance );
+}
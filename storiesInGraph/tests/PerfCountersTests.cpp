@@ -0,0 +1,87 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../PerfCounters.h"
+#include "../Graph.h"
+#include "../Edge.h"
+#include "../Vertex.h"
+
+#include <sstream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Hardware counters are often unavailable (virtual machines, containers,
+// perf_event_paranoid > 2), so only readings that were taken are checked.
+
+TEST_CASE("PerfScope counts the events of its scope", "[weight=1]") {
+  Graph<Vertex, Edge> g;
+  for (int i = 0; i < 1000; i++) { g.insertVertex(std::to_string(i)); }
+
+  PerfCounters::Reading small, large;
+  {
+    PerfScope scope(small);
+    g.insertEdge("0", "1");
+  }
+  {
+    PerfScope scope(large);
+    for (int i = 1; i < 1000; i++) { g.insertEdge("0", std::to_string(i)); }
+  }
+
+  if (large.available[PerfCounters::INSTRUCTIONS]) {
+    REQUIRE( large.get(PerfCounters::INSTRUCTIONS) > 0 );
+    REQUIRE( large.get(PerfCounters::INSTRUCTIONS) > small.get(PerfCounters::INSTRUCTIONS) );
+  }
+  REQUIRE( small.available[PerfCounters::CYCLES] == large.available[PerfCounters::CYCLES] );
+}
+
+TEST_CASE("PerfCounters::Reading prints its available counters", "[weight=1]") {
+  PerfCounters::Reading reading;
+  std::stringstream none;
+  none << reading;
+  REQUIRE( none.str() == "(no performance counters available)" );
+
+  reading.available[PerfCounters::BRANCH_MISSES] = true;
+  reading.values[PerfCounters::BRANCH_MISSES] = 42;
+  reading.values[PerfCounters::CYCLES] = 7;
+  std::stringstream one;
+  one << reading;
+  REQUIRE( one.str() == "branchMisses=42" );
+  REQUIRE( reading.get(PerfCounters::CYCLES) == 0 );
+}
+
+TEST_CASE("PerfCounters opened in a forked child count the child's work", "[weight=1]") {
+  // The child measures a loop and sends its reading back through a pipe:
+  int fds[2];
+  REQUIRE( pipe(fds) == 0 );
+  pid_t pid = fork();
+  REQUIRE( pid >= 0 );
+  if (pid == 0) {
+    close(fds[0]);
+    PerfCounters counters;
+    counters.start();
+    volatile unsigned long long sum = 0;
+    for (int i = 0; i < 1000000; i++) { sum = sum + i; }
+    PerfCounters::Reading reading = counters.stop();
+    ssize_t written = write(fds[1], &reading, sizeof(reading));
+    _exit(written == (ssize_t) sizeof(reading) ? 0 : 1);
+  }
+
+  close(fds[1]);
+  PerfCounters::Reading reading;
+  ssize_t got = read(fds[0], &reading, sizeof(reading));
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  REQUIRE( got == (ssize_t) sizeof(reading) );
+  REQUIRE( WIFEXITED(status) );
+  REQUIRE( WEXITSTATUS(status) == 0 );
+
+  // A million iterations are at least a million instructions:
+  if (reading.available[PerfCounters::INSTRUCTIONS]) {
+    REQUIRE( reading.get(PerfCounters::INSTRUCTIONS) > 1000000 );
+  }
+  PerfCounters::Reading parent;
+  { PerfScope scope(parent); }
+  REQUIRE( reading.available[PerfCounters::INSTRUCTIONS] == parent.available[PerfCounters::INSTRUCTIONS] );
+}
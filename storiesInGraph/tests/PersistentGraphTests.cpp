@@ -0,0 +1,208 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../PersistentGraph.h"
+#include "../DirectedEdge.h"
+#include "StoryFixture.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool fileExists(const std::string & path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+static PersistentGraphOptions foregroundOptions() {
+  PersistentGraphOptions options;
+  options.backgroundCompaction = false;
+  return options;
+}
+
+static void buildStory(PersistentGraph<Vertex, DirectedEdge> & g) {
+  for (std::string key : { "start", "left", "right", "end" }) { g.insertVertex(key); }
+  g.insertEdge("start", "left");
+  g.insertEdge("start", "right");
+  g.insertEdge("left", "end");
+  g.insertEdge("right", "end");
+  g.setVertexProperty("start", "content", "You wake up.");
+  g.setEdgeProperty("start", "left", "content", "Go left.");
+}
+
+static void requireStory(const Graph<Vertex, DirectedEdge> & g) {
+  REQUIRE( g.numVertices() == 4 );
+  REQUIRE( g.numEdges() == 4 );
+  REQUIRE( g.isAdjacent("start", "left") );
+  REQUIRE( g.incidentEdges("end").size() == 2 );
+  REQUIRE( g.incidentEdges("start").size() == 2 );
+  for (const DirectedEdge & e : g.incidentEdges("left")) {
+    if (e.source().key() == "start") { REQUIRE( e.property("content") == "Go left." ); }
+  }
+}
+
+TEST_CASE("PersistentGraph replays its log when reopened", "[weight=1]") {
+  StoryDir graphDir({});
+  const std::string & dir = graphDir.path();
+  {
+    PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+    buildStory(g);
+    g.insertVertex("cave");
+    g.insertEdge("left", "cave");
+    g.removeEdge("left", "cave");
+    g.removeVertex("cave");
+    REQUIRE_THROWS_AS( g.insertEdge("start", "nowhere"), std::out_of_range );
+    REQUIRE_THROWS_AS( g.setEdgeProperty("left", "right", "content", "No."), std::out_of_range );
+  }
+
+  PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+  requireStory(g.graph());
+  REQUIRE( g.graph().incidentEdges("start").size() == 2 );
+}
+
+TEST_CASE("PersistentGraph::compact replaces the log with a snapshot", "[weight=1]") {
+  StoryDir graphDir({});
+  const std::string & dir = graphDir.path();
+  {
+    PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+    buildStory(g);
+    g.compact();
+    REQUIRE( fileExists(dir + "snapshot") );
+    REQUIRE_FALSE( fileExists(dir + "log.0") );
+    REQUIRE( g.logBytes() == 0 );
+
+    // Mutations after the snapshot go to the new log:
+    g.insertVertex("cave");
+    g.insertEdge("left", "cave");
+    g.setEdgeProperty("left", "cave", "content", "Climb down.");
+  }
+
+  PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+  REQUIRE( g.graph().numVertices() == 5 );
+  REQUIRE( g.graph().numEdges() == 5 );
+  REQUIRE( g.graph().incidentEdges("cave").front().get().property("content") == "Climb down." );
+  g.removeVertex("cave");
+  requireStory(g.graph());
+}
+
+TEST_CASE("PersistentGraph drops a torn record at the end of the log", "[weight=1]") {
+  StoryDir graphDir({});
+  const std::string & dir = graphDir.path();
+  {
+    PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+    buildStory(g);
+  }
+  {
+    // A record cut short by a crash:
+    std::ofstream log(dir + "log.0", std::ios::app | std::ios::binary);
+    log << std::string("\x40\x00\x00\x00\x12\x34", 6);
+  }
+  {
+    PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+    requireStory(g.graph());
+    g.insertVertex("cave");
+  }
+
+  PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+  REQUIRE( g.graph().numVertices() == 5 );
+}
+
+TEST_CASE("PersistentGraph keeps every concurrent mutation", "[weight=1]") {
+  StoryDir graphDir({});
+  const std::string & dir = graphDir.path();
+  PersistentGraphOptions options;
+  options.compactBytes = 1024;  // Compact in the background many times
+  {
+    PersistentGraph<Vertex, Edge> g(dir, options);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+      writers.push_back(std::thread([&g, t]() {
+        std::string previous;
+        for (int i = 0; i < 50; i++) {
+          std::string key = std::to_string(t) + "-" + std::to_string(i);
+          g.insertVertex(key);
+          if (i > 0) { g.insertEdge(previous, key); }
+          previous = key;
+        }
+      }));
+    }
+    for (std::thread & writer : writers) { writer.join(); }
+  }
+
+  PersistentGraph<Vertex, Edge> g(dir, options);
+  REQUIRE( g.graph().numVertices() == 200 );
+  REQUIRE( g.graph().numEdges() == 196 );
+  REQUIRE( g.graph().isAdjacent("3-25", "3-26") );
+  REQUIRE( g.graph().degree("3-25") == 2 );
+}
+
+TEST_CASE("PersistentGraph refuses to open a corrupt snapshot", "[weight=1]") {
+  StoryDir graphDir({});
+  const std::string & dir = graphDir.path();
+  {
+    PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+    buildStory(g);
+    g.compact();
+  }
+  {
+    std::fstream snapshot(dir + "snapshot", std::ios::in | std::ios::out | std::ios::binary);
+    snapshot.seekp(-1, std::ios::end);
+    snapshot.put('?');
+  }
+
+  REQUIRE_THROWS_AS( (PersistentGraph<Vertex, DirectedEdge>(dir, foregroundOptions())), std::runtime_error );
+}
+
+TEST_CASE("PersistentGraph rejects mutations once its log cannot be written", "[weight=1]") {
+  StoryDir graphDir({});
+  const std::string & dir = graphDir.path();
+  // Every write to /dev/full fails:
+  REQUIRE( symlink("/dev/full", (dir + "log.0").c_str()) == 0 );
+
+  PersistentGraph<Vertex, DirectedEdge> g(dir, foregroundOptions());
+  REQUIRE_THROWS_AS( g.insertVertex("start"), std::runtime_error );
+  size_t vertices = g.graph().numVertices();
+  REQUIRE_THROWS_AS( g.insertVertex("end"), std::runtime_error );
+  REQUIRE_THROWS_AS( g.sync(), std::runtime_error );
+  REQUIRE( g.graph().numVertices() == vertices );
+}
+
+TEST_CASE("PersistentGraph retries a failed background compaction and reports it", "[weight=1]") {
+  StoryDir graphDir({});
+  const std::string & dir = graphDir.path();
+  PersistentGraphOptions options;
+  options.compactBytes = 256;
+
+  auto waitFor = [](const std::function<bool()> & done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return done();
+  };
+  auto syncFails = [](PersistentGraph<Vertex, DirectedEdge> & g) {
+    try { g.sync(); } catch (const std::runtime_error &) { return true; }
+    return false;
+  };
+
+  {
+    PersistentGraph<Vertex, DirectedEdge> g(dir, options);
+    // The snapshot cannot be written while a directory is in the way:
+    REQUIRE( mkdir((dir + "snapshot.tmp").c_str(), 0755) == 0 );
+    buildStory(g);
+    REQUIRE( waitFor([&]() { return syncFails(g); }) );
+    REQUIRE_FALSE( fileExists(dir + "snapshot") );
+
+    // Mutations still succeed, and the next retry compacts:
+    g.insertVertex("cave");
+    REQUIRE( rmdir((dir + "snapshot.tmp").c_str()) == 0 );
+    REQUIRE( waitFor([&]() { return fileExists(dir + "snapshot") && !syncFails(g); }) );
+  }
+
+  PersistentGraph<Vertex, DirectedEdge> g(dir, options);
+  REQUIRE( g.graph().numVertices() == 5 );
+}
@@ -0,0 +1,68 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../PlaythroughSimulator.h"
+#include "../RouteStatistics.h"
+#include "../DirectedEdge.h"
+#include "StoryFixture.hpp"
+
+#include <string>
+
+TEST_CASE("PlaythroughSimulator picks choices in proportion to their weight", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "a", "b", "c", "d", "never" }) { g.insertVertex(key); }
+  g.insertEdge("start", "a")["weight"] = "1";
+  g.insertEdge("start", "b")["weight"] = "2";
+  g.insertEdge("start", "c")["weight"] = "3";
+  g.insertEdge("start", "d");  // Unset: the Edge's weight, 1
+  g.insertEdge("start", "never")["weight"] = "0";
+
+  PlaythroughSimulator simulator(g);
+  SimulationOptions options;
+  options.threads = 4;
+  const uint64_t n = 200000;
+  SimulationResult result = simulator.run("start", n, options);
+
+  REQUIRE( result.playthroughs == n );
+  REQUIRE( result.unfinished == 0 );
+  REQUIRE( result.visits[simulator.id("start")] == n );
+  REQUIRE( result.endings[simulator.id("never")] == 0 );
+  REQUIRE( result.endings[simulator.id("a")] / double(n) == Approx(1.0 / 7).margin(0.006) );
+  REQUIRE( result.endings[simulator.id("b")] / double(n) == Approx(2.0 / 7).margin(0.006) );
+  REQUIRE( result.endings[simulator.id("c")] / double(n) == Approx(3.0 / 7).margin(0.006) );
+  REQUIRE( result.endings[simulator.id("d")] / double(n) == Approx(1.0 / 7).margin(0.006) );
+
+  // The same seed and threads play the same way:
+  REQUIRE( simulator.run("start", 1000, options).endings == simulator.run("start", 1000, options).endings );
+  REQUIRE_THROWS_AS( simulator.run("nowhere", 1), std::out_of_range );
+}
+
+TEST_CASE("PlaythroughSimulator agrees with RouteStatistics on a story with a trap", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTrapStory();
+  PlaythroughSimulator simulator(g, "weight");
+  SimulationOptions options;
+  options.maxSteps = 64;
+  const uint64_t n = 100000;
+  SimulationResult result = simulator.run("start", n, options);
+
+  CsrGraph csr = CsrGraph::fromGraph(g);
+  RouteStatistics stats(csr);
+  double probability = stats.outcomes(csr.id("start"))[0].probability;
+
+  REQUIRE( result.endings[simulator.id("end")] / double(n) == Approx(probability).margin(0.006) );
+  REQUIRE( result.unfinished == n - result.endings[simulator.id("end")] );
+  // Every reader passes the crossroads twice on average (once, plus a geometric number of loops):
+  REQUIRE( result.visits[simulator.id("cross")] / double(n) == Approx(2).margin(0.03) );
+}
+
+TEST_CASE("PlaythroughSimulator gives up where every choice weighs 0", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "locked", "end" }) { g.insertVertex(key); }
+  g.insertEdge("start", "locked");
+  g.insertEdge("locked", "end")["weight"] = "not a number";
+
+  PlaythroughSimulator simulator(g);
+  SimulationResult result = simulator.run("start", 100);
+  REQUIRE( result.unfinished == 100 );
+  REQUIRE( result.visits[simulator.id("locked")] == 100 );
+  REQUIRE( result.endings[simulator.id("end")] == 0 );
+}
@@ -0,0 +1,139 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../QueryServer.h"
+#include "StoryFixture.hpp"
+
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+
+static Graph<Vertex, DirectedEdge> createQueryGraph() {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "a", "b", "c", "d", "end", "island" }) { g.insertVertex(key); }
+  g.insertEdge("start", "a");
+  g.insertEdge("start", "b");
+  g.insertEdge("a", "c");
+  g.insertEdge("b", "c");
+  g.insertEdge("c", "d");
+  g.insertEdge("d", "end");
+  g.insertEdge("end", "start");
+  return g;
+}
+
+// Runs a QueryServer on a fresh socket, in a temporary directory that is
+// deleted with the socket, for the lifetime of the fixture.  Without
+// `running`, clients can connect and send before `start()` serves them:
+class ServerFixture {
+  public:
+    ServerFixture(const Graph<Vertex, DirectedEdge> & g, bool running = true) : dir({}), server(g, 2) {
+      path = dir.path() + "stories.sock";
+      REQUIRE( server.listen(path) );
+      if (running) { start(); }
+    }
+
+    ~ServerFixture() {
+      server.stop();
+      if (thread.joinable()) { thread.join(); }
+    }
+
+    void start() { thread = std::thread([this]() { server.run(); }); }
+
+    StoryDir dir;
+    QueryServer server;
+    std::string path;
+    std::thread thread;
+};
+
+TEST_CASE("QueryServer answers like the Graph it serves", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createQueryGraph();
+  ServerFixture fixture(g);
+  QueryClient client;
+  REQUIRE( client.connect(fixture.path) );
+
+  REQUIRE( client.shortestPath("start", "end") == g.shortestPath("start", "end") );
+  REQUIRE( client.shortestPath("d", "b") == g.shortestPath("d", "b") );
+  REQUIRE( client.shortestPath("start", "island") == g.shortestPath("start", "island") );
+  REQUIRE( client.degree("c") == 3 );
+  REQUIRE( client.isAdjacent("c", "d") );
+  REQUIRE_FALSE( client.isAdjacent("start", "end") );
+  REQUIRE( client.incidentEdges("a").size() == 2 );
+  REQUIRE_THROWS_AS( client.degree("nowhere"), std::out_of_range );
+  REQUIRE_THROWS_AS( client.shortestPath("start", "nowhere"), std::out_of_range );
+}
+
+TEST_CASE("QueryServer answers pipelined shortestPath requests from one traversal", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createQueryGraph();
+  ServerFixture fixture(g, false);
+  QueryClient client;
+  REQUIRE( client.connect(fixture.path) );
+
+  // Every request is waiting before the server starts, so they arrive in one batch:
+  std::vector<std::string> ends{ "a", "b", "c", "d", "end" };
+  std::vector<uint32_t> ids;
+  for (int round = 0; round < 4; round++) {
+    for (const std::string & end : ends) { ids.push_back(client.send(QueryProtocol::SHORTEST_PATH, "start", end)); }
+  }
+  fixture.start();
+
+  for (size_t i = 0; i < ids.size(); i++) {
+    QueryProtocol::Response response = client.receive();
+    REQUIRE( response.status == QueryProtocol::OK );
+    REQUIRE( response.id >= ids.front() );
+    REQUIRE( response.id <= ids.back() );
+    const std::string & end = ends[(response.id - ids.front()) % ends.size()];
+    std::list<std::string> path(response.keys.begin(), response.keys.end());
+    REQUIRE( path == g.shortestPath("start", end) );
+  }
+
+  QueryServer::Stats stats = fixture.server.stats();
+  REQUIRE( stats.queries == ids.size() );
+  REQUIRE( stats.traversals < stats.queries );
+}
+
+TEST_CASE("QueryServer serves concurrent clients", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createQueryGraph();
+  std::list<std::string> expected = g.shortestPath("b", "start");
+  ServerFixture fixture(g);
+
+  std::vector<std::thread> clients;
+  std::vector<int> correct(4, 0);
+  for (int t = 0; t < 4; t++) {
+    clients.push_back(std::thread([&, t]() {
+      QueryClient client;
+      if (!client.connect(fixture.path)) { return; }
+      for (int i = 0; i < 25; i++) {
+        if (client.shortestPath("b", "start") == expected && client.degree("start") == 3) { correct[t]++; }
+      }
+    }));
+  }
+  for (std::thread & client : clients) { client.join(); }
+
+  for (int count : correct) { REQUIRE( count == 25 ); }
+}
+
+TEST_CASE("QueryServer answers requests sent before the client stops sending", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createQueryGraph();
+  ServerFixture fixture(g);
+  QueryClient client;
+  REQUIRE( client.connect(fixture.path) );
+
+  std::vector<std::string> ends{ "a", "b", "c", "d", "end" };
+  for (const std::string & end : ends) { client.send(QueryProtocol::SHORTEST_PATH, "start", end); }
+  client.send(QueryProtocol::DEGREE, "c");
+  client.closeWrite();
+
+  for (size_t i = 0; i < ends.size() + 1; i++) {
+    QueryProtocol::Response response = client.receive();
+    REQUIRE( response.status == QueryProtocol::OK );
+    if (response.id > ends.size()) {
+      REQUIRE( response.value == 3 );
+    } else {
+      std::list<std::string> path(response.keys.begin(), response.keys.end());
+      REQUIRE( path == g.shortestPath("start", ends[response.id - 1]) );
+    }
+  }
+
+  // Then the server closes the connection:
+  REQUIRE_THROWS_AS( client.receive(), std::runtime_error );
+}
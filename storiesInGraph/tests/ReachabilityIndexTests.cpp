@@ -0,0 +1,97 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../ReachabilityIndex.h"
+#include "../DirectedEdge.h"
+#include "StoryFixture.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Every vertex reachable from `from`, by a plain search of `g`:
+static std::vector<bool> search(const CsrGraph & g, uint32_t from) {
+  std::vector<bool> seen(g.numVertices(), false);
+  std::vector<uint32_t> stack{ from };
+  seen[from] = true;
+  while (!stack.empty()) {
+    uint32_t v = stack.back();
+    stack.pop_back();
+    for (uint32_t w : g.neighbors(v)) {
+      if (!seen[w]) { seen[w] = true; stack.push_back(w); }
+    }
+  }
+  return seen;
+}
+
+TEST_CASE("ReachabilityIndex finds the choices that can still reach an ending", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTrapStory();
+  CsrGraph csr = CsrGraph::fromGraph(g);
+
+  for (size_t maxBytes : { ReachabilityIndex::DEFAULT_MAX_BYTES, size_t(0) }) {
+    ReachabilityIndex index(csr, maxBytes);
+    REQUIRE( index.indexed() == (maxBytes != 0) );
+
+    for (std::string key : { "start", "cross", "left", "right", "end" }) { REQUIRE( index.reachesEnding(csr.id(key)) ); }
+    REQUIRE_FALSE( index.reachesEnding(csr.id("trap1")) );
+    REQUIRE_FALSE( index.reachesEnding(csr.id("trap2")) );
+
+    REQUIRE( index.reachable(csr.id("start"), csr.id("trap2")) );
+    REQUIRE( index.reachable(csr.id("left"), csr.id("cross")) );
+    REQUIRE( index.reachable(csr.id("end"), csr.id("end")) );
+    REQUIRE_FALSE( index.reachable(csr.id("trap1"), csr.id("end")) );
+    REQUIRE_FALSE( index.reachable(csr.id("end"), csr.id("start")) );
+    REQUIRE_FALSE( index.reachable(csr.id("end"), csr.id("trap1")) );
+  }
+}
+
+TEST_CASE("ReachabilityIndex agrees with a search of a random graph", "[weight=1]") {
+  const uint32_t n = 300;
+  std::mt19937 random(42);
+  std::uniform_int_distribution<uint32_t> vertex(0, n - 1);
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (int i = 0; i < 400; i++) { edges.push_back({ vertex(random), vertex(random) }); }
+  CsrGraph g = CsrGraph::fromEdges(n, edges);
+
+  ReachabilityIndex indexed(g), searched(g, 0);
+  REQUIRE( indexed.indexed() );
+  REQUIRE_FALSE( searched.indexed() );
+
+  size_t mismatches = 0;
+  for (uint32_t v = 0; v < n; v++) {
+    std::vector<bool> seen = search(g, v);
+    bool ending = false;
+    for (uint32_t w = 0; w < n; w++) {
+      if (seen[w] && g.degree(w) == 0) { ending = true; }
+      if (indexed.reachable(v, w) != seen[w] || searched.reachable(v, w) != seen[w]) { mismatches++; }
+    }
+    if (indexed.reachesEnding(v) != ending) { mismatches++; }
+  }
+  REQUIRE( mismatches == 0 );
+}
+
+TEST_CASE("ReachabilityIndex answers a chain too long for bitsets from its labels", "[weight=1]") {
+  const uint32_t n = 100000, side = n;
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t v = 0; v + 1 < n; v++) { edges.push_back({ v, v + 1 }); }
+  // A dead end off the middle of the chain:
+  edges.push_back({ n / 2, side });
+  CsrGraph g = CsrGraph::fromEdges(n + 1, edges);
+
+  ReachabilityIndex index(g);
+  REQUIRE_FALSE( index.indexed() );
+  REQUIRE( index.reachable(0, n - 1) );
+  REQUIRE( index.reachable(0, side) );
+  REQUIRE( index.reachable(n / 2, side) );
+  REQUIRE_FALSE( index.reachable(n / 2 + 1, side) );
+  REQUIRE_FALSE( index.reachable(side, n - 1) );
+  REQUIRE_FALSE( index.reachable(n - 1, 0) );
+
+  std::mt19937 random(7);
+  std::uniform_int_distribution<uint32_t> vertex(0, n - 1);
+  size_t mismatches = 0;
+  for (int i = 0; i < 100000; i++) {
+    uint32_t from = vertex(random), to = vertex(random);
+    if (index.reachable(from, to) != (from <= to)) { mismatches++; }
+  }
+  REQUIRE( mismatches == 0 );
+}
@@ -0,0 +1,180 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../RouteStatistics.h"
+#include "../DirectedEdge.h"
+#include "StoryFixture.hpp"
+
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Two ways to the crossroads, where the story ends badly or goes on to the inn:
+static Graph<Vertex, DirectedEdge> createBranchingStory() {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "forest", "river", "cross", "bad", "inn", "detour", "end" }) { g.insertVertex(key); }
+  g.insertEdge("start", "forest");
+  g.insertEdge("start", "river");
+  g.insertEdge("forest", "cross");
+  g.insertEdge("river", "cross");
+  g.insertEdge("cross", "bad");
+  g.insertEdge("cross", "inn");
+  g.insertEdge("inn", "end");
+  g.insertEdge("inn", "detour");
+  g.insertEdge("detour", "end");
+  return g;
+}
+
+TEST_CASE("RouteStatistics counts and measures the routes of a branching story", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createBranchingStory();
+  CsrGraph csr = CsrGraph::fromGraph(g);
+  RouteStatistics stats(csr);
+  uint32_t start = csr.id("start");
+
+  REQUIRE( stats.routes(start) == 6 );
+  REQUIRE( stats.routes(csr.id("end")) == 1 );
+  REQUIRE( stats.minLength(start) == 3 );
+  REQUIRE( stats.maxLength(start) == 5 );
+  REQUIRE( stats.endingProbability(start) == Approx(1) );
+  REQUIRE( stats.expectedLength(start) == Approx(3.75) );
+
+  std::vector<RouteStatistics::Outcome> outcomes = stats.outcomes(start);
+  REQUIRE( outcomes.size() == 2 );
+  for (const RouteStatistics::Outcome & outcome : outcomes) {
+    REQUIRE( outcome.probability == Approx(0.5) );
+    REQUIRE( outcome.routes == (csr.key(outcome.ending) == "end" ? 4 : 2) );
+  }
+  REQUIRE( stats.outcomes(csr.id("inn")).size() == 1 );
+}
+
+TEST_CASE("RouteStatistics handles loops and traps", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTrapStory();
+  CsrGraph csr = CsrGraph::fromGraph(g);
+  RouteStatistics stats(csr);
+  uint32_t start = csr.id("start");
+
+  REQUIRE( stats.routes(start) == RouteStatistics::INFINITE );
+  REQUIRE( stats.maxLength(start) == RouteStatistics::UNBOUNDED );
+  REQUIRE( stats.minLength(start) == 3 );
+  REQUIRE( stats.endingProbability(csr.id("cross")) == Approx(0.5) );
+  // One loop round the crossroads on average, there and back:
+  REQUIRE( stats.expectedLength(csr.id("cross")) == Approx(4) );
+  REQUIRE( stats.expectedLength(start) == Approx(5) );
+
+  REQUIRE( stats.routes(csr.id("trap1")) == 0 );
+  REQUIRE( stats.minLength(csr.id("trap1")) == RouteStatistics::NONE );
+  REQUIRE( stats.maxLength(csr.id("trap1")) == RouteStatistics::NONE );
+  REQUIRE( stats.endingProbability(csr.id("trap1")) == 0 );
+  REQUIRE( std::isinf(stats.expectedLength(csr.id("trap1"))) );
+
+  std::vector<RouteStatistics::Outcome> outcomes = stats.outcomes(start);
+  REQUIRE( outcomes.size() == 1 );
+  REQUIRE( csr.key(outcomes[0].ending) == "end" );
+  REQUIRE( outcomes[0].routes == RouteStatistics::INFINITE );
+  REQUIRE( outcomes[0].probability == Approx(0.5) );
+  REQUIRE( stats.outcomes(csr.id("trap2")).empty() );
+}
+
+TEST_CASE("RouteStatistics solves a loop with a rare way out exactly", "[weight=1]") {
+  // 0 -> 1 <-> 2, where 2 leads back to 1 along K parallel edges, and once each to
+  // the end (3) and a trap (4 <-> 5); iteration would need more than MAX_SWEEPS sweeps:
+  const uint32_t K = 20000;
+  std::vector<std::pair<uint32_t, uint32_t>> edges{ { 0, 1 }, { 1, 2 }, { 2, 3 }, { 2, 4 }, { 4, 5 }, { 5, 4 } };
+  for (uint32_t i = 0; i < K; i++) { edges.push_back({ 2, 1 }); }
+  RouteStatistics stats(CsrGraph::fromEdges(6, edges));
+
+  REQUIRE( stats.converged() );
+  REQUIRE( stats.endingProbability(1) == Approx(0.5) );
+  REQUIRE( stats.endingProbability(2) == Approx(0.5) );
+  REQUIRE( stats.expectedLength(1) == Approx(K + 2) );
+  REQUIRE( stats.expectedLength(0) == Approx(K + 3) );
+
+  std::vector<RouteStatistics::Outcome> outcomes = stats.outcomes(0);
+  REQUIRE( outcomes.size() == 1 );
+  REQUIRE( outcomes[0].ending == 3 );
+  REQUIRE( outcomes[0].probability == Approx(0.5) );
+  REQUIRE( outcomes[0].converged );
+}
+
+TEST_CASE("RouteStatistics iterates on a loop larger than DIRECT_LIMIT", "[weight=1]") {
+  // A ring where every vertex also leads to the end (0):
+  const uint32_t n = 2 * RouteStatistics::DIRECT_LIMIT;
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t v = 1; v < n; v++) {
+    edges.push_back({ v, v + 1 < n ? v + 1 : 1 });
+    edges.push_back({ v, 0 });
+  }
+  RouteStatistics stats(CsrGraph::fromEdges(n, edges));
+
+  REQUIRE( stats.converged() );
+  REQUIRE( stats.endingProbability(1) == Approx(1) );
+  REQUIRE( stats.expectedLength(1) == Approx(2) );
+  std::vector<RouteStatistics::Outcome> outcomes = stats.outcomes(1);
+  REQUIRE( outcomes.size() == 1 );
+  REQUIRE( outcomes[0].probability == Approx(1) );
+  REQUIRE( outcomes[0].converged );
+}
+
+TEST_CASE("RouteStatistics counts past 64 bits and saturates instead of overflowing", "[weight=1]") {
+  // A chain of `n` diamonds has 2^n routes:
+  auto diamonds = [](uint32_t n) {
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < n; i++) {
+      edges.push_back({ 3 * i, 3 * i + 1 });
+      edges.push_back({ 3 * i, 3 * i + 2 });
+      edges.push_back({ 3 * i + 1, 3 * i + 3 });
+      edges.push_back({ 3 * i + 2, 3 * i + 3 });
+    }
+    return CsrGraph::fromEdges(3 * n + 1, edges);
+  };
+
+  RouteStatistics wide(diamonds(100));
+  REQUIRE( RouteStatistics::toString(wide.routes(0)) == "1267650600228229401496703205376" );
+  REQUIRE( wide.maxLength(0) == 200 );
+  REQUIRE( wide.outcomes(0)[0].probability == Approx(1) );
+
+  RouteStatistics saturated(diamonds(200));
+  REQUIRE( saturated.routes(0) == RouteStatistics::INFINITE );
+  REQUIRE( RouteStatistics::toString(saturated.routes(0)) == "infinite" );
+}
+
+TEST_CASE("RouteStatistics agrees with enumerating the routes of a random DAG", "[weight=1]") {
+  const uint32_t n = 16;
+  std::mt19937 random(3);
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t v = 0; v < n; v++) {
+    for (uint32_t w = v + 1; w < n; w++) {
+      if (random() % 3 == 0) { edges.push_back({ v, w }); }
+    }
+  }
+  CsrGraph g = CsrGraph::fromEdges(n, edges);
+  RouteStatistics stats(g);
+
+  // Every route from `v` to an ending, with the probability of taking it:
+  size_t mismatches = 0;
+  for (uint32_t v = 0; v < n; v++) {
+    uint64_t routes = 0;
+    uint32_t minLength = RouteStatistics::NONE, maxLength = 0;
+    double lengthSum = 0;
+    std::vector<double> probability(n, 0);
+    std::function<void(uint32_t, uint32_t, double)> walk = [&](uint32_t u, uint32_t length, double p) {
+      if (g.degree(u) == 0) {
+        routes++;
+        minLength = std::min(minLength, length);
+        maxLength = std::max(maxLength, length);
+        lengthSum += p * length;
+        probability[u] += p;
+      }
+      for (uint32_t w : g.neighbors(u)) { walk(w, length + 1, p / g.degree(u)); }
+    };
+    walk(v, 0, 1);
+
+    if (stats.routes(v) != routes || stats.minLength(v) != minLength || stats.maxLength(v) != maxLength) { mismatches++; }
+    if (std::abs(stats.expectedLength(v) - lengthSum) > 1e-9) { mismatches++; }
+    for (const RouteStatistics::Outcome & outcome : stats.outcomes(v)) {
+      if (std::abs(outcome.probability - probability[outcome.ending]) > 1e-9) { mismatches++; }
+    }
+  }
+  REQUIRE( mismatches == 0 );
+}
@@ -0,0 +1,46 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../benchmarks/StoryCorpus.h"
+#include "../CYOA.h"
+#include "StoryFixture.hpp"
+
+#include <stdexcept>
+#include <string>
+
+// Checks the shape of a generated story against the options it was made with:
+static void requireShape(const StoryCorpusOptions & options) {
+  StoryDir dir({});
+  StoryCorpusInfo info = writeStoryCorpus(dir, options);
+  double endingRatio = (double) info.endings / info.nodes;
+  double branching = (double) info.edges / (info.nodes - info.endings);
+
+  REQUIRE( info.nodes == options.nodes );
+  REQUIRE( endingRatio == Approx(options.endingRatio).margin(0.02) );
+  REQUIRE( branching == Approx(options.branching).epsilon(0.05) );
+
+  // Every choice leads to a passage, and only passage-0 is a beginning:
+  CYOA cyoa;
+  Graph<Vertex, DirectedEdge> g = cyoa.load(dir);
+  REQUIRE( g.numVertices() == info.nodes );
+  REQUIRE( g.numEdges() == info.edges );
+  REQUIRE( cyoa.validation().count(StoryValidation::DANGLING_CHOICE) == 0 );
+  REQUIRE( cyoa.validation().count(StoryValidation::START_COUNT) == 0 );
+}
+
+TEST_CASE("writeStoryCorpus follows the ending ratio and branching it is given", "[weight=1]") {
+  StoryCorpusOptions options;
+  options.nodes = 5000;
+  options.wordsMean = 5;
+  requireShape(options);
+
+  options.branching = 2;
+  options.endingRatio = 0.3;
+  options.threads = 4;
+  requireShape(options);
+}
+
+TEST_CASE("writeStoryCorpus throws if the story cannot be written", "[weight=1]") {
+  StoryCorpusOptions options;
+  options.nodes = 10;
+  REQUIRE_THROWS_AS( writeStoryCorpus("/nonexistent/cyoa-corpus/", options), std::runtime_error );
+}
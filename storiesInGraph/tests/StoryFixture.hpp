@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../cs225/catch/catch.hpp"
+
+#include "../CsrGraph.h"
+#include "../DirectedEdge.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <dirent.h>
+#include <unistd.h>
+
+// A story written as `<name>.md` files (name -> contents) into a fresh
+// temporary directory, which is deleted with everything in it when this
+// goes out of scope.  Converts to the directory path, with a trailing `/`:
+class StoryDir {
+  public:
+    explicit StoryDir(const std::vector<std::pair<std::string, std::string>> & files) {
+      char dirTemplate[] = "/tmp/cyoa-story-XXXXXX";
+      REQUIRE( mkdtemp(dirTemplate) != nullptr );
+      path_ = std::string(dirTemplate) + "/";
+      for (auto & file : files) {
+        std::ofstream out(path_ + file.first + ".md");
+        out << file.second;
+      }
+    }
+
+    ~StoryDir() {
+      DIR * dir = opendir(path_.c_str());
+      if (dir != nullptr) {
+        struct dirent * ent;
+        while ((ent = readdir(dir)) != nullptr) {
+          std::string name = ent->d_name;
+          if (name != "." && name != "..") { std::remove((path_ + name).c_str()); }
+        }
+        closedir(dir);
+      }
+      rmdir(path_.c_str());
+    }
+
+    StoryDir(const StoryDir &) = delete;
+    StoryDir & operator=(const StoryDir &) = delete;
+
+    const std::string & path() const { return path_; }
+    operator const std::string &() const { return path_; }
+
+  private:
+    std::string path_;
+};
+
+inline StoryDir writeStory(const std::vector<std::pair<std::string, std::string>> & files) {
+  return StoryDir(files);
+}
+
+// A valid story: 8 narratives, 14 choices, one start, an ending and a 3-choice node.
+inline std::vector<std::pair<std::string, std::string>> validStory() {
+  return {
+    { "start", "Start.\n# a\nA\n# b\nB\n# c\nC\n" },
+    { "a", "A.\n# b\nB\n# d\nD\n" },
+    { "b", "B.\n# c\nC\n# d\nD\n" },
+    { "c", "C.\n# d\nD\n# e\nE\n" },
+    { "d", "D.\n# e\nE\n# f\nF\n" },
+    { "e", "E.\n# f\nF\n# g\nG\n" },
+    { "f", "F.\n# g\nG\n" },
+    { "g", "The end.\n" },
+  };
+}
+
+// A story with a loop back to the crossroads, and a trap that never ends:
+inline Graph<Vertex, DirectedEdge> createTrapStory() {
+  Graph<Vertex, DirectedEdge> g;
+  for (std::string key : { "start", "cross", "left", "right", "end", "trap1", "trap2" }) { g.insertVertex(key); }
+  g.insertEdge("start", "cross");
+  g.insertEdge("cross", "left");
+  g.insertEdge("left", "cross");
+  g.insertEdge("cross", "right");
+  g.insertEdge("right", "end");
+  g.insertEdge("right", "trap1");
+  g.insertEdge("trap1", "trap2");
+  g.insertEdge("trap2", "trap1");
+  return g;
+}
+
+// `m` random edges among `n` vertices (with self-loops and repeats), leaving
+// every `sinkEvery`th vertex with no edges out, if it is not 0:
+inline CsrGraph randomGraph(uint32_t n, size_t m, uint64_t seed, uint32_t sinkEvery = 0) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<uint32_t> vertex(0, n - 1);
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  while (edges.size() < m) {
+    uint32_t v = vertex(rng);
+    if (sinkEvery != 0 && v % sinkEvery == 0) { continue; }
+    edges.push_back({ v, vertex(rng) });
+  }
+  return CsrGraph::fromEdges(n, edges);
+}
@@ -0,0 +1,108 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../CYOA.h"
+#include "../StoryValidation.h"
+#include "StoryFixture.hpp"
+
+#include <string>
+
+TEST_CASE("CYOA::load reports no diagnostics for a valid story", "[weight=1]") {
+  CYOA cyoa;
+  Graph<Vertex, DirectedEdge> g = cyoa.load(writeStory(validStory()));
+
+  REQUIRE( g.numVertices() == 8 );
+  REQUIRE( g.numEdges() == 14 );
+  REQUIRE( cyoa.validation().result() == StoryValidation::PASS );
+  REQUIRE( cyoa.validation().diagnostics().size() == 0 );
+}
+
+TEST_CASE("CYOA::load reports dangling choices and skips their edges", "[weight=1]") {
+  auto files = validStory();
+  files[6].second = "F.\n# g\nG\n# nowhere\nGone\n";
+
+  CYOA cyoa;
+  Graph<Vertex, DirectedEdge> g = cyoa.load(writeStory(files));
+
+  REQUIRE( g.numEdges() == 14 );
+  REQUIRE( cyoa.validation().count(StoryValidation::DANGLING_CHOICE) == 1 );
+  REQUIRE( cyoa.validation().diagnostics().front().file == "f" );
+  REQUIRE( cyoa.validation().passed() == false );
+}
+
+TEST_CASE("CYOA::load warns about # lines without a space", "[weight=1]") {
+  auto files = validStory();
+  files[6].second = "F.\n\n#g\nG\n";
+
+  CYOA cyoa;
+  cyoa.load(writeStory(files));
+
+  REQUIRE( cyoa.validation().result() == StoryValidation::WARN );
+  REQUIRE( cyoa.validation().count(StoryValidation::MALFORMED_CHOICE) == 1 );
+  REQUIRE( cyoa.validation().diagnostics().front().line == 3 );
+}
+
+TEST_CASE("CYOA::load reports whole-story rules", "[weight=1]") {
+  std::vector<std::pair<std::string, std::string>> files = {
+    { "a", "# b\nB\n" },
+    { "b", "B.\n# a\nA\n" },
+  };
+
+  CYOA cyoa;
+  cyoa.load(writeStory(files));
+  const StoryValidation & v = cyoa.validation();
+
+  REQUIRE( v.count(StoryValidation::EMPTY_FILE) == 1 );
+  REQUIRE( v.count(StoryValidation::NO_ENDING) == 1 );
+  REQUIRE( v.count(StoryValidation::NO_THREE_CHOICES) == 1 );
+  REQUIRE( v.count(StoryValidation::START_COUNT) == 1 );
+  REQUIRE( v.count(StoryValidation::TOO_FEW_NARRATIVES) == 1 );
+  REQUIRE( v.count(StoryValidation::TOO_FEW_CHOICES) == 1 );
+}
+
+TEST_CASE("CYOA::load gives the same result when parsing in parallel", "[weight=1]") {
+  auto files = validStory();
+  files[6].second = "F.\n#g\nG\n# nowhere\nGone\n";
+  StoryDir dir = writeStory(files);
+
+  CYOA serial;
+  CYOA parallel(4);
+  Graph<Vertex, DirectedEdge> g1 = serial.load(dir);
+  Graph<Vertex, DirectedEdge> g2 = parallel.load(dir);
+
+  REQUIRE( g1.numVertices() == g2.numVertices() );
+  REQUIRE( g1.numEdges() == g2.numEdges() );
+  REQUIRE( serial.validation().diagnostics().size() == parallel.validation().diagnostics().size() );
+  REQUIRE( parallel.validation().count(StoryValidation::MALFORMED_CHOICE) == 1 );
+  REQUIRE( parallel.validation().count(StoryValidation::DANGLING_CHOICE) == 1 );
+}
+
+TEST_CASE("CYOA::load counts choices the way story_validator.py does", "[weight=1]") {
+  auto files = validStory();
+  // A repeated choice counts twice, but is one edge:
+  files[0].second = "Start.\n# a\nA\n# b\nB\n# c\nC\n# a\nA again\n";
+  // `#x` is only a warning, not a choice, so g is still an ending:
+  files[7].second = "\nThe end.\n#x\n";
+
+  CYOA cyoa;
+  Graph<Vertex, DirectedEdge> g = cyoa.load(writeStory(files));
+  const StoryValidation & v = cyoa.validation();
+
+  REQUIRE( g.numEdges() == 14 );
+  REQUIRE( v.count(StoryValidation::MALFORMED_CHOICE) == 1 );
+  REQUIRE( v.count(StoryValidation::DANGLING_CHOICE) == 0 );
+  REQUIRE( v.count(StoryValidation::NO_ENDING) == 0 );
+  // A blank first line is a (blank) narrative:
+  REQUIRE( v.count(StoryValidation::EMPTY_FILE) == 0 );
+  REQUIRE( v.result() == StoryValidation::WARN );
+}
+
+TEST_CASE("CYOA::load reports a file whose first line is a choice as empty", "[weight=1]") {
+  auto files = validStory();
+  files[6].second = "# g\nG\n";
+
+  CYOA cyoa;
+  cyoa.load(writeStory(files));
+
+  REQUIRE( cyoa.validation().count(StoryValidation::EMPTY_FILE) == 1 );
+  REQUIRE( cyoa.validation().diagnostics().front().file == "f" );
+}
@@ -0,0 +1,72 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../CsrGraph.h"
+#include "../StronglyConnectedComponents.h"
+#include "../DirectedEdge.h"
+#include "StoryFixture.hpp"
+
+#include <string>
+#include <vector>
+
+Graph<Vertex, Edge> createTestGraph();
+
+TEST_CASE("CsrGraph::fromGraph keeps the keys and edges of the Graph", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTrapStory();
+  CsrGraph csr = CsrGraph::fromGraph(g);
+
+  REQUIRE( csr.numVertices() == 7 );
+  REQUIRE( csr.numEdges() == 8 );
+  REQUIRE( csr.key(csr.id("cross")) == "cross" );
+  REQUIRE( csr.degree(csr.id("cross")) == 2 );
+  REQUIRE( csr.degree(csr.id("end")) == 0 );
+  REQUIRE( csr.transpose().degree(csr.id("cross")) == 2 );
+  REQUIRE( *csr.transpose().neighbors(csr.id("end")).begin() == csr.id("right") );
+  REQUIRE_THROWS_AS( csr.id("nowhere"), std::out_of_range );
+
+  // An undirected Edge can be walked both ways:
+  REQUIRE( CsrGraph::fromGraph(createTestGraph()).numEdges() == 2 * createTestGraph().numEdges() );
+}
+
+TEST_CASE("StronglyConnectedComponents finds loops and traps in a story", "[weight=1]") {
+  Graph<Vertex, DirectedEdge> g = createTrapStory();
+  CsrGraph csr = CsrGraph::fromGraph(g);
+  StronglyConnectedComponents scc(csr);
+
+  REQUIRE( scc.count() == 5 );
+  REQUIRE( scc.component(csr.id("cross")) == scc.component(csr.id("left")) );
+  REQUIRE( scc.component(csr.id("trap1")) == scc.component(csr.id("trap2")) );
+  REQUIRE( scc.component(csr.id("start")) != scc.component(csr.id("cross")) );
+  REQUIRE( scc.size(scc.component(csr.id("cross"))) == 2 );
+
+  // The trap is a loop with no way out:
+  uint32_t trap = scc.component(csr.id("trap1"));
+  REQUIRE( scc.condensation().degree(trap) == 0 );
+  REQUIRE( scc.size(trap) == 2 );
+
+  // Components are in topological order, and the condensation has no self-loops:
+  for (uint32_t v = 0; v < csr.numVertices(); v++) {
+    for (uint32_t w : csr.neighbors(v)) { REQUIRE( scc.component(v) <= scc.component(w) ); }
+  }
+  for (uint32_t c = 0; c < scc.count(); c++) {
+    for (uint32_t d : scc.condensation().neighbors(c)) { REQUIRE( c < d ); }
+  }
+  REQUIRE( scc.condensation().numEdges() == 4 );
+  REQUIRE( scc.component(csr.id("start")) == 0 );
+}
+
+TEST_CASE("StronglyConnectedComponents handles a million-vertex chain and cycle", "[weight=1]") {
+  const uint32_t n = 1000000;
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t v = 0; v + 1 < n; v++) { edges.push_back({ v, v + 1 }); }
+
+  StronglyConnectedComponents chain(CsrGraph::fromEdges(n, edges));
+  REQUIRE( chain.count() == n );
+  REQUIRE( chain.component(0) == 0 );
+  REQUIRE( chain.component(n - 1) == n - 1 );
+
+  edges.push_back({ n - 1, 0 });
+  StronglyConnectedComponents cycle(CsrGraph::fromEdges(n, edges));
+  REQUIRE( cycle.count() == 1 );
+  REQUIRE( cycle.size(0) == n );
+  REQUIRE( cycle.condensation().numEdges() == 0 );
+}
@@ -0,0 +1,115 @@
+#include "../cs225/catch/catch.hpp"
+
+#include "../Trace.h"
+#include "../CYOA.h"
+#include "StoryFixture.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <atomic>
+
+static size_t countOf(const std::string & haystack, const std::string & needle) {
+  size_t count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) { count++; }
+  return count;
+}
+
+TEST_CASE("Trace records nothing until enabled", "[weight=1]") {
+  Trace::enable(false);
+  Trace::clear();
+  { TRACE_SPAN("untraced", "test"); }
+  REQUIRE( Trace::size() == 0 );
+}
+
+TEST_CASE("Trace writes spans from every thread as Chrome trace events", "[weight=1]") {
+  Trace::clear();
+  Trace::enable();
+  { TRACE_SPAN("outer", "test"); { TRACE_SPAN("inner", "test"); } }
+  std::thread worker([]() { TRACE_SPAN("worker", "test"); });
+  worker.join();
+  Trace::enable(false);
+
+  std::stringstream out;
+  Trace::write(out);
+  std::string json = out.str();
+
+  REQUIRE( Trace::size() == 3 );
+  REQUIRE( json.find("\"traceEvents\":[") != std::string::npos );
+  REQUIRE( countOf(json, "\"ph\":\"X\"") == 3 );
+  REQUIRE( json.find("\"name\":\"inner\"") != std::string::npos );
+  REQUIRE( json.find("\"name\":\"worker\"") != std::string::npos );
+  REQUIRE( json.find("\"name\":\"worker\",\"cat\":\"test\",\"ph\":\"X\"") != std::string::npos );
+}
+
+TEST_CASE("Trace keeps only the newest spans of a thread", "[weight=1]") {
+  Trace::clear();
+  Trace::enable();
+  std::thread worker([]() {
+    for (size_t i = 0; i < Trace::CAPACITY + 10; i++) { TRACE_SPAN("span", "test"); }
+  });
+  worker.join();
+  Trace::enable(false);
+
+  REQUIRE( Trace::size() == Trace::CAPACITY );
+  Trace::clear();
+  REQUIRE( Trace::size() == 0 );
+}
+
+TEST_CASE("Trace hands the buffers of finished threads to new threads", "[weight=1]") {
+  Trace::clear();
+  Trace::enable();
+  { std::thread first([]() { TRACE_SPAN("first", "test"); }); first.join(); }
+  size_t buffers = Trace::buffers();
+
+  for (int i = 0; i < 50; i++) {
+    std::thread worker([]() { TRACE_SPAN("worker", "test"); });
+    worker.join();
+  }
+  Trace::enable(false);
+
+  REQUIRE( Trace::buffers() == buffers );
+  // The spans of finished threads are kept:
+  REQUIRE( Trace::size() == 51 );
+  Trace::clear();
+}
+
+TEST_CASE("Trace writes while another thread records", "[weight=1]") {
+  Trace::clear();
+  Trace::enable();
+  std::atomic<bool> done(false);
+  std::thread worker([&done]() {
+    for (size_t i = 0; i < 3 * Trace::CAPACITY; i++) { TRACE_SPAN("span", "test"); }
+    done = true;
+  });
+
+  unsigned int writes = 0;
+  while (!done || writes == 0) {
+    std::stringstream out;
+    Trace::write(out);
+    std::string json = out.str();
+    REQUIRE( countOf(json, "\"ph\":\"X\"") <= Trace::CAPACITY );
+    REQUIRE( countOf(json, "\"ph\":\"X\"") == countOf(json, "\"name\":\"span\",\"cat\":\"test\"") );
+    writes++;
+  }
+  worker.join();
+  Trace::enable(false);
+  Trace::clear();
+}
+
+TEST_CASE("Trace covers the phases of CYOA::load", "[weight=1]") {
+  StoryDir dir = writeStory(validStory());
+  Trace::clear();
+  Trace::enable();
+  CYOA cyoa;
+  Graph<Vertex, DirectedEdge> g = cyoa.load(dir);
+  Trace::enable(false);
+
+  std::stringstream out;
+  Trace::write(out);
+  std::string json = out.str();
+  REQUIRE( countOf(json, "\"name\":\"CYOA::_processFile\"") == 8 );
+  REQUIRE( json.find("\"name\":\"CYOA::load scan\",\"cat\":\"io\"") != std::string::npos );
+  REQUIRE( json.find("\"name\":\"CYOA::load insertEdge\",\"cat\":\"graph\"") != std::string::npos );
+  Trace::clear();
+}